@@ -25,6 +25,7 @@
 #define CHUNKSIZE 128
 
 #include "list.h"
+#include <utility>
 
 /*!
  * \short Array
@@ -51,18 +52,42 @@ template <class A> class Array : public ListItem< Array<A> >
 	{
 		array_ = NULL;
 		size_ = 0;
-		resize(source.size_);
+		nItems_ = 0;
+		resize(source.nItems_);
 		nItems_ = source.nItems_;
 		for (int n=0; n<nItems_; ++n) array_[n] = source.array_[n];
 	}
+	// Move Constructor
+	Array(Array<A>&& source) : ListItem< Array<A> >()
+	{
+		array_ = source.array_;
+		size_ = source.size_;
+		nItems_ = source.nItems_;
+		source.array_ = NULL;
+		source.size_ = 0;
+		source.nItems_ = 0;
+	}
 	// Assignment Operator
 	void operator=(const Array<A>& source)
 	{
+		if (this == &source) return;
 		clear();
-		resize(source.size_);
+		resize(source.nItems_);
 		nItems_ = source.nItems_;
 		for (int n=0; n<nItems_; ++n) array_[n] = source.array_[n];
 	}
+	// Move Assignment Operator
+	void operator=(Array<A>&& source)
+	{
+		if (this == &source) return;
+		if (array_ != NULL) delete[] array_;
+		array_ = source.array_;
+		size_ = source.size_;
+		nItems_ = source.nItems_;
+		source.array_ = NULL;
+		source.size_ = 0;
+		source.nItems_ = 0;
+	}
 	// Conversion operator (to standard array)
 	operator A*()
 	{
@@ -89,26 +114,23 @@ template <class A> class Array : public ListItem< Array<A> >
 		// Array large enough already?
 		if ((newSize-size_) <= 0) return;
 
-		// Copy old data to temporary array
-		int oldSize = size_;
-		A* oldData = NULL;
-		if (oldSize > 0)
-		{
-			oldData = new A[oldSize];
-			for (int n=0; n<nItems_; ++n) oldData[n] = array_[n];
-		}
+		// Create new array and move existing items straight into it
+		A* newArray = new A[newSize];
+		for (int n=0; n<nItems_; ++n) newArray[n] = std::move(array_[n]);
 
-		// Delete old, and create new array
+		// Delete old array
 		if (array_ != NULL) delete[] array_;
+		array_ = newArray;
 		size_ = newSize;
-		array_ = new A[size_];
-
-		// Copy old data into new array
-		if (oldSize > 0)
-		{
-			for (int n=0; n<nItems_; ++n) array_[n] = oldData[n];
-			delete[] oldData;
-		}
+	}
+	// Grow array so that it can hold at least the specified number of items
+	void grow(int minSize)
+	{
+		// Double the current size (or use CHUNKSIZE for small arrays) so that repeated adds are amortised O(1)
+		int newSize = size_*2;
+		if (newSize < CHUNKSIZE) newSize = CHUNKSIZE;
+		if (newSize < minSize) newSize = minSize;
+		resize(newSize);
 	}
 
 	public:
@@ -117,6 +139,11 @@ template <class A> class Array : public ListItem< Array<A> >
 	{
 		return nItems_;
 	}
+	// Return current capacity of array
+	int capacity() const
+	{
+		return size_;
+	}
 	// Return data array
 	A* array()
 	{
@@ -139,14 +166,10 @@ template <class A> class Array : public ListItem< Array<A> >
 		// ...and finally set all elements to specified value
 		for (int n=0; n<nItems_; ++n) array_[n] = value;
 	}
-	// Reserve array of specified size (with no content)
+	// Reserve space for at least the specified number of items (existing items are retained)
 	void reserve(int size)
 	{
-		// First, resize array...
 		resize(size);
-		
-		// ... then set number of items to zero
-		nItems_ = 0;
 	}
 	///@}
 
@@ -157,14 +180,46 @@ template <class A> class Array : public ListItem< Array<A> >
 	///@{
 	public:
 	// Add new element to array
-	void add(A data)
+	void add(const A& data)
 	{
-		// Is current array large enough?
-		if (nItems_ == size_) resize(size_+CHUNKSIZE);
+		// Is current array large enough? If not, take a copy first in case data refers to one of our own items
+		if (nItems_ == size_)
+		{
+			A value(data);
+			grow(nItems_+1);
+			array_[nItems_++] = std::move(value);
+			return;
+		}
 
 		// Store new value
 		array_[nItems_++] = data;
 	}
+	// Add new element to array (moving it into place)
+	void add(A&& data)
+	{
+		// Is current array large enough?
+		if (nItems_ == size_)
+		{
+			A value(std::move(data));
+			grow(nItems_+1);
+			array_[nItems_++] = std::move(value);
+			return;
+		}
+
+		// Store new value
+		array_[nItems_++] = std::move(data);
+	}
+	// Append specified number of elements from a standard array (which must not be part of this Array)
+	void append(const A* data, int nData)
+	{
+		if ((data == NULL) || (nData <= 0)) return;
+
+		// Make sure there is enough room for all new items in one go
+		if ((nItems_+nData) > size_) grow(nItems_+nData);
+
+		// Copy new values
+		for (int n=0; n<nData; ++n) array_[nItems_++] = data[n];
+	}
 	// Return nth item in array
 	A& operator[](int n)
 	{
@@ -0,0 +1,69 @@
+/*
+	*** Benchmark Fixtures
+	*** src/bench/bench.h
+	Copyright T. Youngs 2012-2016
+
+	This file is part of JournalViewer.
+
+	JournalViewer is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	JournalViewer is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with JournalViewer.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef JOURNALVIEWER_BENCH_H
+#define JOURNALVIEWER_BENCH_H
+
+#include <chrono>
+#include <stdio.h>
+
+// Timing and reporting shared by the standalone benchmarks (no dependencies, so containers can be benchmarked without Qt)
+
+// Number of times a repeatable test is run by bestOf() (the fastest is reported)
+const int nRepeats = 3;
+
+// Time the supplied function once, returning the elapsed time (ms)
+template <class F> double timeIt(F f)
+{
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	f();
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Time the supplied function the specified number of times, returning the fastest time (ms)
+template <class F> double bestOf(F f, int repeats = nRepeats)
+{
+	double best = -1.0;
+	for (int n=0; n<repeats; ++n)
+	{
+		double ms = timeIt(f);
+		if ((best < 0.0) || (ms < best)) best = ms;
+	}
+	return best;
+}
+
+// Print column headings for result lines, naming the quantity counted by each test
+inline void printHeadings(const char* countName)
+{
+	printf("  %-40s  %9s  %10s  %10s  %8s  %14s\n", "Test", countName, "Time (ms)", "ns/op", "Speedup", "Checksum");
+}
+
+// Print result line, with the speedup over the baseline time (if one is given)
+// The checksum is a value derived from the test's results, so that the work can't be optimised away and different methods can be compared
+inline void printResult(const char* test, int nOperations, double ms, double checksum, double baseline = -1.0)
+{
+	printf("  %-40s  %9i  %10.2f  %10.1f  ", test, nOperations, ms, ms*1.0e6/nOperations);
+	if (baseline > 0.0) printf("%7.1fx", baseline/ms);
+	else printf("%8s", "");
+	printf("  %14.0f\n", checksum);
+}
+
+#endif
@@ -0,0 +1,77 @@
+/*
+	*** Array Benchmark
+	*** src/bench/bench_array.cpp
+	Copyright T. Youngs 2012-2016
+
+	This file is part of JournalViewer.
+
+	JournalViewer is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	JournalViewer is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with JournalViewer.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "bench.h"
+#include "array.h"
+#include <string>
+#include <vector>
+#include <stdlib.h>
+
+int main(int argc, char* argv[])
+{
+	// Largest number of points may be given on the command line
+	int maxItems = (argc > 1 ? atoi(argv[1]) : 1000000);
+
+	printf("Array Benchmark (up to %i points)\n\n", maxItems);
+	printHeadings("Points");
+
+	// Time / value log points, as extracted from a NeXus file
+	std::vector<double> times(maxItems), values(maxItems);
+	for (int n=0; n<maxItems; ++n)
+	{
+		times[n] = n*0.5;
+		values[n] = 300.0 + (n%1000)*0.01;
+	}
+
+	// Time per point should stay constant as the number of points grows
+	for (int nItems = (maxItems < 10000 ? maxItems : 10000); nItems <= maxItems; nItems *= 10)
+	{
+		double ms;
+
+		// Add points one at a time, as the log file parser does
+		Array<double> x, y;
+		ms = timeIt([&]() { for (int n=0; n<nItems; ++n) { x.add(times[n]); y.add(values[n]); } });
+		printResult("add()", nItems, ms, x[nItems-1] + y[nItems-1]);
+
+		// Add points after reserving space for them, as NeXus extraction does
+		Array<double> rx, ry;
+		ms = timeIt([&]() { rx.reserve(nItems); ry.reserve(nItems); for (int n=0; n<nItems; ++n) { rx.add(times[n]); ry.add(values[n]); } });
+		printResult("reserve() + add()", nItems, ms, rx[nItems-1] + ry[nItems-1]);
+
+		// Append all points at once
+		Array<double> bx, by;
+		ms = timeIt([&]() { bx.append(times.data(), nItems); by.append(values.data(), nItems); });
+		printResult("append()", nItems, ms, bx[nItems-1] + by[nItems-1]);
+
+		// Add items which are expensive to copy
+		if (nItems <= 100000)
+		{
+			Array<std::string> strings;
+			std::string s(64, 'x');
+			ms = timeIt([&]() { for (int n=0; n<nItems; ++n) strings.add(s); });
+			printResult("add() (64-character strings)", nItems, ms, strings[nItems-1].size());
+		}
+
+		printf("\n");
+	}
+
+	return 0;
+}
@@ -0,0 +1,200 @@
+/*
+	*** Run Catalogue Benchmark
+	*** src/bench/bench_catalogue.cpp
+	Copyright T. Youngs 2012-2016
+
+	This file is part of JournalViewer.
+
+	JournalViewer is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	JournalViewer is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with JournalViewer.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "bench.h"
+#include "rundata.h"
+#include "runcatalogue.h"
+#include "data2d.h"
+#include <QDateTime>
+#include <QVector>
+#include <stdlib.h>
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
+// Per-run storage as it was before the catalogue (one heap object per run, holding its own strings and date/times)
+class LegacyRunData : public ListItem<LegacyRunData>
+{
+	public:
+	void* instrument_;
+	void* journalSource_;
+	QString name_;
+	int runNumber_;
+	QString title_;
+	int rbNumber_;
+	QString user_;
+	double protonCharge_;
+	int duration_;
+	QString durationString_;
+	QDateTime startDateTime_;
+	QDateTime endDateTime_;
+	int cycle_;
+	double totalMEvents_;
+	int group_;
+	bool visible_;
+	List<Data2D> blockData_;
+};
+
+// Return resident set size of the process (bytes), or -1 if it is not available
+qint64 residentMemory()
+{
+#ifdef __linux__
+	FILE* statm = fopen("/proc/self/statm", "r");
+	if (statm == NULL) return -1;
+	long size, resident;
+	int nRead = fscanf(statm, "%li %li", &size, &resident);
+	fclose(statm);
+	return (nRead == 2 ? qint64(resident) * sysconf(_SC_PAGESIZE) : -1);
+#else
+	return -1;
+#endif
+}
+
+// Synthetic property values for run n
+QString runTitle(int n)
+{
+	return QString("Sample %1 in can at %2K").arg(n%1500).arg(100 + n%300);
+}
+QString runUser(int n)
+{
+	return QString("User %1").arg((n/120)%400);
+}
+QDateTime runStart(int n)
+{
+	return QDateTime(QDate(2010, 1, 1), QTime(0, 0), Qt::UTC).addSecs(qint64(n)*900);
+}
+
+// Print before and after results of a scan, flagging any difference in the number of matches
+void printScan(const char* scan, int nRuns, double before, int nBefore, double after, int nAfter)
+{
+	printResult(QString("%1 (before)").arg(scan).toLatin1().constData(), nRuns, before, nBefore);
+	printResult(QString("%1 (after)").arg(scan).toLatin1().constData(), nRuns, after, nAfter, before);
+	if (nBefore != nAfter) printf("  ** Mismatch in number of matches **\n");
+}
+
+int main(int argc, char* argv[])
+{
+	// Number of runs may be given on the command line
+	int nRuns = (argc > 1 ? atoi(argv[1]) : 1000000);
+
+	printf("Run Catalogue Benchmark (%i runs, best of %i)\n\n", nRuns, nRepeats);
+
+	// Create catalogue (and RunData views onto it) first, measuring the memory it takes
+	qint64 rss0 = residentMemory();
+	RunCatalogue catalogue;
+	List<RunData> runData;
+	catalogue.reserve(nRuns);
+	for (int n=0; n<nRuns; ++n)
+	{
+		RunData* rd = new RunData(&catalogue);
+		runData.own(rd);
+		rd->setName(QString("MER%1").arg(10000+n));
+		rd->setRunNumber(10000+n);
+		rd->setTitle(runTitle(n));
+		rd->setRBNumber(1610000 + n/120);
+		rd->setUser(runUser(n));
+		rd->setProtonCharge(12.5 + (n%400)*0.25);
+		rd->setDuration(600 + n%3000);
+		rd->setStartDateTime(runStart(n));
+		rd->setEndDateTime(runStart(n).addSecs(600 + n%3000));
+		rd->setTotalMEvents((n%900)*0.125);
+	}
+	qint64 rss1 = residentMemory();
+
+	// Create legacy per-run objects, as the parser used to (every string a separate copy)
+	List<LegacyRunData> legacyData;
+	for (int n=0; n<nRuns; ++n)
+	{
+		LegacyRunData* rd = legacyData.add();
+		rd->instrument_ = NULL;
+		rd->journalSource_ = NULL;
+		rd->name_ = QString("MER%1").arg(10000+n);
+		rd->runNumber_ = 10000+n;
+		rd->title_ = runTitle(n);
+		rd->rbNumber_ = 1610000 + n/120;
+		rd->user_ = runUser(n);
+		rd->protonCharge_ = 12.5 + (n%400)*0.25;
+		rd->duration_ = 600 + n%3000;
+		rd->durationString_ = RunData::durationAsString(rd->duration_);
+		rd->startDateTime_ = runStart(n);
+		rd->endDateTime_ = runStart(n).addSecs(rd->duration_);
+		rd->cycle_ = 0;
+		rd->totalMEvents_ = (n%900)*0.125;
+		rd->group_ = -1;
+		rd->visible_ = true;
+	}
+	qint64 rss2 = residentMemory();
+
+	printf("Footprint\n");
+	if (rss0 == -1) printf("  (resident memory not available on this platform)\n");
+	else
+	{
+		printf("  %-34s  %8.1f MB  (%5.0f bytes/run)\n", "Per-run objects (before)", (rss2-rss1)/1048576.0, double(rss2-rss1)/nRuns);
+		printf("  %-34s  %8.1f MB  (%5.0f bytes/run)\n", "Catalogue + RunData views (after)", (rss1-rss0)/1048576.0, double(rss1-rss0)/nRuns);
+	}
+	printf("  %-34s  %8.1f MB\n", "Catalogue columns (estimated)", catalogue.memoryUsage()/1048576.0);
+	printf("  %-34s  %8.1f MB\n\n", "Shared string pool (estimated)", RunCatalogue::stringPool().memoryUsage()/1048576.0);
+
+	// Scan criteria
+	int firstRun = 10000 + nRuns/4, lastRun = 10000 + nRuns/2;
+	QDateTime fromTime = runStart(nRuns/3), toTime = runStart(2*nRuns/3);
+	qint64 fromEpoch = fromTime.toMSecsSinceEpoch()/1000, toEpoch = toTime.toMSecsSinceEpoch()/1000;
+	QString user = runUser(nRuns/2);
+	int userId = RunCatalogue::stringId(user);
+	QString titleText = "in can at 25";
+
+	printHeadings("Runs");
+	double before, after;
+	int nBefore, nAfter;
+
+	// Run number range
+	before = bestOf([&]() { int count = 0; for (LegacyRunData* rd = legacyData.first(); rd != NULL; rd = rd->next) if ((rd->runNumber_ >= firstRun) && (rd->runNumber_ <= lastRun)) ++count; nBefore = count; });
+	after = bestOf([&]() { int count = 0; const int* runNumbers = catalogue.runNumbers(); for (int n=0; n<catalogue.nRows(); ++n) if ((runNumbers[n] >= firstRun) && (runNumbers[n] <= lastRun)) ++count; nAfter = count; });
+	printScan("Run number range", nRuns, before, nBefore, after, nAfter);
+
+	// Start date range
+	before = bestOf([&]() { int count = 0; for (LegacyRunData* rd = legacyData.first(); rd != NULL; rd = rd->next) if ((rd->startDateTime_ >= fromTime) && (rd->startDateTime_ <= toTime)) ++count; nBefore = count; });
+	after = bestOf([&]() { int count = 0; const qint64* starts = catalogue.startEpochs(); for (int n=0; n<catalogue.nRows(); ++n) if ((starts[n] >= fromEpoch) && (starts[n] <= toEpoch)) ++count; nAfter = count; });
+	printScan("Start date range", nRuns, before, nBefore, after, nAfter);
+
+	// User
+	before = bestOf([&]() { int count = 0; for (LegacyRunData* rd = legacyData.first(); rd != NULL; rd = rd->next) if (rd->user_ == user) ++count; nBefore = count; });
+	after = bestOf([&]() { int count = 0; const int* userIds = catalogue.userIds(); for (int n=0; n<catalogue.nRows(); ++n) if (userIds[n] == userId) ++count; nAfter = count; });
+	printScan("User", nRuns, before, nBefore, after, nAfter);
+
+	// Title text (each distinct title tested once per pass)
+	before = bestOf([&]() { int count = 0; for (LegacyRunData* rd = legacyData.first(); rd != NULL; rd = rd->next) if (rd->title_.contains(titleText, Qt::CaseInsensitive)) ++count; nBefore = count; });
+	after = bestOf([&]() {
+		int count = 0;
+		QVector<int> matches(RunCatalogue::nStrings(), -1);
+		const int* titleIds = catalogue.titleIds();
+		for (int n=0; n<catalogue.nRows(); ++n)
+		{
+			int& match = matches[titleIds[n]];
+			if (match == -1) match = RunCatalogue::string(titleIds[n]).contains(titleText, Qt::CaseInsensitive);
+			count += match;
+		}
+		nAfter = count;
+	});
+	printScan("Title text", nRuns, before, nBefore, after, nAfter);
+
+	return 0;
+}
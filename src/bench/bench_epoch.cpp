@@ -0,0 +1,100 @@
+/*
+	*** Time Conversion Benchmark
+	*** src/bench/bench_epoch.cpp
+	Copyright T. Youngs 2012-2016
+
+	This file is part of JournalViewer.
+
+	JournalViewer is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	JournalViewer is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with JournalViewer.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "bench.h"
+#include "isis.h"
+#include <QDateTime>
+#include <QStringList>
+#include <QVector>
+#include <stdlib.h>
+
+// Maximum number of mismatches to print
+const int maxMismatches = 20;
+
+// Create time strings every interval seconds from the start of the specified year, until the start of the last
+// Times are built from the fields rather than through QDateTime, so that local times skipped or repeated by daylight saving are included
+QStringList timeStrings(int firstYear, int lastYear, int interval)
+{
+	QStringList times;
+	qint64 last = qint64(QDate(firstYear, 1, 1).daysTo(QDate(lastYear, 1, 1)))*86400;
+	for (qint64 t = 0; t < last; t += interval)
+	{
+		QDate date = QDate(firstYear, 1, 1).addDays(t/86400);
+		int seconds = t%86400;
+		times << QString("%1-%2-%3T%4:%5:%6").arg(date.year(), 4, 10, QChar('0')).arg(date.month(), 2, 10, QChar('0')).arg(date.day(), 2, 10, QChar('0')).arg(seconds/3600, 2, 10, QChar('0')).arg((seconds/60)%60, 2, 10, QChar('0')).arg(seconds%60, 2, 10, QChar('0'));
+	}
+	return times;
+}
+
+// Return contribution of converted time to a checksum (its time of day, or -1 if it is invalid)
+double checksumOf(qint64 seconds)
+{
+	return (seconds == ISIS::invalidTime ? -1.0 : double(seconds%86400));
+}
+
+int main(int argc, char* argv[])
+{
+	// Range of years and interval between times (seconds) may be given on the command line
+	int firstYear = (argc > 1 ? atoi(argv[1]) : 1985);
+	int lastYear = (argc > 2 ? atoi(argv[2]) : 2035);
+	int interval = (argc > 3 ? atoi(argv[3]) : 1789);
+
+	// Regular times, plus those either side of every hour (where the cached UTC offset may change), short fields, and invalid times
+	QStringList times = timeStrings(firstYear, lastYear, interval);
+	for (int year = firstYear; year < lastYear; ++year)
+	{
+		for (int month = 1; month <= 12; ++month)
+		{
+			QString prefix = QString("%1-%2-").arg(year).arg(month, 2, 10, QChar('0'));
+			for (int hour = 0; hour < 24; ++hour) times << prefix + QString("%1T%2:59:59").arg(1 + (month*7+hour)%28, 2, 10, QChar('0')).arg(hour, 2, 10, QChar('0')) << prefix + QString("%1T%2:00:00").arg(1 + (month*7+hour)%28, 2, 10, QChar('0')).arg(hour, 2, 10, QChar('0'));
+			times << QString("%1-%2-%3T%4:%5:%6").arg(year).arg(month).arg(month+3).arg(month+1).arg(month).arg(month+40);
+			times << prefix + "31T12:00:00" << prefix + "29T12:00:00" << prefix + "30T12:00:00";
+		}
+	}
+	times << "" << "2016" << "2016-01-01" << "2016-01-01 12:00:00" << "2016-01-01T12:00" << "2016-01-01T24:00:00" << "2016-01-01T12:60:00" << "2016-01-01T12:00:60";
+	times << "2016-00-01T12:00:00" << "2016-13-01T12:00:00" << "2016-01-00T12:00:00" << "2016-01-32T12:00:00" << "2016-01-01T12:00:00Z" << "2016-01-01T12:00:00.5" << "20160101T120000";
+
+	printf("Time Conversion Benchmark (%i times, %i-%i, best of %i)\n\n", times.count(), firstYear, lastYear, nRepeats);
+
+	// Convert every time both ways, comparing the results
+	QVector<qint64> results(times.count()), qtResults(times.count());
+	int nMismatches = 0;
+	for (int n=0; n<times.count(); ++n)
+	{
+		results[n] = ISIS::epochSeconds(times.at(n));
+		qtResults[n] = ISIS::epochSeconds(QDateTime::fromString(times.at(n), "yyyy-MM-ddTHH:mm:ss"));
+		if (results[n] == qtResults[n]) continue;
+		if (++nMismatches <= maxMismatches) printf("  Mismatch: '%s' gives %lli seconds since epoch, but QDateTime gives %lli.\n", qPrintable(times.at(n)), results[n], qtResults[n]);
+	}
+	printf("%s%i mismatches with QDateTime\n\n", nMismatches == 0 ? "" : "\n", nMismatches);
+
+	// Time conversions
+	printHeadings("Times");
+	double checksum;
+
+	double before = bestOf([&]() { checksum = 0.0; for (int n=0; n<times.count(); ++n) checksum += checksumOf(ISIS::epochSeconds(QDateTime::fromString(times.at(n), "yyyy-MM-ddTHH:mm:ss"))); });
+	printResult("QDateTime::fromString (before)", times.count(), before, checksum);
+
+	double ms = bestOf([&]() { checksum = 0.0; for (int n=0; n<times.count(); ++n) checksum += checksumOf(ISIS::epochSeconds(times.at(n))); });
+	printResult("ISIS::epochSeconds (after)", times.count(), ms, checksum, before);
+
+	return (nMismatches == 0 ? 0 : 1);
+}
@@ -0,0 +1,108 @@
+/*
+	*** Run Grouping Benchmark
+	*** src/bench/bench_grouping.cpp
+	Copyright T. Youngs 2012-2016
+
+	This file is part of JournalViewer.
+
+	JournalViewer is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	JournalViewer is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with JournalViewer.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "bench.h"
+#include "rungrouping.h"
+#include "runcatalogue.h"
+#include <QList>
+#include <stdlib.h>
+
+// Synthetic title for run n - one in four is a variant differing only in case or spacing
+QString runTitle(int n, int nTitles)
+{
+	QString title = QString("Sample %1 in can at %2K").arg(n%nTitles).arg(100 + (n%nTitles)%300);
+	switch ((n/nTitles)%8)
+	{
+		case (1):
+			return title.toUpper();
+		case (5):
+			return QString("  ") + title.replace(" in ", "  in ");
+		default:
+			return title;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	// Number of runs and distinct titles may be given on the command line
+	int nRuns = (argc > 1 ? atoi(argv[1]) : 100000);
+	int nTitles = (argc > 2 ? atoi(argv[2]) : 5000);
+
+	// Create synthetic catalogue and RunData views onto it, in table order
+	RunCatalogue catalogue;
+	List<RunData> runData;
+	QVector<RunData*> runs;
+	catalogue.reserve(nRuns);
+	runs.reserve(nRuns);
+	for (int n=0; n<nRuns; ++n)
+	{
+		RunData* rd = new RunData(&catalogue);
+		runData.own(rd);
+		rd->setRunNumber(10000+n);
+		rd->setTitle(runTitle(n, nTitles));
+		runs << rd;
+	}
+
+	printf("Run Grouping Benchmark (%i runs, %i distinct titles, best of %i)\n\n", nRuns, RunCatalogue::nStrings(), nRepeats);
+	printHeadings("Runs");
+
+	double before, ms;
+	int nGroups;
+
+	// Before - linear search of a list of the unique titles for every run, as createGroups() used to do (run once, as it is slow)
+	before = bestOf([&]() {
+		QList<QString> runTitles;
+		for (int n=0; n<runs.count(); ++n)
+		{
+			int index = runTitles.indexOf(runs.at(n)->title());
+			if (index == -1)
+			{
+				runTitles << runs.at(n)->title();
+				index = runTitles.count()-1;
+			}
+			runs.at(n)->setGroup(index);
+		}
+		nGroups = runTitles.count();
+	}, 1);
+	printResult("Title, QList::indexOf (before)", runs.count(), before, nGroups);
+
+	// After - hashed keys, for the exact and normalised titles, with and without the cached groups
+	const char* keyNames[2] = { "Title", "Normalised title" };
+	int keys[2] = { RunProperty::Title, RunGrouping::NormalisedTitleKey };
+	for (int k=0; k<2; ++k)
+	{
+		RunGrouping grouping(keys[k]);
+
+		// Cold - every run is keyed and hashed
+		ms = bestOf([&]() { grouping.invalidate(); grouping.group(runs); nGroups = grouping.nGroups(); });
+		printResult(QString("%1, hashed (cold)").arg(keyNames[k]).toLatin1().constData(), runs.count(), ms, nGroups, before);
+
+		// Cached - the same runs grouped again (e.g. Select Similar after grouping the table)
+		ms = bestOf([&]() { grouping.group(runs); nGroups = grouping.nGroups(); });
+		printResult(QString("%1, hashed (cached)").arg(keyNames[k]).toLatin1().constData(), runs.count(), ms, nGroups, before);
+
+		// Lookup of the group of every run, as the table model does when serving the group column
+		ms = bestOf([&]() { int maxGroup = -1; for (int n=0; n<runs.count(); ++n) maxGroup = qMax(maxGroup, grouping.groupOf(runs.at(n))); nGroups = maxGroup+1; });
+		printResult(QString("%1, groupOf() of every run").arg(keyNames[k]).toLatin1().constData(), runs.count(), ms, nGroups, before);
+	}
+
+	return 0;
+}
@@ -0,0 +1,116 @@
+/*
+	*** List / RefList Benchmark
+	*** src/bench/bench_lists.cpp
+	Copyright T. Youngs 2012-2016
+
+	This file is part of JournalViewer.
+
+	JournalViewer is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	JournalViewer is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with JournalViewer.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "bench.h"
+#include "list.h"
+#include "reflist.h"
+#include <vector>
+#include <stdlib.h>
+
+// Number of items looked up in the linear-time RefList tests
+const int nProbes = 10000;
+
+// List item
+class BenchItem : public ListItem<BenchItem>
+{
+	public:
+	int value;
+};
+
+int main(int argc, char* argv[])
+{
+	// Number of items may be given on the command line
+	int nItems = (argc > 1 ? atoi(argv[1]) : 100000);
+	long checksum;
+	double ms;
+
+	// Pseudo-random item positions to look up
+	std::vector<int> positions(nItems);
+	unsigned int seed = 12345;
+	for (int n=0; n<nItems; ++n)
+	{
+		seed = seed*1103515245 + 12345;
+		positions[n] = (seed >> 8) % nItems;
+	}
+
+	printf("List / RefList Benchmark (%i items)\n\n", nItems);
+	printHeadings("Ops");
+
+	/*
+	 * List<T>
+	 */
+	List<BenchItem> list;
+
+	// Add items, accessing the newest by index after each add (as code filling a table row by row does)
+	checksum = 0;
+	ms = timeIt([&]() { for (int n=0; n<nItems; ++n) { list.add()->value = n; checksum += list[n]->value; } });
+	printResult("List add + operator[] interleaved", nItems, ms, checksum);
+
+	// Random access by index
+	checksum = 0;
+	ms = timeIt([&]() { for (int n=0; n<nItems; ++n) checksum += list[positions[n]]->value; });
+	printResult("List operator[] random", nItems, ms, checksum);
+
+	// Index of each item (in random order)
+	BenchItem** items = list.array();
+	std::vector<BenchItem*> itemsByPosition(items, items+nItems);
+	checksum = 0;
+	ms = timeIt([&]() { for (int n=0; n<nProbes; ++n) checksum += list.indexOf(itemsByPosition[positions[n]]); });
+	printResult("List indexOf", nProbes, ms, checksum);
+
+	/*
+	 * RefList<T,D>
+	 */
+	for (int indexed = 0; indexed < 2; ++indexed)
+	{
+		RefList<BenchItem,int> refList;
+		refList.setIndexed(indexed == 1);
+		printf("\n  RefList (%s)\n", indexed ? "indexed" : "unindexed");
+
+		// Add references
+		ms = timeIt([&]() { for (BenchItem* item = list.first(); item != NULL; item = item->next) refList.add(item, item->value); });
+		printResult("RefList add", nItems, ms, refList.nItems());
+
+		// Random access by index
+		checksum = 0;
+		ms = timeIt([&]() { for (int n=0; n<nItems; ++n) checksum += refList[positions[n]]->data; });
+		printResult("RefList operator[] random", nItems, ms, checksum);
+
+		// Search for items (in random order)
+		checksum = 0;
+		ms = timeIt([&]() { for (int n=0; n<nProbes; ++n) checksum += refList.contains(itemsByPosition[positions[n]])->data; });
+		printResult("RefList contains", nProbes, ms, checksum);
+
+		// Add items which are already referenced
+		ms = timeIt([&]() { for (int n=0; n<nProbes; ++n) refList.addUnique(itemsByPosition[positions[n]]); });
+		printResult("RefList addUnique (existing)", nProbes, ms, refList.nItems());
+
+		// Remove items (in random order)
+		ms = timeIt([&]() { for (int n=0; n<nProbes; ++n) if (refList.contains(itemsByPosition[positions[n]])) refList.remove(itemsByPosition[positions[n]]); });
+		printResult("RefList contains + remove", nProbes, ms, refList.nItems());
+
+		// Clear
+		ms = timeIt([&]() { refList.clear(); });
+		printResult("RefList clear", nItems, ms, refList.nItems());
+	}
+
+	return 0;
+}
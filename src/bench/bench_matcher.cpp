@@ -0,0 +1,78 @@
+/*
+	*** String Matcher Benchmark
+	*** src/bench/bench_matcher.cpp
+	Copyright T. Youngs 2012-2016
+
+	This file is part of JournalViewer.
+
+	JournalViewer is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	JournalViewer is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with JournalViewer.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "bench.h"
+#include "stringmatcher.h"
+#include "runcatalogue.h"
+#include <QThread>
+#include <stdlib.h>
+
+int main(int argc, char* argv[])
+{
+	// Number of runs may be given on the command line
+	int nRuns = (argc > 1 ? atoi(argv[1]) : 1000000);
+	int maxThreads = QThread::idealThreadCount();
+
+	// Create synthetic catalogue - every run has its own title, so every row has a string to test
+	RunCatalogue catalogue;
+	catalogue.reserve(nRuns);
+	for (int n=0; n<nRuns; ++n)
+	{
+		int row = catalogue.addRow();
+		catalogue.setRunNumber(row, 10000+n);
+		catalogue.setTitle(row, QString("Sample %1 in can at %2K, field %3T, run %4").arg(n%1500).arg(100 + n%300).arg((n%50)*0.1).arg(n));
+	}
+
+	printf("String Matcher Benchmark (%i runs, %i distinct titles, up to %i threads, best of %i)\n", nRuns, RunCatalogue::nStrings(), maxThreads, nRepeats);
+
+	const char* names[2] = { "Wildcard '*can at 2?0K*run 5*'", "RegExp 'sample 1[0-9]+ .*field 0\\.[1-3]T'" };
+	QRegExp exprs[2] = { QRegExp("*can at 2?0K*run 5*", Qt::CaseInsensitive, QRegExp::Wildcard), QRegExp("sample 1[0-9]+ .*field 0\\.[1-3]T", Qt::CaseInsensitive, QRegExp::RegExp) };
+	for (int e = 0; e < 2; ++e)
+	{
+		printf("\n  %s\n", names[e]);
+		printHeadings("Rows");
+
+		// Thread counts to test - powers of two, plus the ideal count
+		QVector<int> threadCounts;
+		for (int nThreads = 1; nThreads < maxThreads; nThreads *= 2) threadCounts << nThreads;
+		threadCounts << maxThreads;
+
+		QVector<int> serialMatches, matches;
+		double serialTime = 0.0;
+		foreach (int nThreads, threadCounts)
+		{
+			// Start from an empty match cache each time, so that every title is tested
+			StringMatcher::setMaxThreadCount(nThreads);
+			double ms = bestOf([&]() { matches.clear(); StringMatcher::match(exprs[e], catalogue.titleIds(), catalogue.nRows(), matches); });
+			if (nThreads == 1)
+			{
+				serialTime = ms;
+				serialMatches = matches;
+			}
+			int nMatched = 0;
+			for (int n=0; n<catalogue.nRows(); ++n) if (matches.at(catalogue.titleIds()[n]) == 1) ++nMatched;
+			printResult(QString("%1 thread(s), %2% efficiency").arg(nThreads).arg(100.0*serialTime/(ms*nThreads), 0, 'f', 0).toLatin1().constData(), catalogue.nRows(), ms, nMatched, serialTime);
+			if (matches != serialMatches) printf("  ** Mismatch with serial matches **\n");
+		}
+	}
+
+	return 0;
+}
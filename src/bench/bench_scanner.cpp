@@ -0,0 +1,95 @@
+/*
+	*** Journal Scanner Benchmark
+	*** src/bench/bench_scanner.cpp
+	Copyright T. Youngs 2012-2016
+
+	This file is part of JournalViewer.
+
+	JournalViewer is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	JournalViewer is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with JournalViewer.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "bench.h"
+#include "isis.h"
+#include "instrument.h"
+#include "journal.h"
+#include <stdlib.h>
+
+// Create synthetic journal data with the specified number of entries
+// If requested, the title of the first entry is wrapped in a CDATA section, which the scanner leaves to the full XML reader
+QByteArray syntheticJournal(int nEntries, bool forceFallback)
+{
+	QByteArray data = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<NXroot>\n";
+	data.reserve(nEntries*720);
+	for (int n=0; n<nEntries; ++n)
+	{
+		int runNumber = 10000 + n;
+		int day = 1 + (n/200)%28, hour = (n/8)%24, minute = (n*7)%60;
+		QByteArray startTime = QString("2016-%1-%2T%3:%4:00").arg(1 + (n/5600)%12, 2, 10, QChar('0')).arg(day, 2, 10, QChar('0')).arg(hour, 2, 10, QChar('0')).arg(minute, 2, 10, QChar('0')).toLatin1();
+		QByteArray title = "Sample " + QByteArray::number(n%1500) + " in can at " + QByteArray::number(100 + n%300) + "K &amp; 10 bar";
+		if ((n == 0) && forceFallback) title = "<![CDATA[" + title + "]]>";
+
+		data += "<NXentry name=\"MER" + QByteArray::number(runNumber) + "\">\n";
+		data += "\t<title>" + title + "</title>\n";
+		data += "\t<start_time>" + startTime + "</start_time>\n";
+		data += "\t<end_time>" + startTime + "</end_time>\n";
+		data += "\t<duration>" + QByteArray::number(600 + n%3000) + "</duration>\n";
+		data += "\t<proton_charge>" + QByteArray::number(12.5 + (n%400)*0.25) + "</proton_charge>\n";
+		data += "\t<raw_frames>" + QByteArray::number(30000 + n%1000) + "</raw_frames>\n";
+		data += "\t<good_frames>" + QByteArray::number(29000 + n%1000) + "</good_frames>\n";
+		data += "\t<run_number>" + QByteArray::number(runNumber) + "</run_number>\n";
+		data += "\t<experiment_identifier>" + QByteArray::number(1610000 + n/120) + "</experiment_identifier>\n";
+		data += "\t<user_name>User " + QByteArray::number((n/120)%400) + "</user_name>\n";
+		data += "\t<instrument_name>MERLIN</instrument_name>\n";
+		data += "\t<isis_cycle>cycle_16_" + QByteArray::number(1 + (n/10000)%5) + "</isis_cycle>\n";
+		data += "\t<total_mevents>" + QByteArray::number((n%900)*0.125) + "</total_mevents>\n";
+		data += "</NXentry>\n";
+	}
+	data += "</NXroot>\n";
+	return data;
+}
+
+// Parse a copy of the supplied data into the journal
+void parse(Journal* jrnl, const QByteArray& source)
+{
+	QByteArray data = source;
+	if (!ISIS::parseJournalData(jrnl, data))
+	{
+		printf("Error - Failed to parse synthetic journal.\n");
+		exit(1);
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	// Number of entries may be given on the command line
+	int nEntries = (argc > 1 ? atoi(argv[1]) : 20000);
+
+	Instrument inst;
+	inst.set(ISIS::MER);
+	inst.addJournal("journal_16_1.xml");
+	Journal* jrnl = inst.journals();
+
+	// The full XML reader is timed first, as the baseline
+	QByteArray xmlData = syntheticJournal(nEntries, true), scannerData = syntheticJournal(nEntries, false);
+	printf("Journal Scanner Benchmark (%i entries, %.2f MB, best of %i)\n\n", nEntries, scannerData.size() / 1048576.0, nRepeats);
+	printHeadings("Entries");
+
+	double before = bestOf([&]() { parse(jrnl, xmlData); });
+	printResult("QXmlStreamReader (before)", nEntries, before, jrnl->runData().nItems());
+
+	double ms = bestOf([&]() { parse(jrnl, scannerData); });
+	printResult("JournalScanner (after)", nEntries, ms, jrnl->runData().nItems(), before);
+
+	return 0;
+}
@@ -0,0 +1,217 @@
+/*
+	*** Block Data Cache
+	*** src/blockdatacache.cpp
+	Copyright T. Youngs 2012-2016
+
+	This file is part of JournalViewer.
+
+	JournalViewer is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	JournalViewer is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with JournalViewer.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "blockdatacache.h"
+#include "rundata.h"
+#include "instrument.h"
+#include "messenger.hui"
+
+// Constructor
+BlockDataCache::BlockDataCache()
+{
+	budget_ = 0;
+	nEvictions_ = 0;
+	nextStamp_ = 0;
+	totalBytes_ = 0;
+}
+
+/*
+ * Budget
+ */
+
+// Set memory budget for loaded block data (bytes, zero for unlimited)
+void BlockDataCache::setBudget(qint64 bytes)
+{
+	QMutexLocker locker(&mutex_);
+
+	budget_ = (bytes < 0 ? 0 : bytes);
+	QList<RunData*> victims = takeVictims(NULL);
+	locker.unlock();
+
+	evict(victims);
+}
+
+// Return memory budget for loaded block data (bytes)
+qint64 BlockDataCache::budget() const
+{
+	return budget_;
+}
+
+// Return number of runs evicted since the cache was created
+int BlockDataCache::nEvictions() const
+{
+	return nEvictions_;
+}
+
+/*
+ * Runs
+ */
+
+// Return entry for specified run, creating it if necessary
+BlockDataCache::Entry& BlockDataCache::entry(RunData* rd)
+{
+	QHash<RunData*,Entry>::iterator it = entries_.find(rd);
+	if (it != entries_.end()) return it.value();
+
+	Entry newEntry;
+	newEntry.stamp = nextStamp_++;
+	newEntry.bytes = 0;
+	usage_.insert(newEntry.stamp, rd);
+	return entries_.insert(rd, newEntry).value();
+}
+
+// Stop tracking unpinned runs (least recently used first) until the budget is met, returning them for eviction
+QList<RunData*> BlockDataCache::takeVictims(RunData* keep)
+{
+	QList<RunData*> victims;
+	if (budget_ == 0) return victims;
+
+	QMap<quint64,RunData*>::iterator it = usage_.begin();
+	while ((totalBytes_ > budget_) && (it != usage_.end()))
+	{
+		RunData* rd = it.value();
+		Entry& e = entries_[rd];
+
+		// Skip the run we are keeping, runs with no data to free, and pinned runs
+		if ((rd == keep) || (e.bytes == 0) || pins_.contains(runKey(rd)))
+		{
+			++it;
+			continue;
+		}
+
+		totalBytes_ -= e.bytes;
+		entries_.remove(rd);
+		it = usage_.erase(it);
+		++nEvictions_;
+		victims << rd;
+	}
+
+	return victims;
+}
+
+// Clear block data of runs returned by takeVictims() (called without the mutex held)
+void BlockDataCache::evict(const QList<RunData*>& victims)
+{
+	foreach(RunData* rd, victims)
+	{
+		msg.print("Evicting block data for run %i (%lli bytes) to stay within memory budget.", rd->runNumber(), rd->blockDataMemoryUsage());
+		rd->discardBlockData();
+	}
+}
+
+// Mark specified run as used, updating the size of its block data and enforcing the budget
+void BlockDataCache::touch(RunData* rd)
+{
+	if (rd == NULL) return;
+
+	QMutexLocker locker(&mutex_);
+
+	// Move run to the most-recently-used end of the usage map
+	Entry& e = entry(rd);
+	usage_.remove(e.stamp);
+	e.stamp = nextStamp_++;
+	usage_.insert(e.stamp, rd);
+
+	// Update size of block data
+	qint64 bytes = rd->blockDataMemoryUsage();
+	totalBytes_ += bytes - e.bytes;
+	e.bytes = bytes;
+
+	QList<RunData*> victims = takeVictims(rd);
+	locker.unlock();
+
+	evict(victims);
+}
+
+// Note that the block data of the specified run has been cleared
+void BlockDataCache::release(RunData* rd)
+{
+	QMutexLocker locker(&mutex_);
+
+	QHash<RunData*,Entry>::iterator it = entries_.find(rd);
+	if (it == entries_.end()) return;
+
+	totalBytes_ -= it.value().bytes;
+	usage_.remove(it.value().stamp);
+	entries_.erase(it);
+}
+
+// Stop tracking specified run entirely (it is being deleted)
+void BlockDataCache::remove(RunData* rd)
+{
+	// Any pins on the run are kept, since they apply equally to its replacement (if the journal is being reloaded)
+	release(rd);
+}
+
+// Return key identifying specified run (by instrument and run number) for pinning
+quint64 BlockDataCache::runKey(RunData* rd)
+{
+	quint64 inst = (rd->instrument() == NULL ? ISIS::nInstruments : rd->instrument()->instrument());
+	return (inst << 32) | quint32(rd->runNumber());
+}
+
+// Pin run with specified key so that its block data is never evicted
+void BlockDataCache::pin(quint64 key)
+{
+	QMutexLocker locker(&mutex_);
+
+	++pins_[key];
+}
+
+// Release pin on run with specified key
+void BlockDataCache::unpin(quint64 key)
+{
+	QMutexLocker locker(&mutex_);
+
+	QHash<quint64,int>::iterator it = pins_.find(key);
+	if (it == pins_.end()) return;
+	if (--it.value() > 0) return;
+	pins_.erase(it);
+
+	// Re-check the budget now that the run may be evicted
+	QList<RunData*> victims = takeVictims(NULL);
+	locker.unlock();
+
+	evict(victims);
+}
+
+// Return whether specified run is pinned
+bool BlockDataCache::isPinned(RunData* rd) const
+{
+	QMutexLocker locker(&mutex_);
+
+	return pins_.contains(runKey(rd));
+}
+// Return number of tracked runs
+int BlockDataCache::nRuns() const
+{
+	QMutexLocker locker(&mutex_);
+
+	return entries_.size();
+}
+
+// Return total estimated size of tracked block data (bytes)
+qint64 BlockDataCache::memoryUsage() const
+{
+	QMutexLocker locker(&mutex_);
+
+	return totalBytes_;
+}
@@ -0,0 +1,119 @@
+/*
+	*** Block Data Cache
+	*** src/blockdatacache.h
+	Copyright T. Youngs 2012-2016
+
+	This file is part of JournalViewer.
+
+	JournalViewer is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	JournalViewer is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with JournalViewer.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef JOURNALVIEWER_BLOCKDATACACHE_H
+#define JOURNALVIEWER_BLOCKDATACACHE_H
+
+#include <QHash>
+#include <QMap>
+#include <QList>
+#include <QMutex>
+
+// Forward Declarations
+class RunData;
+
+/*
+ * Least-recently-used tracker for RunData which have block data loaded.
+ * When the estimated size of all loaded block data exceeds the memory budget, the least recently used runs have their
+ * block data cleared (it is reloaded on demand by RunData::loadBlockData()). Pinned runs are never evicted.
+ * Pins are held on an instrument and run number rather than a RunData, so they stay valid (and keep applying) when the
+ * journal containing the run is reloaded.
+ */
+class BlockDataCache
+{
+	public:
+	// Constructor
+	BlockDataCache();
+
+
+	/*
+	 * Budget
+	 */
+	private:
+	// Memory budget for loaded block data (bytes, zero for unlimited)
+	qint64 budget_;
+	// Number of runs evicted since the cache was created
+	int nEvictions_;
+
+	public:
+	// Set memory budget for loaded block data (bytes, zero for unlimited)
+	void setBudget(qint64 bytes);
+	// Return memory budget for loaded block data (bytes)
+	qint64 budget() const;
+	// Return number of runs evicted since the cache was created
+	int nEvictions() const;
+
+
+	/*
+	 * Runs
+	 */
+	private:
+	// Cache entry for a single run
+	struct Entry
+	{
+		// Usage stamp (higher is more recent)
+		quint64 stamp;
+		// Estimated size of block data (bytes)
+		qint64 bytes;
+	};
+	// Entries for tracked runs
+	QHash<RunData*,Entry> entries_;
+	// Number of pins held on runs, by run key
+	QHash<quint64,int> pins_;
+	// Tracked runs, in order of last use
+	QMap<quint64,RunData*> usage_;
+	// Next usage stamp
+	quint64 nextStamp_;
+	// Total estimated size of tracked block data (bytes)
+	qint64 totalBytes_;
+	// Mutex protecting the cache
+	mutable QMutex mutex_;
+
+	private:
+	// Return entry for specified run, creating it if necessary
+	Entry& entry(RunData* rd);
+	// Stop tracking unpinned runs (least recently used first) until the budget is met, returning them for eviction
+	QList<RunData*> takeVictims(RunData* keep);
+	// Clear block data of runs returned by takeVictims() (called without the mutex held)
+	void evict(const QList<RunData*>& victims);
+
+	public:
+	// Mark specified run as used, updating the size of its block data and enforcing the budget
+	void touch(RunData* rd);
+	// Note that the block data of the specified run has been cleared
+	void release(RunData* rd);
+	// Stop tracking specified run entirely (it is being deleted)
+	void remove(RunData* rd);
+	// Return key identifying specified run (by instrument and run number) for pinning
+	static quint64 runKey(RunData* rd);
+	// Pin run with specified key so that its block data is never evicted
+	void pin(quint64 key);
+	// Release pin on run with specified key
+	void unpin(quint64 key);
+	// Return whether specified run is pinned
+	bool isPinned(RunData* rd) const;
+	// Return number of tracked runs
+	int nRuns() const;
+	// Return total estimated size of tracked block data (bytes)
+	qint64 memoryUsage() const;
+};
+
+#endif
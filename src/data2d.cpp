@@ -25,6 +25,7 @@
 
 #include "data2d.h"
 #include "enumeration.h"
+#include "isis.h"
 #include "messenger.hui"
 #include <math.h>
 #include <stdio.h>
@@ -99,6 +100,8 @@ EnumeratedValue* Data2DValue::constEnumeratedY() const
 Data2D::Data2D() : ListItem<Data2D>()
 {
 	name_ = "Untitled";
+	runTimeStart_ = ISIS::invalidTime;
+	runTimeEnd_ = ISIS::invalidTime;
 }
 
 // Destructor
@@ -118,8 +121,8 @@ void Data2D::clear()
 	x_.clear();
 	y_.clear();
 	enumeratedY_.clear();
-	runTimeStart_ = QDateTime();
-	runTimeEnd_ = QDateTime();
+	runTimeStart_ = ISIS::invalidTime;
+	runTimeEnd_ = ISIS::invalidTime;
 }
 
 /*
@@ -148,6 +151,13 @@ void Data2D::initialise(int size)
 	resize(size);
 }
 
+// Reserve space for the specified total number of datapoints
+void Data2D::reserve(int size)
+{
+	x_.reserve(size);
+	y_.reserve(size);
+}
+
 // Return current array size
 int Data2D::arraySize()
 {
@@ -211,17 +221,24 @@ Array<Data2DValue>& Data2D::arrayY()
 	return y_;
 }
 
+// Return time in seconds relative to specified origin (zero if either is invalid)
+static int relativeTime(qint64 origin, qint64 epochSeconds)
+{
+	if ((origin == ISIS::invalidTime) || (epochSeconds == ISIS::invalidTime)) return 0;
+	return epochSeconds - origin;
+}
+
 // Add relative data point
-void Data2D::addRelativePoint(QDateTime time, double y)
+void Data2D::addRelativePoint(qint64 epochSeconds, double y)
 {
-	x_.add(runTimeStart_.secsTo(time));
+	x_.add(relativeTime(runTimeStart_, epochSeconds));
 	y_.add(Data2DValue(y, NULL));
 }
 
 // Add relative data point (enumerated value)
-void Data2D::addRelativePoint(QDateTime time, EnumeratedValue* enumy)
+void Data2D::addRelativePoint(qint64 epochSeconds, EnumeratedValue* enumy)
 {
-	x_.add(runTimeStart_.secsTo(time));
+	x_.add(relativeTime(runTimeStart_, epochSeconds));
 	y_.add(Data2DValue(0.0, enumy));
 
 	// Store unique link to EnumeratedValue
@@ -236,7 +253,7 @@ void Data2D::addPoint(int x, double y)
 }
 
 // Set time origin for data
-void Data2D::setRunTimeSpan(QDateTime origin, QDateTime endTime)
+void Data2D::setRunTimeSpan(qint64 origin, qint64 endTime)
 {
 	runTimeStart_ = origin;
 	runTimeEnd_ = endTime;
@@ -245,13 +262,13 @@ void Data2D::setRunTimeSpan(QDateTime origin, QDateTime endTime)
 // Return time origin for data
 QDateTime Data2D::runTimeStart()
 {
-	return runTimeStart_;
+	return ISIS::dateTime(runTimeStart_);
 }
 
 // Return run time end as relative x offset from runTimeStart_
 int Data2D::runTimeEndAsX()
 {
-	return runTimeStart_.secsTo(runTimeEnd_);
+	return relativeTime(runTimeStart_, runTimeEnd_);
 }
 
 // Set name of data
@@ -272,6 +289,16 @@ const RefList<EnumeratedValue,int>& Data2D::enumeratedY()
 	return enumeratedY_;
 }
 
+// Return estimated memory used by data (bytes)
+qint64 Data2D::memoryUsage() const
+{
+	qint64 bytes = sizeof(Data2D);
+	bytes += x_.capacity() * sizeof(int) + y_.capacity() * sizeof(Data2DValue);
+	bytes += (name_.capacity() + groupName_.capacity()) * sizeof(QChar);
+	bytes += enumeratedY_.nItems() * sizeof(RefListItem<EnumeratedValue,int>);
+	return bytes;
+}
+
 // Set name of parent group
 void Data2D::setGroupName(QString name)
 {
@@ -336,7 +363,7 @@ int Data2D::runNPoints()
 // Calculate time covered by datapoints within run begin/end
 double Data2D::runTimeCoverage()
 {
-	return runTimeStart_.secsTo(runTimeEnd_);
+	return relativeTime(runTimeStart_, runTimeEnd_);
 }
 
 // Calculate and return average over run begin/end
@@ -82,10 +82,10 @@ class Data2D : public ListItem<Data2D>
 	 */
 	///@{
 	private:
-	// Run start time (i.e. time origin) for stored data (x values are relative to this point)
-	QDateTime runTimeStart_;
-	// Run time end
-	QDateTime runTimeEnd_;
+	// Run start time (i.e. time origin, in seconds since epoch) for stored data (x values are relative to this point)
+	qint64 runTimeStart_;
+	// Run time end (seconds since epoch)
+	qint64 runTimeEnd_;
 	// Abcissa
 	Array<int> x_;
 	// Data values
@@ -106,6 +106,8 @@ class Data2D : public ListItem<Data2D>
 	public:
 	// Initialise arrays to specified size
 	void initialise(int size);
+	// Reserve space for the specified total number of datapoints
+	void reserve(int size);
 	// Return current array size
 	int arraySize();
 	// Return number of defined datapoints
@@ -121,13 +123,13 @@ class Data2D : public ListItem<Data2D>
 	// Return y Array
 	Array<Data2DValue>& arrayY();
 	// Add relative data point
-	void addRelativePoint(QDateTime time, double y);
+	void addRelativePoint(qint64 epochSeconds, double y);
 	// Add relative data point (enumerated value)
-	void addRelativePoint(QDateTime time, EnumeratedValue* enumy);
+	void addRelativePoint(qint64 epochSeconds, EnumeratedValue* enumy);
 	// Add normal data point
 	void addPoint(int x, double y);
 	// Set time origin and endpoint for run
-	void setRunTimeSpan(QDateTime origin, QDateTime endTime);
+	void setRunTimeSpan(qint64 origin, qint64 endTime);
 	// Return run time start (time origin) for data
 	QDateTime runTimeStart();
 	// Return run time end as relative x offset from runTimeStart_
@@ -142,6 +144,8 @@ class Data2D : public ListItem<Data2D>
 	QString groupName() const;
 	// Return list of referenced enumerated values
 	const RefList<EnumeratedValue,int>& enumeratedY();
+	// Return estimated memory used by data (bytes)
+	qint64 memoryUsage() const;
 	///@}
 
 
@@ -69,14 +69,22 @@ class DataInterface : public QObject
 	void setLabelText(QString text);
 	// Load file data into specified QByteArray
 	static bool readFile(QString fileName, QByteArray& data);
-	// Load data from net into QByteArray
-	bool readHttp(QUrl location, QByteArray& data);
+	// Load data from net into QByteArray (optionally from the specified byte offset onwards)
+	bool readHttp(QUrl location, QByteArray& data, qint64 rangeStart = 0);
 	// Get modification time from HTTP header
 	bool readHttpModificationTime(QUrl location, QDateTime& httpModificationTime);
 	// Get modification time of most recent version of specified source
 	bool mostRecent(JournalViewer::JournalAccess accessType, QString localFile, QUrl httpFile, QDateTime& modTime, JournalViewer::JournalAccess& sourceType);
+	// Get modification time of most recent version of specified source, using the supplied interface (if any) for http requests
+	static bool mostRecent(JournalViewer::JournalAccess accessType, QString localFile, QUrl httpFile, QDateTime& modTime, JournalViewer::JournalAccess& sourceType, DataInterface* progressInterface);
+	// Load data from net into QByteArray, blocking the calling thread (no progress indication)
+	static bool fetchHttp(QUrl location, QByteArray& data, qint64 rangeStart = 0);
+	// Get modification time from HTTP header, blocking the calling thread (no progress indication)
+	static bool fetchHttpModificationTime(QUrl location, QDateTime& httpModificationTime);
 	// Save local copy of specified data
-	static bool saveLocalCopy(QByteArray& data, QString localFile, QDateTime modificationTime);
+	static bool saveLocalCopy(const QByteArray& data, QString localFile, QDateTime modificationTime);
+	// Update local copy of data, replacing everything from the specified byte offset onwards
+	static bool appendLocalCopy(const QByteArray& data, QString localFile, qint64 offset, QDateTime modificationTime);
 
 	public slots:
 	// Cancel current retrieval
@@ -98,7 +106,7 @@ class LoadDataThread : public QThread
 
 	public:
 	// Constructor (retrieve data)
-	LoadDataThread(DataInterface* parent, QUrl location, QByteArray& array);
+	LoadDataThread(DataInterface* parent, QUrl location, QByteArray& array, qint64 rangeStart = 0);
 	// Constructor (retrieve header)
 	LoadDataThread(DataInterface* parent, QUrl location, QDateTime& dateTime);
 
@@ -109,6 +117,8 @@ class LoadDataThread : public QThread
 	bool error_;
 	// Target file URL
 	QUrl location_;
+	// Byte offset from which to retrieve data (0 for whole file)
+	qint64 rangeStart_;
 	// QByteArray to put data in to
 	QByteArray& byteArray_;
 	// QDateTime to put modification time in to
@@ -121,6 +131,8 @@ class LoadDataThread : public QThread
 	public:
 	// Execute thread
 	void run();
+	// Return whether an error occurred in the last retrieval
+	bool error();
 
 	public slots:
 	// Cancel current download
@@ -93,8 +93,8 @@ bool DataInterface::readFile(QString fileName, QByteArray& data)
 	return true;
 }
 
-// Load data from net into QByteArray
-bool DataInterface::readHttp(QUrl location, QByteArray& data)
+// Load data from net into QByteArray (optionally from the specified byte offset onwards)
+bool DataInterface::readHttp(QUrl location, QByteArray& data, qint64 rangeStart)
 {
 	// Set target label
 	if (progressLabel_ && progressBar_)
@@ -105,7 +105,7 @@ bool DataInterface::readHttp(QUrl location, QByteArray& data)
 	}
 
 	// Prepare a LoadDataThread so we retrieve data in the background whilst displaying progress in a nice way
-	dataThread_ = new LoadDataThread(this, location, data);
+	dataThread_ = new LoadDataThread(this, location, data, rangeStart);
 
 	// Connect the thread's 'finished' signal to its own 'deleteLater' slot so it is nicely cleaned up
 	QObject::connect(dataThread_, SIGNAL(finished()), dataThread_, SLOT(deleteLater()));
@@ -161,8 +161,34 @@ bool DataInterface::readHttpModificationTime(QUrl location, QDateTime& httpModif
 	return httpSuccess_;
 }
 
+// Load data from net into QByteArray, blocking the calling thread (no progress indication)
+bool DataInterface::fetchHttp(QUrl location, QByteArray& data, qint64 rangeStart)
+{
+	// Run the thread's retrieval directly in the calling thread
+	LoadDataThread loader(NULL, location, data, rangeStart);
+	loader.run();
+
+	return !loader.error();
+}
+
+// Get modification time from HTTP header, blocking the calling thread (no progress indication)
+bool DataInterface::fetchHttpModificationTime(QUrl location, QDateTime& httpModificationTime)
+{
+	// Run the thread's retrieval directly in the calling thread
+	LoadDataThread loader(NULL, location, httpModificationTime);
+	loader.run();
+
+	return !loader.error();
+}
+
 // Get modification time of most recent version of specified source
 bool DataInterface::mostRecent(JournalViewer::JournalAccess accessType, QString localFile, QUrl httpFile, QDateTime& modTime, JournalViewer::JournalAccess& sourceType)
+{
+	return mostRecent(accessType, localFile, httpFile, modTime, sourceType, this);
+}
+
+// Get modification time of most recent version of specified source, using the supplied interface (if any) for http requests
+bool DataInterface::mostRecent(JournalViewer::JournalAccess accessType, QString localFile, QUrl httpFile, QDateTime& modTime, JournalViewer::JournalAccess& sourceType, DataInterface* progressInterface)
 {
 	sourceType = JournalViewer::NoAccess;
 	bool result = false;
@@ -195,7 +221,7 @@ bool DataInterface::mostRecent(JournalViewer::JournalAccess accessType, QString
 		// Was a valid httpFile given?
 		// If so, get HTTP source modification time
 		if (httpFile.isEmpty()) httpAvailable = false;
-		else if (readHttpModificationTime(httpFile, httpModificationTime)) httpAvailable = true;
+		else if (progressInterface ? progressInterface->readHttpModificationTime(httpFile, httpModificationTime) : fetchHttpModificationTime(httpFile, httpModificationTime)) httpAvailable = true;
 	}
 
 	// Return suitable result...
@@ -247,7 +273,7 @@ bool DataInterface::mostRecent(JournalViewer::JournalAccess accessType, QString
 }
 
 // Save local copy of specified data
-bool DataInterface::saveLocalCopy(QByteArray& data, QString localFile, QDateTime modificationTime)
+bool DataInterface::saveLocalCopy(const QByteArray& data, QString localFile, QDateTime modificationTime)
 {
 	msg.print("Saving local copy of data...");
 
@@ -293,6 +319,34 @@ bool DataInterface::saveLocalCopy(QByteArray& data, QString localFile, QDateTime
 	return true;
 }
 
+// Update local copy of data, replacing everything from the specified byte offset onwards
+bool DataInterface::appendLocalCopy(const QByteArray& data, QString localFile, qint64 offset, QDateTime modificationTime)
+{
+	QFile file;
+	file.setFileName(localFile);
+	if ((!file.exists()) || (file.size() < offset))
+	{
+		msg.print("Local copy '" + localFile + "' is missing or shorter than expected - can't append to it.");
+		return false;
+	}
+
+	msg.print("Appending %i bytes to local data file '%s' at offset %lli", data.size(), qPrintable(localFile), offset);
+
+	file.open(QIODevice::ReadWrite);
+	if ((!file.isWritable()) || (!file.resize(offset)) || (!file.seek(offset)) || (file.write(data) != data.size()))
+	{
+		msg.print("Error: Failed to append to file '" + localFile + "'");
+		return false;
+	}
+	file.close();
+
+	// Save modification time to settings
+	QSettings settings;
+	settings.setValue(QString("modtime/")+localFile, modificationTime);
+
+	return true;
+}
+
 // Cancel current retrieval
 void DataInterface::cancel()
 {
@@ -329,11 +383,12 @@ void DataInterface::threadFailed()
  */
 
 // Constructor (retrieve data)
-LoadDataThread::LoadDataThread(DataInterface* parent, QUrl location, QByteArray& array) : byteArray_(array), dateTime_(dummyDateTime)
+LoadDataThread::LoadDataThread(DataInterface* parent, QUrl location, QByteArray& array, qint64 rangeStart) : byteArray_(array), dateTime_(dummyDateTime)
 {
 	error_ = false;
 	parent_ = parent;
 	location_ = location;
+	rangeStart_ = rangeStart;
 	headerOnly_ = false;
 	networkReply_= NULL;
 }
@@ -344,6 +399,7 @@ LoadDataThread::LoadDataThread(DataInterface* parent, QUrl location, QDateTime&
 	error_ = false;
 	parent_ = parent;
 	location_ = location;
+	rangeStart_ = 0;
 	headerOnly_ = true;
 	networkReply_ = NULL;
 }
@@ -361,8 +417,15 @@ void LoadDataThread::run()
 
 	// Make the request
 	QEventLoop loop;
-	if (headerOnly_) networkReply_ = networkManager.head(QNetworkRequest(location_));
-	else networkReply_ = networkManager.get(QNetworkRequest(location_));
+	QNetworkRequest request(location_);
+	if (rangeStart_ > 0)
+	{
+		// Byte ranges refer to the encoded content, so ask for it unencoded
+		request.setRawHeader("Range", "bytes=" + QByteArray::number(rangeStart_) + "-");
+		request.setRawHeader("Accept-Encoding", "identity");
+	}
+	if (headerOnly_) networkReply_ = networkManager.head(request);
+	else networkReply_ = networkManager.get(request);
 
 	// Create reply timeout object (10 minutes)
 	TReplyTimeout replyTimeout(networkReply_, 600000);
@@ -391,7 +454,17 @@ void LoadDataThread::run()
 	}
 
 	if (headerOnly_) dateTime_ = networkReply_->header(QNetworkRequest::LastModifiedHeader).toDateTime();
-	else byteArray_ = networkReply_->readAll();
+	else
+	{
+		byteArray_ = networkReply_->readAll();
+
+		// If a range was requested but the server ignored it (i.e. did not return '206 Partial Content') discard the leading bytes ourselves
+		if ((rangeStart_ > 0) && (networkReply_->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() != 206))
+		{
+			msg.print("LoadDataThread::run() - Server ignored range request, so full data was retrieved.");
+			byteArray_.remove(0, rangeStart_);
+		}
+	}
 	
 	networkReply_->close();
 	
@@ -403,6 +476,12 @@ void LoadDataThread::run()
 	emit done();
 }
 
+// Return whether an error occurred in the last retrieval
+bool LoadDataThread::error()
+{
+	return error_;
+}
+
 // Cancel current download (slot)
 void LoadDataThread::cancel()
 {
@@ -119,6 +119,14 @@ Document::Document(QPainter& painter, QPrinter* printer) : painter_(painter)
 	mode_ = Document::Creation;
 }
 
+// Destructor
+Document::~Document()
+{
+	// Record size of command list, since Documents only exist while they are being printed
+	qint64 bytes = memoryUsage();
+	if (bytes > largestMemoryUsage_) largestMemoryUsage_ = bytes;
+}
+
 // Clear all commands
 void Document::clearCommands()
 {
@@ -382,6 +390,28 @@ void Document::addContent(DocumentCommand* content)
 	else printf("Called Document::addContent() with a DocumentCommand pointer when still creating document.\n");
 }
 
+/*
+ * Memory Usage
+ */
+
+// Largest estimated memory used by any Document so far (bytes)
+qint64 Document::largestMemoryUsage_ = 0;
+
+// Return estimated memory used by commands and columns (bytes)
+qint64 Document::memoryUsage() const
+{
+	qint64 bytes = sizeof(Document);
+	for (DocumentCommand* cmd = commands_.first(); cmd != NULL; cmd = cmd->next) bytes += cmd->memoryUsage();
+	bytes += currentColumns_.nItems() * sizeof(RefListItem<DocumentColumn,int>);
+	return bytes;
+}
+
+// Return largest estimated memory used by any Document so far (bytes)
+qint64 Document::largestMemoryUsage()
+{
+	return largestMemoryUsage_;
+}
+
 /*
  * Rendering
  */
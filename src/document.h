@@ -85,6 +85,7 @@ class Document
 	public:
 	// Constructor / Destructor
 	Document(QPainter& painter, QPrinter* printer = NULL);
+	~Document();
 	// Document Mode
 	enum DocumentMode { Creation, Execution };
 
@@ -135,6 +136,20 @@ class Document
 	void addContent(DocumentCommand* content);
 
 
+	/*
+	 * Memory Usage
+	 */
+	private:
+	// Largest estimated memory used by any Document so far (bytes)
+	static qint64 largestMemoryUsage_;
+
+	public:
+	// Return estimated memory used by commands and columns (bytes)
+	qint64 memoryUsage() const;
+	// Return largest estimated memory used by any Document so far (bytes)
+	static qint64 largestMemoryUsage();
+
+
 	/*
 	 * Rendering
 	 */
@@ -64,6 +64,12 @@ void DocumentCommand::drawContent(QPainter& painter, QRect boundingRect)
 	return;
 }
 
+// Return estimated memory used by command (bytes)
+qint64 DocumentCommand::memoryUsage() const
+{
+	return sizeof(DocumentCommand);
+}
+
 /*
  * Add Column Command
  */
@@ -95,6 +101,12 @@ void AddColumnCommand::execute(Document& target)
 	target.addColumn(false, column_);
 }
 
+// Return estimated memory used by command (bytes)
+qint64 AddColumnCommand::memoryUsage() const
+{
+	return sizeof(AddColumnCommand) + (column_ != NULL ? sizeof(DocumentColumn) : 0);
+}
+
 /*
  * Background Colour Command
  */
@@ -117,6 +129,12 @@ void BackgroundColourCommand::execute(Document& target)
 	target.setBackgroundColour(colour_);
 }
 
+// Return estimated memory used by command (bytes)
+qint64 BackgroundColourCommand::memoryUsage() const
+{
+	return sizeof(BackgroundColourCommand);
+}
+
 /*
  * Clear Columns Command
  */
@@ -138,6 +156,12 @@ void ClearColumnsCommand::execute(Document& target)
 	target.clearColumns();
 }
 
+// Return estimated memory used by command (bytes)
+qint64 ClearColumnsCommand::memoryUsage() const
+{
+	return sizeof(ClearColumnsCommand);
+}
+
 /*
  * End Row Command
  */
@@ -159,6 +183,12 @@ void EndRowCommand::execute(Document& target)
 	target.endRow();
 }
 
+// Return estimated memory used by command (bytes)
+qint64 EndRowCommand::memoryUsage() const
+{
+	return sizeof(EndRowCommand);
+}
+
 /*
  * Font Command
  */
@@ -181,6 +211,12 @@ void FontCommand::execute(Document& target)
 	target.setFont(font_);
 }
 
+// Return estimated memory used by command (bytes)
+qint64 FontCommand::memoryUsage() const
+{
+	return sizeof(FontCommand);
+}
+
 /*
  * Foreground Colour Command
  */
@@ -203,6 +239,12 @@ void ForegroundColourCommand::execute(Document& target)
 	target.setForegroundColour(colour_);
 }
 
+// Return estimated memory used by command (bytes)
+qint64 ForegroundColourCommand::memoryUsage() const
+{
+	return sizeof(ForegroundColourCommand);
+}
+
 /*
  * Text Command
  */
@@ -256,6 +298,12 @@ void TextCommand::drawContent(QPainter& painter, QRect boundingRect)
 	painter.drawText(boundingRect, Qt::TextWordWrap | alignment_, text_);
 }
 
+// Return estimated memory used by command (bytes)
+qint64 TextCommand::memoryUsage() const
+{
+	return sizeof(TextCommand) + text_.capacity() * sizeof(QChar);
+}
+
 /*
  * Plot Command
  */
@@ -301,3 +349,10 @@ void PlotCommand::drawContent(QPainter& painter, QRect boundingRect)
 	plot_.draw(image);
 	painter.drawImage(boundingRect, image);
 }
+
+// Return estimated memory used by command (bytes)
+qint64 PlotCommand::memoryUsage() const
+{
+	// The plot itself is owned elsewhere
+	return sizeof(PlotCommand);
+}
@@ -67,6 +67,8 @@ class DocumentCommand : public ListItem<DocumentCommand>
 	virtual QRect contentsRect(QPainter& painter, QRect initialRect, bool wordWrap = false);
 	// Draw content within specified bounding rectangle
 	virtual void drawContent(QPainter& painter, QRect boundingRect);
+	// Return estimated memory used by command (bytes)
+	virtual qint64 memoryUsage() const;
 };
 
 // Add Column Command
@@ -87,6 +89,8 @@ class AddColumnCommand : public DocumentCommand
 	DocumentColumn* column();
 	// Execute command on target Document
 	void execute(Document& target);
+	// Return estimated memory used by command (bytes)
+	qint64 memoryUsage() const;
 };
 
 // Background Colour Command
@@ -105,6 +109,8 @@ class BackgroundColourCommand : public DocumentCommand
 	public:
 	// Execute command on target Document
 	void execute(Document& target);
+	// Return estimated memory used by command (bytes)
+	qint64 memoryUsage() const;
 };
 
 // Clear Columns Command
@@ -119,6 +125,8 @@ class ClearColumnsCommand : public DocumentCommand
 	public:
 	// Execute command on target Document
 	void execute(Document& target);
+	// Return estimated memory used by command (bytes)
+	qint64 memoryUsage() const;
 };
 
 // End Row Command
@@ -133,6 +141,8 @@ class EndRowCommand : public DocumentCommand
 	public:
 	// Execute command on target Document
 	void execute(Document& target);
+	// Return estimated memory used by command (bytes)
+	qint64 memoryUsage() const;
 };
 
 // Font Command
@@ -151,6 +161,8 @@ class FontCommand : public DocumentCommand
 	public:
 	// Execute command on target Document
 	void execute(Document& target);
+	// Return estimated memory used by command (bytes)
+	qint64 memoryUsage() const;
 };
 
 // Foreground Colour Command
@@ -169,6 +181,8 @@ class ForegroundColourCommand : public DocumentCommand
 	public:
 	// Execute command on target Document
 	void execute(Document& target);
+	// Return estimated memory used by command (bytes)
+	qint64 memoryUsage() const;
 };
 
 // Text Command
@@ -197,6 +211,8 @@ class TextCommand : public DocumentCommand
 	QRect contentsRect(QPainter& painter, QRect initialRect, bool wordWrap = false);
 	// Draw content within specified bounding rectangle
 	void drawContent(QPainter& painter, QRect boundingRect);
+	// Return estimated memory used by command (bytes)
+	qint64 memoryUsage() const;
 };
 
 // Plot Command
@@ -221,6 +237,8 @@ class PlotCommand : public DocumentCommand
 	QRect contentsRect(QPainter& painter, QRect initialRect, bool wordWrap = false);
 	// Draw content within specified bounding rectangle
 	void drawContent(QPainter& painter, QRect boundingRect);
+	// Return estimated memory used by command (bytes)
+	qint64 memoryUsage() const;
 };
 
 
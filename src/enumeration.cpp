@@ -72,3 +72,11 @@ EnumeratedValue* Enumeration::value(QString value)
 	values_.own(newValue);
 	return newValue;
 }
+
+// Return estimated memory used by enumeration (bytes)
+qint64 Enumeration::memoryUsage() const
+{
+	qint64 bytes = sizeof(Enumeration) + name_.capacity() * sizeof(QChar);
+	for (EnumeratedValue* ev = values_.first(); ev != NULL; ev = ev->next) bytes += sizeof(EnumeratedValue) + ev->name().capacity() * sizeof(QChar);
+	return bytes;
+}
@@ -65,6 +65,8 @@ class Enumeration : public ListItem<Enumeration>
 	QString name();
 	// Find/create enumerated value
 	EnumeratedValue* value(QString value);
+	// Return estimated memory used by enumeration (bytes)
+	qint64 memoryUsage() const;
 };
 
 #endif
@@ -0,0 +1,309 @@
+/*
+	*** Facet Index
+	*** src/facetindex.cpp
+	Copyright T. Youngs 2012-2016
+
+	This file is part of JournalViewer.
+
+	JournalViewer is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	JournalViewer is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with JournalViewer.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "facetindex.h"
+#include "journal.h"
+#include "instrument.h"
+#include "runcatalogue.h"
+
+// Constructor
+FacetIndex::FacetIndex()
+{
+	hasRuns_ = false;
+	firstRunNumber_ = 0;
+	lastRunNumber_ = 0;
+	earliestStart_ = 0;
+	latestEnd_ = 0;
+	resetCounts();
+}
+
+/*
+ * Journal Facets
+ */
+
+// Clear index
+void FacetIndex::clear()
+{
+	journals_.clear();
+	merge(QVector<Journal*>());
+}
+
+// Add (or re-add) facets of specified journal
+void FacetIndex::addJournal(Journal* jrnl)
+{
+	// Any merged values of the journal no longer correspond to its runs
+	for (int n=0; n<nFacets; ++n) valueMaps_[n].remove(jrnl);
+	JournalFacets& facets = journals_[jrnl];
+	facets = JournalFacets();
+
+	const RunCatalogue* catalogue = jrnl->catalogue();
+	int nRows = catalogue->nRows();
+	const int* runNumbers = catalogue->runNumbers();
+	const int* userIds = catalogue->userIds();
+	const qint64* startEpochs = catalogue->startEpochs();
+	const qint64* endEpochs = catalogue->endEpochs();
+	const int* columns[nFacets] = { userIds, catalogue->rbNumbers(), catalogue->cycles() };
+	facets.firstRunNumber = (nRows > 0 ? runNumbers[0] : 0);
+	facets.lastRunNumber = facets.firstRunNumber;
+	facets.earliestStart = (nRows > 0 ? startEpochs[0] : 0);
+	facets.latestEnd = (nRows > 0 ? endEpochs[0] : 0);
+
+	// Find distinct values of each facet, and the value of each run
+	QHash<int,int> valueIndex[nFacets];
+	for (int n=0; n<nFacets; ++n) facets.runValues[n].resize(nRows);
+	for (int row = 0; row < nRows; ++row)
+	{
+		for (int n=0; n<nFacets; ++n)
+		{
+			QHash<int,int>::const_iterator it = valueIndex[n].constFind(columns[n][row]);
+			if (it == valueIndex[n].constEnd())
+			{
+				it = valueIndex[n].insert(columns[n][row], facets.values[n].size());
+				facets.values[n].append(columns[n][row]);
+				facets.firstUsers[n].append(userIds[row]);
+			}
+			facets.runValues[n][row] = it.value();
+		}
+
+		if (runNumbers[row] < facets.firstRunNumber) facets.firstRunNumber = runNumbers[row];
+		if (runNumbers[row] > facets.lastRunNumber) facets.lastRunNumber = runNumbers[row];
+		if (startEpochs[row] < facets.earliestStart) facets.earliestStart = startEpochs[row];
+		if (endEpochs[row] > facets.latestEnd) facets.latestEnd = endEpochs[row];
+	}
+}
+
+// Remove facets of specified journal
+void FacetIndex::removeJournal(Journal* jrnl)
+{
+	journals_.remove(jrnl);
+	for (int n=0; n<nFacets; ++n) valueMaps_[n].remove(jrnl);
+}
+
+// Remove facets of all journals of specified instrument
+void FacetIndex::removeInstrument(Instrument* inst)
+{
+	for (Journal* jrnl = inst->journals(); jrnl != NULL; jrnl = jrnl->next) removeJournal(jrnl);
+}
+
+/*
+ * Merged Facets
+ */
+
+// Merge facets of the specified journals, in order, indexing any not yet indexed
+void FacetIndex::merge(const QVector<Journal*>& journals)
+{
+	QHash<int,int> valueIndex[nFacets];
+	for (int n=0; n<nFacets; ++n)
+	{
+		values_[n].clear();
+		firstUsers_[n].clear();
+		valueMaps_[n].clear();
+	}
+	hasRuns_ = false;
+	firstRunNumber_ = 0;
+	lastRunNumber_ = 0;
+	earliestStart_ = 0;
+	latestEnd_ = 0;
+
+	foreach (Journal* jrnl, journals)
+	{
+		if (!journals_.contains(jrnl)) addJournal(jrnl);
+		const JournalFacets& facets = journals_[jrnl];
+
+		// Map the journal's values onto the merged values
+		for (int n=0; n<nFacets; ++n)
+		{
+			QVector<int>& valueMap = valueMaps_[n][jrnl];
+			valueMap.resize(facets.values[n].size());
+			for (int i=0; i<facets.values[n].size(); ++i)
+			{
+				QHash<int,int>::const_iterator it = valueIndex[n].constFind(facets.values[n].at(i));
+				if (it == valueIndex[n].constEnd())
+				{
+					it = valueIndex[n].insert(facets.values[n].at(i), values_[n].size());
+					values_[n].append(facets.values[n].at(i));
+					firstUsers_[n].append(facets.firstUsers[n].at(i));
+				}
+				valueMap[i] = it.value();
+			}
+		}
+
+		// Update limits
+		if (facets.runValues[0].isEmpty()) continue;
+		if ((!hasRuns_) || (facets.firstRunNumber < firstRunNumber_)) firstRunNumber_ = facets.firstRunNumber;
+		if ((!hasRuns_) || (facets.lastRunNumber > lastRunNumber_)) lastRunNumber_ = facets.lastRunNumber;
+		if ((!hasRuns_) || (facets.earliestStart < earliestStart_)) earliestStart_ = facets.earliestStart;
+		if ((!hasRuns_) || (facets.latestEnd > latestEnd_)) latestEnd_ = facets.latestEnd;
+		hasRuns_ = true;
+	}
+
+	// The user filter matches any user whose name contains its text (ignoring case), so find the users each would match if selected
+	int nUsers = values_[UserFacet].size();
+	QVector<QString> users(nUsers);
+	for (int n=0; n<nUsers; ++n) users[n] = RunCatalogue::string(values_[UserFacet].at(n));
+	userFilterMatches_.clear();
+	userFilterMatches_.resize(nUsers);
+	for (int n=0; n<nUsers; ++n)
+	{
+		for (int i=0; i<nUsers; ++i) if ((i == n) || ((users.at(i).length() <= users.at(n).length()) && users.at(n).contains(users.at(i), Qt::CaseInsensitive))) userFilterMatches_[n].append(i);
+	}
+
+	resetCounts();
+}
+
+// Return number of distinct values of facet
+int FacetIndex::nValues(FacetIndex::Facet facet) const
+{
+	return values_[facet].size();
+}
+
+// Return specified value of facet
+int FacetIndex::value(FacetIndex::Facet facet, int index) const
+{
+	return values_[facet].at(index);
+}
+
+// Return user string id of first run with specified value of facet
+int FacetIndex::firstUser(FacetIndex::Facet facet, int index) const
+{
+	return firstUsers_[facet].at(index);
+}
+
+// Return whether there are any runs in the merged journals
+bool FacetIndex::hasRuns() const
+{
+	return hasRuns_;
+}
+
+// Return run number limits of the merged journals
+int FacetIndex::firstRunNumber() const
+{
+	return firstRunNumber_;
+}
+
+int FacetIndex::lastRunNumber() const
+{
+	return lastRunNumber_;
+}
+
+// Return earliest start time and latest end time of the merged journals (seconds since epoch)
+qint64 FacetIndex::earliestStart() const
+{
+	return earliestStart_;
+}
+
+qint64 FacetIndex::latestEnd() const
+{
+	return latestEnd_;
+}
+
+/*
+ * Counts
+ */
+
+// Reset counts of all facet values
+void FacetIndex::resetCounts()
+{
+	for (int n=0; n<nFacets; ++n)
+	{
+		nRuns_[n].fill(0, values_[n].size());
+		protonCharge_[n].fill(0.0, values_[n].size());
+		totalRuns_[n] = 0;
+		totalProtonCharge_[n] = 0.0;
+	}
+}
+
+// Add runs of the journal which are set in the bitset to the counts of their facet values
+// Runs are added to the counts of every user whose selection as the user filter would match them
+void FacetIndex::count(FacetIndex::Facet facet, Journal* jrnl, const QBitArray& runs)
+{
+	// Only journals which have been merged can be counted
+	QHash<Journal*, QVector<int> >::const_iterator valueMap = valueMaps_[facet].constFind(jrnl);
+	if (valueMap == valueMaps_[facet].constEnd()) return;
+	const QVector<int>& runValues = journals_[jrnl].runValues[facet];
+	const double* protonCharges = jrnl->catalogue()->protonCharges();
+
+	int index, nRows = qMin(runs.size(), runValues.size());
+	for (int row = 0; row < nRows; ++row)
+	{
+		if (!runs.testBit(row)) continue;
+
+		index = valueMap.value().at(runValues.at(row));
+		++totalRuns_[facet];
+		totalProtonCharge_[facet] += protonCharges[row];
+		if (facet != UserFacet)
+		{
+			++nRuns_[facet][index];
+			protonCharge_[facet][index] += protonCharges[row];
+			continue;
+		}
+
+		const QVector<int>& matches = userFilterMatches_.at(index);
+		for (int n=0; n<matches.count(); ++n)
+		{
+			++nRuns_[facet][matches.at(n)];
+			protonCharge_[facet][matches.at(n)] += protonCharges[row];
+		}
+	}
+}
+
+// Return number of counted runs with specified value of facet
+int FacetIndex::nRuns(FacetIndex::Facet facet, int index) const
+{
+	return nRuns_[facet].at(index);
+}
+
+// Return total proton charge of counted runs with specified value of facet
+double FacetIndex::protonCharge(FacetIndex::Facet facet, int index) const
+{
+	return protonCharge_[facet].at(index);
+}
+
+// Return total number of runs counted for facet
+int FacetIndex::totalRuns(FacetIndex::Facet facet) const
+{
+	return totalRuns_[facet];
+}
+
+// Return total proton charge of runs counted for facet
+double FacetIndex::totalProtonCharge(FacetIndex::Facet facet) const
+{
+	return totalProtonCharge_[facet];
+}
+
+// Return estimated memory used by the index (bytes)
+qint64 FacetIndex::memoryUsage() const
+{
+	qint64 bytes = sizeof(FacetIndex);
+	bytes += journals_.capacity() * sizeof(void*) + journals_.size() * (sizeof(Journal*) + sizeof(JournalFacets) + 2*sizeof(void*));
+	for (QHash<Journal*,JournalFacets>::const_iterator it = journals_.constBegin(); it != journals_.constEnd(); ++it)
+	{
+		for (int n=0; n<nFacets; ++n) bytes += (it.value().values[n].capacity() + it.value().firstUsers[n].capacity() + it.value().runValues[n].capacity()) * sizeof(int);
+	}
+	for (int n=0; n<nFacets; ++n)
+	{
+		bytes += (values_[n].capacity() + firstUsers_[n].capacity() + nRuns_[n].capacity()) * sizeof(int) + protonCharge_[n].capacity() * sizeof(double);
+		for (QHash<Journal*, QVector<int> >::const_iterator it = valueMaps_[n].constBegin(); it != valueMaps_[n].constEnd(); ++it) bytes += sizeof(Journal*) + 2*sizeof(void*) + it.value().capacity() * sizeof(int);
+	}
+	bytes += userFilterMatches_.capacity() * sizeof(QVector<int>);
+	for (int n=0; n<userFilterMatches_.count(); ++n) bytes += userFilterMatches_.at(n).capacity() * sizeof(int);
+	return bytes;
+}
@@ -0,0 +1,145 @@
+/*
+	*** Facet Index
+	*** src/facetindex.h
+	Copyright T. Youngs 2012-2016
+
+	This file is part of JournalViewer.
+
+	JournalViewer is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	JournalViewer is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with JournalViewer.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef JOURNALVIEWER_FACETINDEX_H
+#define JOURNALVIEWER_FACETINDEX_H
+
+#include <QVector>
+#include <QHash>
+#include <QBitArray>
+
+// Forward Declarations
+class Instrument;
+class Journal;
+
+/*
+ * Index of the distinct users, RB numbers and cycles (facets) of the runs in each journal, with the facet value of every run.
+ * Journals are (re)indexed once they have finished loading, and the facets of those being displayed are merged to give the values
+ * available for filtering, along with the number of runs and total proton charge of each value over the runs passing the filters.
+ * Since the user filter matches any user whose name contains the text, the count for a user includes the runs of all users whose names contain theirs.
+ */
+class FacetIndex
+{
+	public:
+	// Constructor
+	FacetIndex();
+	// Facets
+	enum Facet { UserFacet, RBFacet, CycleFacet, nFacets };
+
+
+	/*
+	 * Journal Facets
+	 */
+	private:
+	// Facets of a journal
+	struct JournalFacets
+	{
+		// Distinct values (user string ids, RB numbers or cycle indices) of each facet, in order of first appearance
+		QVector<int> values[nFacets];
+		// User string id of the first run with each value
+		QVector<int> firstUsers[nFacets];
+		// Index in values of the value of each run
+		QVector<int> runValues[nFacets];
+		// Run number limits
+		int firstRunNumber, lastRunNumber;
+		// Earliest start time and latest end time (seconds since epoch)
+		qint64 earliestStart, latestEnd;
+	};
+	// Facets of each indexed journal
+	QHash<Journal*,JournalFacets> journals_;
+
+	public:
+	// Clear index
+	void clear();
+	// Add (or re-add) facets of specified journal
+	void addJournal(Journal* jrnl);
+	// Remove facets of specified journal
+	void removeJournal(Journal* jrnl);
+	// Remove facets of all journals of specified instrument
+	void removeInstrument(Instrument* inst);
+
+
+	/*
+	 * Merged Facets
+	 */
+	private:
+	// Distinct values of each facet over the merged journals, in order of first appearance
+	QVector<int> values_[nFacets];
+	// User string id of the first run with each merged value
+	QVector<int> firstUsers_[nFacets];
+	// Index in values_ of each value of the merged journals' facets
+	QHash<Journal*, QVector<int> > valueMaps_[nFacets];
+	// Indices of the merged users which, used as the user filter, would match each merged user (itself, and those whose names its name contains)
+	QVector< QVector<int> > userFilterMatches_;
+	// Number of runs with each merged value, counted over runs passing the filters
+	QVector<int> nRuns_[nFacets];
+	// Total proton charge of runs with each merged value, counted over runs passing the filters
+	QVector<double> protonCharge_[nFacets];
+	// Total number of runs and proton charge counted for each facet
+	int totalRuns_[nFacets];
+	double totalProtonCharge_[nFacets];
+	// Whether there are any runs in the merged journals
+	bool hasRuns_;
+	// Run number limits of the merged journals
+	int firstRunNumber_, lastRunNumber_;
+	// Earliest start time and latest end time of the merged journals (seconds since epoch)
+	qint64 earliestStart_, latestEnd_;
+
+	public:
+	// Merge facets of the specified journals, in order, indexing any not yet indexed
+	void merge(const QVector<Journal*>& journals);
+	// Return number of distinct values of facet
+	int nValues(Facet facet) const;
+	// Return specified value of facet
+	int value(Facet facet, int index) const;
+	// Return user string id of first run with specified value of facet
+	int firstUser(Facet facet, int index) const;
+	// Return whether there are any runs in the merged journals
+	bool hasRuns() const;
+	// Return run number limits of the merged journals
+	int firstRunNumber() const;
+	int lastRunNumber() const;
+	// Return earliest start time and latest end time of the merged journals (seconds since epoch)
+	qint64 earliestStart() const;
+	qint64 latestEnd() const;
+
+
+	/*
+	 * Counts
+	 */
+	public:
+	// Reset counts of all facet values
+	void resetCounts();
+	// Add runs of the journal which are set in the bitset to the counts of their facet values
+	void count(Facet facet, Journal* jrnl, const QBitArray& runs);
+	// Return number of counted runs with specified value of facet
+	int nRuns(Facet facet, int index) const;
+	// Return total proton charge of counted runs with specified value of facet
+	double protonCharge(Facet facet, int index) const;
+	// Return total number of runs counted for facet
+	int totalRuns(Facet facet) const;
+	// Return total proton charge of runs counted for facet
+	double totalProtonCharge(Facet facet) const;
+	// Return estimated memory used by the index (bytes)
+	qint64 memoryUsage() const;
+};
+
+#endif
@@ -23,6 +23,7 @@
 #define JOURNALVIEWER_FINDWINDOW_H
 
 #include "ui_findwindow.h"
+#include <QTimer>
 
 // Forward Declarations
 class JournalViewer;
@@ -48,6 +49,8 @@ class FindWindow : public QDialog
 	private:
 	// Whether window is currently refreshing
 	bool refreshing_;
+	// Timer delaying the Find until typing pauses
+	QTimer findTimer_;
 
 	public:
 	// Refresh window
@@ -72,6 +75,10 @@ class FindWindow : public QDialog
 	void on_NextButton_clicked(bool checked);
 	// Previous button clicked
 	void on_PreviousButton_clicked(bool checked);
+	// Start Find with current settings
+	void startFind();
+	// Find has finished
+	void findFinished(int nMatches);
 };
 
 #endif
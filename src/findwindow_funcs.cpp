@@ -27,6 +27,14 @@ FindWindow::FindWindow(JournalViewer& parent) : QDialog(&parent), jvParent_(pare
 {
 	// Call the main creation function
 	ui.setupUi(this);
+
+	refreshing_ = false;
+
+	// Setup QTimer for starting the Find once typing pauses, and receive results when it has finished
+	connect(&findTimer_, SIGNAL(timeout()), this, SLOT(startFind()));
+	findTimer_.setSingleShot(true);
+	findTimer_.setInterval(250);
+	connect(&jvParent_, SIGNAL(findFinished(int)), this, SLOT(findFinished(int)));
 }
 
 // Destructor
@@ -50,11 +58,9 @@ bool FindWindow::refresh()
 // Search text changed
 void FindWindow::on_TextEdit_textChanged(QString text)
 {
-	int n = jvParent_.find(text, (JournalViewer::SearchStyle) ui.SearchStyleCombo->currentIndex(), ui.CaseSensitiveCheck->isChecked());
-
-	jvParent_.findNext();
-
-	refresh();
+	// Abandon any Find for the previous text, and start again once typing pauses
+	jvParent_.cancelFind();
+	findTimer_.start();
 }
 
 // Text edit return pressed
@@ -66,21 +72,13 @@ void FindWindow::on_TextEdit_returnPressed()
 // Search style changed
 void FindWindow::on_SearchStyleCombo_currentIndexChanged(int index)
 {
-	int n = jvParent_.find(ui.TextEdit->text(), (JournalViewer::SearchStyle) ui.SearchStyleCombo->currentIndex(), ui.CaseSensitiveCheck->isChecked());
-
-	jvParent_.findNext();
-
-	refresh();
+	startFind();
 }
 
 // Case sensitivity changed
 void FindWindow::on_CaseSensitiveCheck_clicked(bool checked)
 {
-	int n = jvParent_.find(ui.TextEdit->text(), (JournalViewer::SearchStyle) ui.SearchStyleCombo->currentIndex(), ui.CaseSensitiveCheck->isChecked());
-
-	jvParent_.findNext();
-
-	refresh();
+	startFind();
 }
 
 // Search clear button pressed
@@ -102,3 +100,18 @@ void FindWindow::on_PreviousButton_clicked(bool checked)
 {
 	jvParent_.findPrevious();
 }
+
+// Start Find with current settings
+void FindWindow::startFind()
+{
+	findTimer_.stop();
+	jvParent_.startFind(ui.TextEdit->text(), (JournalViewer::SearchStyle) ui.SearchStyleCombo->currentIndex(), ui.CaseSensitiveCheck->isChecked());
+}
+
+// Find has finished
+void FindWindow::findFinished(int nMatches)
+{
+	jvParent_.findNext();
+
+	refresh();
+}
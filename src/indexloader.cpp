@@ -0,0 +1,135 @@
+/*
+	*** Index Loader
+	*** src/indexloader.cpp
+	Copyright T. Youngs 2012-2016
+
+	This file is part of JournalViewer.
+
+	JournalViewer is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	JournalViewer is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with JournalViewer.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "indexloader.h"
+#include "datainterface.h"
+#include "instrument.h"
+#include "messenger.hui"
+
+// Constructor
+IndexLoader::IndexLoader(JournalViewer* parent, Instrument* inst, JournalViewer::JournalAccess accessType, const char* finishedSlot, DataInterface* dataInterface) : QRunnable()
+{
+	parent_ = parent;
+	instrument_ = inst;
+	accessType_ = accessType;
+	dataInterface_ = dataInterface;
+	finishedSlot_ = finishedSlot;
+
+	// The thread pool deletes the loader once it has run, so nothing must refer to it after it has been started
+	setAutoDelete(true);
+}
+
+/*
+ * Source Data
+ */
+
+// Load data from net into QByteArray
+bool IndexLoader::readHttp(QUrl location, QByteArray& data)
+{
+	if (dataInterface_) return dataInterface_->readHttp(location, data);
+	else return DataInterface::fetchHttp(location, data);
+}
+
+// Get modification time from HTTP header
+bool IndexLoader::readHttpModificationTime(QUrl location, QDateTime& modificationTime)
+{
+	if (dataInterface_) return dataInterface_->readHttpModificationTime(location, modificationTime);
+	else return DataInterface::fetchHttpModificationTime(location, modificationTime);
+}
+
+// Return target Instrument
+Instrument* IndexLoader::instrument()
+{
+	return instrument_;
+}
+
+/*
+ * Execution
+ */
+
+// Probe and retrieve the index, returning the result
+IndexLoadResult IndexLoader::load()
+{
+	IndexLoadResult result(instrument_);
+	JournalViewer::JournalAccess sourceType;
+	QString instrumentText = " for instrument " + instrument_->capitalisedName();
+
+	if (!DataInterface::mostRecent(accessType_, instrument_->indexLocalFile(), instrument_->indexHttpFile(), result.modificationTime_, sourceType, dataInterface_))
+	{
+		result.message_ = "Failed to load journal index file" + instrumentText;
+	}
+	else if (sourceType == JournalViewer::NoAccess)
+	{
+		result.message_ = "No source available for index file" + instrumentText;
+	}
+	else if (result.modificationTime_ == instrument_->indexModificationTime())
+	{
+		result.result_ = true;
+		result.upToDate_ = true;
+		result.message_ = "Index file is up to date" + instrumentText;
+	}
+	else if (sourceType == JournalViewer::DiskOnlyAccess)
+	{
+		// Local copy is newer (somehow) so load it in
+		result.result_ = DataInterface::readFile(instrument_->indexLocalFile(), result.data_);
+
+		// Did we succeed?
+		if (result.result_) result.message_ = "Updated index loaded from disk" + instrumentText;
+		else if (accessType_ == JournalViewer::DiskAndNetAccess)
+		{
+			// Failed to load local copy - we can update it from the net, since the access type permits it
+			result.result_ = readHttp(instrument_->indexHttpFile(), result.data_);
+
+			// Check overall success of reading local copy
+			if (result.result_)
+			{
+				result.message_ = "Updated index loaded from net (failed to read local copy)" + instrumentText;
+				if (readHttpModificationTime(instrument_->indexHttpFile(), result.modificationTime_)) result.saveLocalCopy_ = true;
+			}
+			else result.message_ = "Failed to load index" + instrumentText + " from both local disk and net.";
+		}
+	}
+	else if (sourceType == JournalViewer::NetOnlyAccess)
+	{
+		// Net copy is newer
+		result.result_ = readHttp(instrument_->indexHttpFile(), result.data_);
+
+		// Check overall success of reading net copy
+		if (result.result_)
+		{
+			result.message_ = "Updated index loaded from net" + instrumentText;
+
+			// Save local copy, if access type permits
+			result.saveLocalCopy_ = (accessType_ == JournalViewer::DiskAndNetAccess);
+		}
+		else result.message_ = "Failed to load index" + instrumentText + " from net.";
+	}
+	msg.print(result.message_);
+
+	return result;
+}
+
+// Load the index, and pass the result to the parent
+void IndexLoader::run()
+{
+	// The result is copied into the queued call, so the parent never touches the loader itself
+	QMetaObject::invokeMethod(parent_, finishedSlot_, Qt::QueuedConnection, Q_ARG(IndexLoadResult, load()));
+}
@@ -0,0 +1,85 @@
+/*
+	*** Index Loader
+	*** src/indexloader.h
+	Copyright T. Youngs 2012-2016
+
+	This file is part of JournalViewer.
+
+	JournalViewer is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	JournalViewer is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with JournalViewer.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef JOURNALVIEWER_INDEXLOADER_H
+#define JOURNALVIEWER_INDEXLOADER_H
+
+#include "jv.h"
+#include "indexloadresult.h"
+#include <QRunnable>
+#include <QByteArray>
+#include <QDateTime>
+
+// Forward Declarations
+class Instrument;
+class DataInterface;
+
+/*
+ * Journal Index Loader
+ * When run by a thread pool the loader is deleted once it has run, its result being passed by value to the named slot of the parent
+ * JournalViewer, which must take an IndexLoadResult. It may also be created on the stack and load() called directly.
+ */
+class IndexLoader : public QRunnable
+{
+	public:
+	// Constructor
+	IndexLoader(JournalViewer* parent, Instrument* inst, JournalViewer::JournalAccess accessType, const char* finishedSlot, DataInterface* dataInterface = NULL);
+
+
+	/*
+	 * Source Data
+	 */
+	private:
+	// Parent JournalViewer
+	JournalViewer* parent_;
+	// Target Instrument
+	Instrument* instrument_;
+	// Permitted access type
+	JournalViewer::JournalAccess accessType_;
+	// DataInterface to use for http requests (if NULL, requests are made without progress indication)
+	DataInterface* dataInterface_;
+
+	private:
+	// Load data from net into QByteArray
+	bool readHttp(QUrl location, QByteArray& data);
+	// Get modification time from HTTP header
+	bool readHttpModificationTime(QUrl location, QDateTime& modificationTime);
+
+	public:
+	// Return target Instrument
+	Instrument* instrument();
+
+
+	/*
+	 * Execution
+	 */
+	private:
+	// Name of parent's slot to call with the result (when run by a thread pool)
+	const char* finishedSlot_;
+
+	public:
+	// Probe and retrieve the index, returning the result
+	IndexLoadResult load();
+	// Load the index, and pass the result to the parent
+	void run();
+};
+
+#endif
@@ -0,0 +1,73 @@
+/*
+	*** Index Load Result
+	*** src/indexloadresult.cpp
+	Copyright T. Youngs 2012-2016
+
+	This file is part of JournalViewer.
+
+	JournalViewer is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	JournalViewer is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with JournalViewer.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "indexloadresult.h"
+
+// Constructor
+IndexLoadResult::IndexLoadResult(Instrument* inst)
+{
+	instrument_ = inst;
+	result_ = false;
+	upToDate_ = false;
+	saveLocalCopy_ = false;
+}
+
+// Return target Instrument
+Instrument* IndexLoadResult::instrument() const
+{
+	return instrument_;
+}
+
+// Return whether the index was retrieved successfully
+bool IndexLoadResult::result() const
+{
+	return result_;
+}
+
+// Return whether the current index was already up to date
+bool IndexLoadResult::upToDate() const
+{
+	return upToDate_;
+}
+
+// Return modification time of the source the index was retrieved from
+QDateTime IndexLoadResult::modificationTime() const
+{
+	return modificationTime_;
+}
+
+// Return retrieved index data
+const QByteArray& IndexLoadResult::data() const
+{
+	return data_;
+}
+
+// Return whether the retrieved data should be saved as the local copy of the index
+bool IndexLoadResult::saveLocalCopy() const
+{
+	return saveLocalCopy_;
+}
+
+// Return status message describing the result
+QString IndexLoadResult::message() const
+{
+	return message_;
+}
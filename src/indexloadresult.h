@@ -0,0 +1,80 @@
+/*
+	*** Index Load Result
+	*** src/indexloadresult.h
+	Copyright T. Youngs 2012-2016
+
+	This file is part of JournalViewer.
+
+	JournalViewer is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	JournalViewer is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with JournalViewer.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef JOURNALVIEWER_INDEXLOADRESULT_H
+#define JOURNALVIEWER_INDEXLOADRESULT_H
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QString>
+#include <QMetaType>
+
+// Forward Declarations
+class Instrument;
+
+/*
+ * Result of loading a journal index.
+ * Loaders are deleted by their thread pool once they have run, so the result is passed by value to a slot of the receiver.
+ */
+class IndexLoadResult
+{
+	public:
+	// Constructor
+	IndexLoadResult(Instrument* inst = NULL);
+
+	private:
+	// Target Instrument
+	Instrument* instrument_;
+	// Whether the index was retrieved successfully
+	bool result_;
+	// Whether the current index was already up to date
+	bool upToDate_;
+	// Modification time of the source the index was retrieved from
+	QDateTime modificationTime_;
+	// Retrieved index data (to be parsed in the GUI thread)
+	QByteArray data_;
+	// Whether the retrieved data should be saved as the local copy of the index
+	bool saveLocalCopy_;
+	// Status message describing the result
+	QString message_;
+	// Loaders fill in their own results
+	friend class IndexLoader;
+
+	public:
+	// Return target Instrument
+	Instrument* instrument() const;
+	// Return whether the index was retrieved successfully
+	bool result() const;
+	// Return whether the current index was already up to date
+	bool upToDate() const;
+	// Return modification time of the source the index was retrieved from
+	QDateTime modificationTime() const;
+	// Return retrieved index data
+	const QByteArray& data() const;
+	// Return whether the retrieved data should be saved as the local copy of the index
+	bool saveLocalCopy() const;
+	// Return status message describing the result
+	QString message() const;
+};
+
+Q_DECLARE_METATYPE(IndexLoadResult)
+
+#endif
@@ -384,6 +384,18 @@ QDateTime Instrument::indexModificationTime()
 	return indexModificationTime_;
 }
 
+// Set time at which index was last checked against its source
+void Instrument::setIndexCheckTime(QDateTime checkTime)
+{
+	indexCheckTime_ = checkTime;
+}
+
+// Return time at which index was last checked against its source
+QDateTime Instrument::indexCheckTime()
+{
+	return indexCheckTime_;
+}
+
 /*
  * Information (block values)
 */
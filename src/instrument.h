@@ -131,6 +131,8 @@ class Instrument : public ListItem<Instrument>
 	List<Journal> journals_;
 	// Modification time for index file
 	QDateTime indexModificationTime_;
+	// Time at which index was last checked against its source
+	QDateTime indexCheckTime_;
 
 	public:
 	// Set instrument
@@ -177,6 +179,10 @@ class Instrument : public ListItem<Instrument>
 	void setIndexModificationTime(QDateTime modTime);
 	// Return modification time for index file
 	QDateTime indexModificationTime();
+	// Set time at which index was last checked against its source
+	void setIndexCheckTime(QDateTime checkTime);
+	// Return time at which index was last checked against its source
+	QDateTime indexCheckTime();
 
 
 	/*
@@ -0,0 +1,172 @@
+/*
+	*** Run Interval Index
+	*** src/intervalindex.cpp
+	Copyright T. Youngs 2012-2016
+
+	This file is part of JournalViewer.
+
+	JournalViewer is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	JournalViewer is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with JournalViewer.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "intervalindex.h"
+#include "journal.h"
+#include "instrument.h"
+#include "rundata.h"
+#include "isis.h"
+#include <algorithm>
+
+// Constructor
+IntervalIndex::IntervalIndex()
+{
+	nIntervals_ = 0;
+	treeValid_ = true;
+}
+
+/*
+ * Intervals
+ */
+
+// Clear index
+void IntervalIndex::clear()
+{
+	journalIntervals_.clear();
+	nIntervals_ = 0;
+	intervals_.clear();
+	maxEnd_.clear();
+	treeValid_ = true;
+}
+
+// Add (or re-add) RunData of specified journal to the index
+void IntervalIndex::addJournal(Journal* jrnl)
+{
+	removeJournal(jrnl);
+	if (jrnl->runData().nItems() == 0) return;
+
+	const qint64* startEpochs = jrnl->catalogue()->startEpochs();
+	const qint64* endEpochs = jrnl->catalogue()->endEpochs();
+	QVector<Interval>& intervals = journalIntervals_[jrnl];
+	intervals.reserve(jrnl->runData().nItems());
+	Interval interval;
+	for (RunData* rd = jrnl->runData().first(); rd != NULL; rd = rd->next)
+	{
+		// Runs without a valid start time can't be placed - those without a valid end time (e.g. still running) are assumed to end after their duration
+		interval.start = startEpochs[rd->row()];
+		if (interval.start == ISIS::invalidTime) continue;
+		interval.end = endEpochs[rd->row()];
+		if ((interval.end == ISIS::invalidTime) || (interval.end < interval.start)) interval.end = interval.start + qMax(rd->duration(), 0);
+		interval.runData = rd;
+		intervals << interval;
+	}
+	nIntervals_ += intervals.count();
+
+	treeValid_ = false;
+}
+
+// Remove RunData of specified journal from the index
+void IntervalIndex::removeJournal(Journal* jrnl)
+{
+	QHash<Journal*, QVector<Interval> >::iterator it = journalIntervals_.find(jrnl);
+	if (it == journalIntervals_.end()) return;
+
+	nIntervals_ -= it.value().count();
+	journalIntervals_.erase(it);
+
+	treeValid_ = false;
+}
+
+// Remove RunData of all journals of specified instrument from the index
+void IntervalIndex::removeInstrument(Instrument* inst)
+{
+	for (Journal* jrnl = inst->journals(); jrnl != NULL; jrnl = jrnl->next) removeJournal(jrnl);
+}
+
+// Return number of indexed runs
+int IntervalIndex::nRuns() const
+{
+	return nIntervals_;
+}
+
+/*
+ * Tree
+ */
+
+// Regenerate tree from the indexed intervals
+void IntervalIndex::buildTree() const
+{
+	intervals_.clear();
+	intervals_.reserve(nIntervals_);
+	for (QHash<Journal*, QVector<Interval> >::const_iterator it = journalIntervals_.constBegin(); it != journalIntervals_.constEnd(); ++it) intervals_ += it.value();
+	std::stable_sort(intervals_.begin(), intervals_.end(), [](const Interval& a, const Interval& b) { return a.start < b.start; });
+
+	maxEnd_.resize(intervals_.count());
+	setMaxEnd(0, intervals_.count());
+
+	treeValid_ = true;
+}
+
+// Set latest end times of the subtree over the specified range of intervals_, returning the latest
+qint64 IntervalIndex::setMaxEnd(int first, int last) const
+{
+	if (first >= last) return ISIS::invalidTime;
+
+	int root = (first + last) / 2;
+	maxEnd_[root] = qMax(intervals_.at(root).end, qMax(setMaxEnd(first, root), setMaxEnd(root+1, last)));
+	return maxEnd_.at(root);
+}
+
+// Add runs overlapping the (inclusive) time range from the subtree over the specified range of intervals_, in order of start time
+void IntervalIndex::findOverlapping(int first, int last, qint64 fromTime, qint64 toTime, QVector<RunData*>& result) const
+{
+	if (first >= last) return;
+
+	// If nothing in this subtree ends after the start of the range, none of it can overlap
+	int root = (first + last) / 2;
+	if (maxEnd_.at(root) < fromTime) return;
+
+	findOverlapping(first, root, fromTime, toTime, result);
+
+	// The root and everything to its right start at or after the root's start time, so if that is after the end of the range we're done
+	if (intervals_.at(root).start > toTime) return;
+	if (intervals_.at(root).end >= fromTime) result << intervals_.at(root).runData;
+
+	findOverlapping(root+1, last, fromTime, toTime, result);
+}
+
+// Return runs in progress at the specified time (seconds since epoch), in order of start time
+QVector<RunData*> IntervalIndex::running(qint64 time) const
+{
+	return overlapping(time, time);
+}
+
+// Return runs overlapping the (inclusive) time range (seconds since epoch), in order of start time
+QVector<RunData*> IntervalIndex::overlapping(qint64 fromTime, qint64 toTime) const
+{
+	QVector<RunData*> result;
+	if (fromTime > toTime) return result;
+
+	if (!treeValid_) buildTree();
+	findOverlapping(0, intervals_.count(), fromTime, toTime, result);
+
+	return result;
+}
+
+// Return estimated memory used by the index (bytes)
+qint64 IntervalIndex::memoryUsage() const
+{
+	qint64 bytes = sizeof(IntervalIndex);
+	bytes += journalIntervals_.capacity() * sizeof(void*) + journalIntervals_.size() * (sizeof(Journal*) + sizeof(QVector<Interval>) + 2*sizeof(void*));
+	for (QHash<Journal*, QVector<Interval> >::const_iterator it = journalIntervals_.constBegin(); it != journalIntervals_.constEnd(); ++it) bytes += it.value().capacity() * sizeof(Interval);
+	bytes += intervals_.capacity() * sizeof(Interval) + maxEnd_.capacity() * sizeof(qint64);
+	return bytes;
+}
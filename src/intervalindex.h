@@ -0,0 +1,105 @@
+/*
+	*** Run Interval Index
+	*** src/intervalindex.h
+	Copyright T. Youngs 2012-2016
+
+	This file is part of JournalViewer.
+
+	JournalViewer is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	JournalViewer is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with JournalViewer.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef JOURNALVIEWER_INTERVALINDEX_H
+#define JOURNALVIEWER_INTERVALINDEX_H
+
+#include <QHash>
+#include <QVector>
+
+// Forward Declarations
+class Instrument;
+class Journal;
+class RunData;
+
+/*
+ * Index of the (start, end) times of loaded runs from all journals of all instruments, answering which runs were in progress at a
+ * given time, or overlapped a given time range. Intervals are kept sorted by start time, and treated as an implicit balanced binary
+ * tree (the root of each range being its middle element) augmented with the latest end time within each subtree, so that queries
+ * visit O(log n) nodes plus those which overlap. The tree is rebuilt when first queried after journals are added or removed.
+ * Journals are (re)indexed once they have finished loading, and must be removed from the index before their RunData are changed or deleted.
+ */
+class IntervalIndex
+{
+	public:
+	// Constructor
+	IntervalIndex();
+
+
+	/*
+	 * Intervals
+	 */
+	private:
+	// Run interval
+	struct Interval
+	{
+		// Start and end times of the run (seconds since epoch)
+		qint64 start, end;
+		// Run data
+		RunData* runData;
+	};
+	// Intervals of the runs indexed from each journal
+	QHash<Journal*, QVector<Interval> > journalIntervals_;
+	// Number of indexed intervals
+	int nIntervals_;
+
+	public:
+	// Clear index
+	void clear();
+	// Add (or re-add) RunData of specified journal to the index
+	void addJournal(Journal* jrnl);
+	// Remove RunData of specified journal from the index
+	void removeJournal(Journal* jrnl);
+	// Remove RunData of all journals of specified instrument from the index
+	void removeInstrument(Instrument* inst);
+	// Return number of indexed runs
+	int nRuns() const;
+
+
+	/*
+	 * Tree
+	 */
+	private:
+	// All indexed intervals, sorted by start time (regenerated when needed)
+	mutable QVector<Interval> intervals_;
+	// Latest end time of the intervals in the subtree rooted at each element of intervals_
+	mutable QVector<qint64> maxEnd_;
+	// Whether the tree is up to date
+	mutable bool treeValid_;
+
+	private:
+	// Regenerate tree from the indexed intervals
+	void buildTree() const;
+	// Set latest end times of the subtree over the specified range of intervals_, returning the latest
+	qint64 setMaxEnd(int first, int last) const;
+	// Add runs overlapping the (inclusive) time range from the subtree over the specified range of intervals_, in order of start time
+	void findOverlapping(int first, int last, qint64 fromTime, qint64 toTime, QVector<RunData*>& result) const;
+
+	public:
+	// Return runs in progress at the specified time (seconds since epoch), in order of start time
+	QVector<RunData*> running(qint64 time) const;
+	// Return runs overlapping the (inclusive) time range (seconds since epoch), in order of start time
+	QVector<RunData*> overlapping(qint64 fromTime, qint64 toTime) const;
+	// Return estimated memory used by the index (bytes)
+	qint64 memoryUsage() const;
+};
+
+#endif
@@ -22,16 +22,19 @@
 #include "isis.h"
 #include "jv.h"
 #include "instrument.h"
+#include "journalscanner.h"
 #include "messenger.hui"
 #include <QXmlStreamReader>
+#include <QElapsedTimer>
 #include <QTextStream>
 #include <QRegularExpression>
 
 // Static Members
-QStringList ISIS::cycles_;
+StringPool ISIS::cycles_;
 JournalViewer* ISIS::parent_ = NULL;
-QDateTime ISIS::startTime_;
-QDateTime ISIS::endTime_;
+const qint64 ISIS::invalidTime;
+qint64 ISIS::startTime_ = ISIS::invalidTime;
+qint64 ISIS::endTime_ = ISIS::invalidTime;
 QString ISIS::currentBlock_;
 QString ISIS::currentGroup_;
 #ifndef NOHDF
@@ -116,22 +119,16 @@ const ISIS::Location ISIS::location(ISIS::ISISInstrument inst)
  */
 
 // Return cycle index for specified cycle text
-int ISIS::cycleIndex(QString cycleName)
+int ISIS::cycleIndex(const QString& cycleName)
 {
-	int index = cycles_.indexOf(cycleName);
-	if (index == -1)
-	{
-		cycles_ << cycleName;
-		index = cycles_.count()-1;
-	}
-	return index;
+	return cycles_.id(cycleName);
 }
 
-// Return cycle index for specified cycle text
+// Return cycle text for specified cycle index
 QString ISIS::cycleText(int index)
 {
-	if ((index < 0) || (index >= cycles_.count())) return "UNKNOWN";
-	else return cycles_.at(index);
+	if ((index < 0) || (index >= cycles_.nStrings())) return "UNKNOWN";
+	else return cycles_.string(index);
 }
 
 // Locate data file with given extension
@@ -199,6 +196,94 @@ QString ISIS::locateFile(RunData* runData, QString extension, bool useLocalDirec
 	return QString();
 }
 
+/*
+ * Time Conversion
+ */
+
+// Read numeric time field of between minDigits and maxDigits digits, advancing the supplied pointer
+static bool readTimeField(const char*& c, const char* end, int minDigits, int maxDigits, int& value)
+{
+	value = 0;
+	int nDigits = 0;
+	while ((c < end) && (nDigits < maxDigits) && (*c >= '0') && (*c <= '9'))
+	{
+		value = value*10 + (*c - '0');
+		++c;
+		++nDigits;
+	}
+	return (nDigits >= minDigits);
+}
+
+// Convert NXentry / log style local time string (yyyy-MM-ddTHH:mm:ss) to seconds since epoch
+qint64 ISIS::epochSeconds(const char* text, int length)
+{
+	// Read and check fields
+	const char* c = text, *end = text + length;
+	int year = 0, month = 0, day = 0, hour = 0, minute = 0, second = 0;
+	bool valid = readTimeField(c, end, 4, 4, year) && (c < end) && (*c++ == '-');
+	valid = valid && readTimeField(c, end, 1, 2, month) && (c < end) && (*c++ == '-');
+	valid = valid && readTimeField(c, end, 1, 2, day) && (c < end) && (*c++ == 'T');
+	valid = valid && readTimeField(c, end, 1, 2, hour) && (c < end) && (*c++ == ':');
+	valid = valid && readTimeField(c, end, 1, 2, minute) && (c < end) && (*c++ == ':');
+	valid = valid && readTimeField(c, end, 1, 2, second) && (c == end);
+	valid = valid && (year >= 1) && (month >= 1) && (month <= 12) && (hour < 24) && (minute < 60) && (second < 60);
+	static const int daysInMonth[12] = { 31, 29, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+	bool leapYear = ((year%4 == 0) && (year%100 != 0)) || (year%400 == 0);
+	valid = valid && (day >= 1) && (day <= daysInMonth[month-1]) && ((month != 2) || (day < 29) || leapYear);
+
+	qint64 result = invalidTime;
+	if (valid)
+	{
+		// Days since epoch for the civil date (years counted from March, so the leap day comes last)
+		int y = (month <= 2 ? year - 1 : year);
+		int era = y / 400;
+		int yearOfEra = y - era*400;
+		int dayOfYear = (153*(month > 2 ? month-3 : month+9) + 2)/5 + day - 1;
+		int dayOfEra = yearOfEra*365 + yearOfEra/4 - yearOfEra/100 + dayOfYear;
+		qint64 localSeconds = (qint64(era)*146097 + dayOfEra - 719468)*86400 + hour*3600 + minute*60 + second;
+
+		// Times are local, so subtract the UTC offset - this only changes on the hour, so cache it for the last hour seen (per thread, since journals are parsed in parallel)
+		static thread_local qint64 cachedHour = invalidTime;
+		static thread_local int cachedOffset = 0;
+		qint64 localHour = localSeconds / 3600;
+		if (localHour != cachedHour)
+		{
+			cachedOffset = QDateTime(QDate(year, month, day), QTime(hour, 0)).offsetFromUtc();
+			cachedHour = localHour;
+		}
+		result = localSeconds - cachedOffset;
+	}
+
+	return result;
+}
+
+// Convert NXentry / log style local time string (yyyy-MM-ddTHH:mm:ss) to seconds since epoch
+qint64 ISIS::epochSeconds(const QString& text)
+{
+	// Convert to Latin1 on the stack - anything longer than a valid time string, or containing non-ASCII characters, is invalid anyway
+	char buffer[32];
+	int length = text.length();
+	if (length > 31) return invalidTime;
+	for (int n=0; n<length; ++n)
+	{
+		ushort code = text.at(n).unicode();
+		buffer[n] = (code > 127 ? '?' : char(code));
+	}
+	return epochSeconds(buffer, length);
+}
+
+// Convert QDateTime to seconds since epoch
+qint64 ISIS::epochSeconds(const QDateTime& dateTime)
+{
+	return (dateTime.isValid() ? dateTime.toMSecsSinceEpoch() / 1000 : invalidTime);
+}
+
+// Return QDateTime (in local time) for seconds since epoch
+QDateTime ISIS::dateTime(qint64 epochSeconds)
+{
+	return (epochSeconds == invalidTime ? QDateTime() : QDateTime::fromMSecsSinceEpoch(epochSeconds * 1000));
+}
+
 /*
  * Data Parsing
  */
@@ -252,26 +337,42 @@ bool ISIS::parseJournalIndex(Instrument* inst, QByteArray& data)
 	return true;
 }
 
-// Parse journal data from supplied QByteArray
-bool ISIS::parseJournalData(Journal* jrnl, QByteArray& data, bool updateOnly, bool forceISOEncoding)
+// Parse journal entries from specified QByteArray, without modifying the Journal
+bool ISIS::parseJournalEntries(Journal* jrnl, QByteArray& data, JournalEntries& entries, bool forceISOEncoding)
 {
 	// Check pointer and grab the RunData array
 	if (jrnl == NULL)
 	{
-		msg.print("Internal Error: NULL Journal pointer given to ISIS::parseJournalData().\n");
+		msg.print("Internal Error: NULL Journal pointer given to ISIS::parseJournalEntries().\n");
 		return false;
 	}
 	Instrument* inst = jrnl->parent();
-	List<RunData>& targetList = jrnl->runData();
-	
-	RunData* rd, dummyData, *currentSearchPoint = targetList.first(), *oldrd;
+
+	RunData* rd;
 	RunProperty::Property prop;
 	bool userExperiment = false;
 
-	if (forceISOEncoding) data.replace("UTF-8", "iso-8859-1");
+	// Determine byte offset following last complete NXentry (before we modify the data) so we can do delta updates later on
+	int lastEntryOffset = data.lastIndexOf("</NXentry>");
+	if (lastEntryOffset != -1) lastEntryOffset += 10;
+
+	QElapsedTimer timer;
+	timer.start();
 
-	// Clear list if not updating it
-	if (!updateOnly) targetList.clear();
+	// Try the journal scanner first - it works directly on the raw data, but only understands the flat layout journal files should have
+	// New entries are created in the staging catalogue, and moved into the Journal's own catalogue when they are added to it
+	entries.entries().clear();
+	entries.setLastEntryOffset(lastEntryOffset);
+	JournalScanner scanner(data, forceISOEncoding);
+	if (scanner.scan(parent_, jrnl, entries.catalogue(), entries.entries()))
+	{
+		msg.print("Scanned %i bytes of journal data in %lli ms (%i entries).", data.size(), timer.elapsed(), entries.entries().nItems());
+		return true;
+	}
+	entries.entries().clear();
+	msg.print("Journal data has unexpected layout - falling back to full XML parsing.");
+
+	if (forceISOEncoding) data.replace("UTF-8", "iso-8859-1");
 
 	// Create a stream reader
 	QXmlStreamReader stream(data);
@@ -294,7 +395,7 @@ bool ISIS::parseJournalData(Journal* jrnl, QByteArray& data, bool updateOnly, bo
 		if (stream.name() == "NXentry")
 		{
 			// Add a new data entry, and set target instrument
-			rd = new RunData;
+			rd = new RunData(entries.catalogue());
 			if (inst->shortName() == "LOCAL") userExperiment = true;
 			rd->setInstrument(inst);
 			rd->setJournalSource(jrnl);
@@ -344,29 +445,6 @@ bool ISIS::parseJournalData(Journal* jrnl, QByteArray& data, bool updateOnly, bo
 							break;
 						case (RunProperty::RunNumber):
 							rd->setRunNumber(stream.text().toInt());
-							// Now we know the run number, if we are only updating we search the current list to see if it exists already.
-							// If it does, we'll ditch this 'rd' and redirect to the dummy one
-							if (updateOnly)
-							{
-								// Since the run numbers we encounter are highliy likely to be in sequential order, we will do the search in two parts.
-								// 1) From 'currentSearchPoint' to the end of the list
-								// 2) From the beginning of the list to 'currentSearchPoint'
-								for (oldrd = currentSearchPoint; oldrd != NULL; oldrd = oldrd->next) if (oldrd->runNumber() == rd->runNumber()) break;
-								if (oldrd == NULL)
-								{
-									// Second part of search
-									for (oldrd = targetList.first(); oldrd != currentSearchPoint; oldrd = oldrd->next) if (oldrd->runNumber() == rd->runNumber()) break;
-								}
-								// Did we find a match?
-								if (oldrd)
-								{
-									delete rd;
-									rd = &dummyData;
-									currentSearchPoint = oldrd->next;
-								}
-								else targetList.own(rd);
-							}
-							else targetList.own(rd);
 							break;
 						case (RunProperty::StartTimeAndDate):
 							rd->setStartDateTime(stream.text().toString());
@@ -381,13 +459,16 @@ bool ISIS::parseJournalData(Journal* jrnl, QByteArray& data, bool updateOnly, bo
 							rd->setUser(stream.text().toString());
 							break;
 					}
-					
+
 					// Move to next entry
 					stream.readNext();
 				}
 				// Move to next entry
 				stream.readNext();
 			}
+
+			// Add the entry to the list
+			entries.entries().own(rd);
 		}
 	}
 
@@ -400,6 +481,36 @@ bool ISIS::parseJournalData(Journal* jrnl, QByteArray& data, bool updateOnly, bo
 	}
 
 	stream.clear();
+	msg.print("Parsed %i bytes of journal data in %lli ms (%i entries).", data.size(), timer.elapsed(), entries.entries().nItems());
+	return true;
+}
+
+// Parse journal entries from specified fragment (appended to source after the Journal's last complete NXentry), without modifying the Journal
+bool ISIS::parseJournalFragmentEntries(Journal* jrnl, QByteArray& fragment, qint64 fragmentOffset, JournalEntries& entries, bool forceISOEncoding)
+{
+	// The fragment should start with the closing tag of the last NXentry we already have - if not, the source has changed in some other way
+	if (!fragment.startsWith("</NXentry>"))
+	{
+		msg.print("Journal fragment does not follow on from existing data.");
+		return false;
+	}
+	entries.entries().clear();
+	entries.setFragmentOffset(fragmentOffset);
+
+	// Find end of last complete NXentry in the fragment - if there isn't one, there is nothing new to add
+	int lastEntryEnd = fragment.lastIndexOf("</NXentry>") + 10;
+	entries.setLastEntryOffset(fragmentOffset + lastEntryEnd);
+	if (lastEntryEnd == 10) return true;
+
+	// Wrap new entries up into a valid document and parse it
+	QByteArray wrapped = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<NXroot>";
+	wrapped += fragment.mid(10, lastEntryEnd-10);
+	wrapped += "</NXroot>\n";
+	if (!parseJournalEntries(jrnl, wrapped, entries, forceISOEncoding)) return false;
+
+	// Entries' offsets are relative to the source, not the wrapped document
+	entries.setLastEntryOffset(fragmentOffset + lastEntryEnd);
+
 	return true;
 }
 
@@ -517,7 +628,7 @@ bool ISIS::parseLogInformation(RunData* runData, QByteArray& data)
 	QTextStream stream(data);
 	QString line, tempDateTime, tempValue, block;
 	double value;
-	QDateTime dateTime;
+	qint64 dateTime;
 
 	// Parse until end of stream
 	while (!stream.atEnd())
@@ -539,8 +650,8 @@ bool ISIS::parseLogInformation(RunData* runData, QByteArray& data)
 			continue;
 		}
 		
-		// Convert temp string into proper QDateTime
-		dateTime = QDateTime::fromString(tempDateTime, "yyyy-MM-ddTHH:mm:ss");
+		// Convert temp string into time since epoch
+		dateTime = epochSeconds(tempDateTime);
 		
 		// Add datapoint to RunData
 		bool isNumber;
@@ -561,17 +672,17 @@ bool ISIS::parseNexusFile(RunData* runData, QString fileName)
 
 	// Get start/end times
 	QString tempString;
-	if (nexusExtractString(file, "/raw_data_1/start_time", tempString)) startTime_ = QDateTime::fromString(tempString, "yyyy-MM-ddTHH:mm:ss");
+	if (nexusExtractString(file, "/raw_data_1/start_time", tempString)) startTime_ = epochSeconds(tempString);
 	else
 	{
 		msg.print("Warning - Failed to get start time from NEXUS file. Using value from RunData instead.\n");
-		startTime_ = runData->startDateTime();
+		startTime_ = runData->startEpoch();
 	}
-	if (nexusExtractString(file, "/raw_data_1/end_time", tempString)) endTime_ = QDateTime::fromString(tempString, "yyyy-MM-ddTHH:mm:ss");
+	if (nexusExtractString(file, "/raw_data_1/end_time", tempString)) endTime_ = epochSeconds(tempString);
 	else
 	{
 		msg.print("Warning - Failed to get end time from NEXUS file. Using value from RunData instead.\n");
-		endTime_ = runData->endDateTime();
+		endTime_ = runData->endEpoch();
 	}
 	
 	// Specify path to sample environment group and open it
@@ -893,6 +1004,12 @@ bool ISIS::nexusExtractString(hid_t rootLocation, const char* name, QString& des
 	return true;
 }
 
+// Return time offset by specified number of seconds
+static qint64 offsetTime(qint64 epochSeconds, double seconds)
+{
+	return (epochSeconds == ISIS::invalidTime ? ISIS::invalidTime : epochSeconds + qint64(seconds));
+}
+
 // Retrieve time/value data from specified NEXUS group
 herr_t ISIS::nexusExtractTimeValueData(RunData* runData, hid_t time, hid_t value)
 {
@@ -951,18 +1068,19 @@ herr_t ISIS::nexusExtractTimeValueData(RunData* runData, hid_t time, hid_t value
 	char** charBuffer;
 	hid_t memType, charSpace;
 	Data2D* data = runData->addBlockData(currentBlock_, currentGroup_, startTime_, endTime_);
+	data->reserve(data->nPoints() + (int) nValue[0]);
 	switch (H5Tget_class(valueType))
 	{
 		case (H5T_INTEGER):
 			intBuffer = new int[(long int) nValue[0]];
 			status = H5Dread(value, H5T_NATIVE_INT_g, H5S_ALL, H5S_ALL, H5P_DEFAULT, intBuffer);
-			for (int n=0; n<nValue[0]; ++n) data->addRelativePoint(startTime_.addSecs(timeData[n]), (double) intBuffer[n]);
+			for (int n=0; n<nValue[0]; ++n) data->addRelativePoint(offsetTime(startTime_, timeData[n]), (double) intBuffer[n]);
 			delete[] intBuffer;
 			break;
 		case (H5T_FLOAT):
 			doubleBuffer = new double[(long int) nValue[0]];
 			status = H5Dread(value, H5T_NATIVE_DOUBLE_g, H5S_ALL, H5S_ALL, H5P_DEFAULT, doubleBuffer);
-			for (int n=0; n<nValue[0]; ++n) data->addRelativePoint(startTime_.addSecs(timeData[n]), doubleBuffer[n]);
+			for (int n=0; n<nValue[0]; ++n) data->addRelativePoint(offsetTime(startTime_, timeData[n]), doubleBuffer[n]);
 			delete[] doubleBuffer;
 			break;
 		case (H5T_STRING):
@@ -976,7 +1094,7 @@ herr_t ISIS::nexusExtractTimeValueData(RunData* runData, hid_t time, hid_t value
 			memType = H5Tcopy(H5T_C_S1);
 			status = H5Tset_size(memType, valueSize);
 			status = H5Dread(value, memType, H5S_ALL, H5S_ALL, H5P_DEFAULT, charBuffer[0]);
-			for (int n=0; n<nValue[0]; ++n) data->addRelativePoint(startTime_.addSecs(timeData[n]), runData->enumeratedBlockValue(currentBlock_, QString(charBuffer[n])));
+			for (int n=0; n<nValue[0]; ++n) data->addRelativePoint(offsetTime(startTime_, timeData[n]), runData->enumeratedBlockValue(currentBlock_, QString(charBuffer[n])));
 // 			for (int n=0; n<(long int) nValue[0]; ++n) delete charBuffer[n];
 			delete[] charBuffer[0];
 			delete[] charBuffer;
@@ -26,6 +26,7 @@
 #include <QXmlStreamReader>
 #include <QDateTime>
 #include <QDir>
+#include "stringpool.h"
 #include <hdf5.h>
 
 // Forward Declarations
@@ -33,6 +34,7 @@ class JournalViewer;
 class InstrumentInfo;
 class RunData;
 class Journal;
+class JournalEntries;
 class Instrument;
 class Data2D;
 
@@ -90,24 +92,40 @@ class ISIS
 	 * Global Data
 	 */
 	private:
-	// List of Cycles
-	static QStringList cycles_;
+	// Pool of cycle names (journals may be parsed in worker threads)
+	static StringPool cycles_;
 
 	public:
 	// Return cycle index for specified cycle text
-	static int cycleIndex(QString cycleName);
+	static int cycleIndex(const QString& cycleName);
 	// Return cycle text for specified cycle index
 	static QString cycleText(int index);
 	// Locate file for RunData
 	static QString locateFile(RunData* runData, QString extension, bool useLocalDirectory, QDir localDir);
 
 
+	/*
+	 * Time Conversion
+	 */
+	public:
+	// Value representing an invalid / unset time
+	static const qint64 invalidTime = -9223372036854775807LL - 1;
+	// Convert NXentry / log style local time string (yyyy-MM-ddTHH:mm:ss) to seconds since epoch
+	static qint64 epochSeconds(const char* text, int length);
+	// Convert NXentry / log style local time string (yyyy-MM-ddTHH:mm:ss) to seconds since epoch
+	static qint64 epochSeconds(const QString& text);
+	// Convert QDateTime to seconds since epoch
+	static qint64 epochSeconds(const QDateTime& dateTime);
+	// Return QDateTime (in local time) for seconds since epoch
+	static QDateTime dateTime(qint64 epochSeconds);
+
+
 	/*
 	 * Data Parsing
 	 */
 	private:
-	// Temporary start/end time variables
-	static QDateTime startTime_, endTime_;
+	// Temporary start/end time variables (seconds since epoch)
+	static qint64 startTime_, endTime_;
 	// Current block name being investigated by nexusBlockIterator
 	static QString currentBlock_;
 	// Group name for current block being investigated by nexusBlockIterator
@@ -130,8 +148,10 @@ class ISIS
 #endif
 	// Parse journal index from specified QByteArray
 	static bool parseJournalIndex(Instrument* inst, QByteArray& data);
-	// Parse journal data from specified QByteArray
-	static bool parseJournalData(Journal* jrnl, QByteArray& data, bool addUniqueOnly = false, bool forceISOEncoding = false);
+	// Parse journal entries from specified QByteArray, without modifying the Journal
+	static bool parseJournalEntries(Journal* jrnl, QByteArray& data, JournalEntries& entries, bool forceISOEncoding = false);
+	// Parse journal entries from specified fragment (appended to source after the Journal's last complete NXentry), without modifying the Journal
+	static bool parseJournalFragmentEntries(Journal* jrnl, QByteArray& fragment, qint64 fragmentOffset, JournalEntries& entries, bool forceISOEncoding = false);
 	// Parse instrument information (blocks etc.)
 	static bool parseInstrumentInformation(Instrument* inst, QByteArray& data);
 	// Parse log information (block data etc.) from log dile
@@ -22,6 +22,57 @@
 #include "journal.h"
 #include "instrument.h"
 
+/*
+ * Journal Entries
+ */
+
+// Constructor
+JournalEntries::JournalEntries()
+{
+	fragmentOffset_ = -1;
+	lastEntryOffset_ = -1;
+}
+
+// Return staging catalogue containing property values of the entries
+RunCatalogue* JournalEntries::catalogue()
+{
+	return &catalogue_;
+}
+
+// Return parsed entries
+List<RunData>& JournalEntries::entries()
+{
+	return entries_;
+}
+
+// Set byte offset in source at which the parsed fragment began
+void JournalEntries::setFragmentOffset(qint64 offset)
+{
+	fragmentOffset_ = offset;
+}
+
+// Return byte offset in source at which the parsed fragment began (or -1 if the entries were parsed from the full source)
+qint64 JournalEntries::fragmentOffset() const
+{
+	return fragmentOffset_;
+}
+
+// Set byte offset in source immediately following the last complete NXentry parsed
+void JournalEntries::setLastEntryOffset(qint64 offset)
+{
+	lastEntryOffset_ = offset;
+}
+
+// Return byte offset in source immediately following the last complete NXentry parsed (or -1 if there were none)
+qint64 JournalEntries::lastEntryOffset() const
+{
+	return lastEntryOffset_;
+}
+
+/*
+ * Journal
+ */
+
 // Constructor
 Journal::Journal(): ListItem<Journal>()
 {
@@ -29,6 +80,8 @@ Journal::Journal(): ListItem<Journal>()
 	fileName_ = "filename.abc";
 	parent_ = NULL;
 	local_ = false;
+	lastEntryOffset_ = -1;
+	runIndexValid_ = false;
 }
 
 // Destructor
@@ -91,6 +144,30 @@ QDateTime Journal::modificationTime()
 	return modificationTime_;
 }
 
+// Set time at which journal data was last checked against its source
+void Journal::setCheckTime(QDateTime checkTime)
+{
+	checkTime_ = checkTime;
+}
+
+// Return time at which journal data was last checked against its source
+QDateTime Journal::checkTime()
+{
+	return checkTime_;
+}
+
+// Set byte offset in source file immediately following the last complete NXentry
+void Journal::setLastEntryOffset(qint64 offset)
+{
+	lastEntryOffset_ = offset;
+}
+
+// Return byte offset in source file immediately following the last complete NXentry
+qint64 Journal::lastEntryOffset()
+{
+	return lastEntryOffset_;
+}
+
 // Return full local file path of Journal
 QString Journal::filePath()
 {
@@ -112,6 +189,12 @@ List<RunData>& Journal::runData()
 	return runData_;
 }
 
+// Return catalogue containing property values of all RunData in this journal (one row per RunData, in list order)
+RunCatalogue* Journal::catalogue()
+{
+	return &catalogue_;
+}
+
 // Set this as a local journal
 void Journal::setLocal(QDir dir)
 {
@@ -130,4 +213,113 @@ QDir Journal::localDirectory()
 {
 	return localDirectory_;
 }
-	
\ No newline at end of file
+
+// Return estimated memory used by journal, its catalogue and RunData (bytes, excluding block data)
+qint64 Journal::memoryUsage() const
+{
+	qint64 bytes = sizeof(Journal) - sizeof(RunCatalogue) + catalogue_.memoryUsage();
+	bytes += (name_.capacity() + cycle_.capacity() + fileName_.capacity()) * sizeof(QChar);
+	bytes += runData_.nItems() * sizeof(RunData);
+	bytes += runIndex_.capacity() * sizeof(void*) + runIndex_.size() * (sizeof(int) + sizeof(RunData*) + 2*sizeof(void*));
+	bytes += changedRuns_.capacity() * sizeof(void*) + changedRuns_.size() * (sizeof(int) + 2*sizeof(void*));
+	return bytes;
+}
+
+// Return estimated memory used by block data loaded for RunData in this journal (bytes)
+qint64 Journal::blockDataMemoryUsage() const
+{
+	qint64 bytes = 0;
+	for (RunData* rd = runData_.first(); rd != NULL; rd = rd->next) bytes += rd->blockDataMemoryUsage();
+	return bytes;
+}
+	
+/*
+ * Run Index
+ */
+
+// Regenerate run index
+void Journal::regenerateRunIndex()
+{
+	runIndex_.clear();
+	runIndex_.reserve(runData_.nItems());
+	for (RunData* rd = runData_.first(); rd != NULL; rd = rd->next) runIndex_.insert(rd->runNumber(), rd);
+	runIndexValid_ = true;
+}
+
+// Clear all RunData
+void Journal::clearRunData()
+{
+	runData_.clear();
+	catalogue_.clear();
+	runIndex_.clear();
+	runIndexValid_ = true;
+	changedRuns_.clear();
+}
+
+// Add (and take ownership of) new RunData
+void Journal::addRunData(RunData* rd)
+{
+	rd->moveToCatalogue(&catalogue_);
+	runData_.own(rd);
+	if (runIndexValid_) runIndex_.insert(rd->runNumber(), rd);
+	changedRuns_.insert(rd->runNumber());
+}
+
+// Add or update RunData with run number matching that supplied (which is deleted if a match exists), returning the resulting RunData
+RunData* Journal::upsertRunData(RunData* rd)
+{
+	RunData* existing = findRunData(rd->runNumber());
+	if (existing == NULL)
+	{
+		addRunData(rd);
+		return rd;
+	}
+
+	// Update existing data in place (e.g. for a run that was still in progress when we last looked)
+	if (existing->updateFrom(*rd)) changedRuns_.insert(existing->runNumber());
+	delete rd;
+	return existing;
+}
+
+// Add (taking ownership of) parsed entries, replacing existing RunData unless only updating, and returning false if a fragment no longer follows on from our data
+bool Journal::addEntries(JournalEntries& entries, bool updateOnly)
+{
+	// A fragment starts with the closing tag of the last NXentry we had when it was retrieved - if we have been reloaded since, it no longer applies
+	if ((entries.fragmentOffset() != -1) && (entries.fragmentOffset() != lastEntryOffset_ - 10)) return false;
+
+	// Clear list if not updating it
+	if (updateOnly) clearChangedRuns();
+	else clearRunData();
+
+	// Transfer entries - if we are only updating, existing runs are updated in place
+	RunData* rd;
+	while ((rd = entries.entries().first()) != NULL)
+	{
+		entries.entries().disown(rd);
+		if (updateOnly) upsertRunData(rd);
+		else addRunData(rd);
+	}
+
+	lastEntryOffset_ = entries.lastEntryOffset();
+
+	return true;
+}
+
+// Return RunData with specified run number (if it exists)
+RunData* Journal::findRunData(int runNumber)
+{
+	if (!runIndexValid_) regenerateRunIndex();
+	return runIndex_.value(runNumber, NULL);
+}
+
+// Clear changed run numbers
+void Journal::clearChangedRuns()
+{
+	changedRuns_.clear();
+}
+
+// Return run numbers of RunData added or changed since changes were last cleared
+const QSet<int>& Journal::changedRuns()
+{
+	return changedRuns_;
+}
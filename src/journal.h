@@ -26,12 +26,48 @@
 #include <QDate>
 #include <QUrl>
 #include <QDir>
+#include <QHash>
+#include <QSet>
 #include "list.h"
 #include "rundata.h"
 
 // Forward Declarations
 class Instrument;
 
+/*
+ * Journal entries parsed away from their Journal (e.g. on a loader thread, while the Journal's RunData are on display), waiting to be added to it
+ */
+class JournalEntries
+{
+	public:
+	// Constructor
+	JournalEntries();
+
+	private:
+	// Staging catalogue containing property values of the entries
+	RunCatalogue catalogue_;
+	// Parsed entries (declared after the catalogue, so they are deleted before it)
+	List<RunData> entries_;
+	// Byte offset in source at which the parsed fragment began (or -1 if the entries were parsed from the full source)
+	qint64 fragmentOffset_;
+	// Byte offset in source immediately following the last complete NXentry parsed (or -1 if there were none)
+	qint64 lastEntryOffset_;
+
+	public:
+	// Return staging catalogue containing property values of the entries
+	RunCatalogue* catalogue();
+	// Return parsed entries
+	List<RunData>& entries();
+	// Set byte offset in source at which the parsed fragment began
+	void setFragmentOffset(qint64 offset);
+	// Return byte offset in source at which the parsed fragment began (or -1 if the entries were parsed from the full source)
+	qint64 fragmentOffset() const;
+	// Set byte offset in source immediately following the last complete NXentry parsed
+	void setLastEntryOffset(qint64 offset);
+	// Return byte offset in source immediately following the last complete NXentry parsed (or -1 if there were none)
+	qint64 lastEntryOffset() const;
+};
+
 // Journal Storage
 class Journal : public ListItem<Journal>
 {
@@ -55,6 +91,12 @@ class Journal : public ListItem<Journal>
 	QString fileName_;
 	// Modification time of journal file on loading
 	QDateTime modificationTime_;
+	// Time at which journal data was last checked against its source
+	QDateTime checkTime_;
+	// Byte offset in source file immediately following the last complete NXentry
+	qint64 lastEntryOffset_;
+	// Catalogue containing property values of all RunData in this journal
+	RunCatalogue catalogue_;
 	// RunData contained in this journal
 	List<RunData> runData_;
 	// Flag indicating that this journal is a local user journal
@@ -81,18 +123,64 @@ class Journal : public ListItem<Journal>
 	void setModificationTime(QDateTime modTime);
 	// Return modification time of journal
 	QDateTime modificationTime();
+	// Set time at which journal data was last checked against its source
+	void setCheckTime(QDateTime checkTime);
+	// Return time at which journal data was last checked against its source
+	QDateTime checkTime();
+	// Set byte offset in source file immediately following the last complete NXentry
+	void setLastEntryOffset(qint64 offset);
+	// Return byte offset in source file immediately following the last complete NXentry
+	qint64 lastEntryOffset();
 	// Return full local file path of Journal
 	QString filePath();
 	// Return full http file path of Journal
 	QUrl httpPath();
 	// Return RunData list
 	List<RunData>& runData();
+	// Return catalogue containing property values of all RunData in this journal (one row per RunData, in list order)
+	RunCatalogue* catalogue();
 	// Set this as a local journal
 	void setLocal(QDir dir);
 	// Return whether this journal is a local user journal
 	bool local();
 	// Return directory containing files listed in Journal
 	QDir localDirectory();
+	// Return estimated memory used by journal, its catalogue and RunData (bytes, excluding block data)
+	qint64 memoryUsage() const;
+	// Return estimated memory used by block data loaded for RunData in this journal (bytes)
+	qint64 blockDataMemoryUsage() const;
+
+
+	/*
+	 * Run Index
+	 */
+	private:
+	// Index of RunData by run number
+	QHash<int,RunData*> runIndex_;
+	// Whether runIndex_ is up to date
+	bool runIndexValid_;
+	// Run numbers of RunData added or changed since changes were last cleared
+	QSet<int> changedRuns_;
+
+	private:
+	// Regenerate run index
+	void regenerateRunIndex();
+
+	public:
+	// Clear all RunData
+	void clearRunData();
+	// Add (and take ownership of) new RunData
+	void addRunData(RunData* rd);
+	// Add or update RunData with run number matching that supplied (which is deleted if a match exists), returning the resulting RunData
+	RunData* upsertRunData(RunData* rd);
+	// Add (taking ownership of) parsed entries, replacing existing RunData unless only updating, and returning false if a fragment no longer follows on from our data
+	bool addEntries(JournalEntries& entries, bool updateOnly);
+	// Return RunData with specified run number (if it exists)
+	RunData* findRunData(int runNumber);
+	// Clear changed run numbers
+	void clearChangedRuns();
+	// Return run numbers of RunData added or changed since changes were last cleared
+	const QSet<int>& changedRuns();
 };
 
 #endif
@@ -0,0 +1,342 @@
+/*
+	*** Journal Loader
+	*** src/journalloader.cpp
+	Copyright T. Youngs 2012-2016
+
+	This file is part of JournalViewer.
+
+	JournalViewer is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	JournalViewer is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with JournalViewer.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "journalloader.h"
+#include "journalsnapshot.h"
+#include "datainterface.h"
+#include "instrument.h"
+#include "messenger.hui"
+#include <QFile>
+
+// Constructor
+JournalLoader::JournalLoader(JournalViewer* parent, Journal* jrnl, JournalViewer::JournalAccess accessType, bool updateOnly, bool forceISOEncoding, const char* finishedSlot, DataInterface* dataInterface) : QRunnable(), result_(jrnl)
+{
+	parent_ = parent;
+	journal_ = jrnl;
+	accessType_ = accessType;
+	updateOnly_ = updateOnly;
+	forceISOEncoding_ = forceISOEncoding;
+	dataInterface_ = dataInterface;
+	stageEntries_ = false;
+
+	action_ = JournalLoader::NoAction;
+	sourceType_ = JournalViewer::NoAccess;
+	fragmentOffset_ = -1;
+	netFallback_ = false;
+	finishedSlot_ = finishedSlot;
+
+	// The thread pool deletes the loader once it has run, so nothing must refer to it after it has been started
+	setAutoDelete(true);
+}
+
+/*
+ * Source Data
+ */
+
+// Load data from net into QByteArray
+bool JournalLoader::readHttp(QUrl location, QByteArray& data, qint64 rangeStart)
+{
+	if (dataInterface_) return dataInterface_->readHttp(location, data, rangeStart);
+	else return DataInterface::fetchHttp(location, data, rangeStart);
+}
+
+// Get modification time from HTTP header
+bool JournalLoader::readHttpModificationTime(QUrl location, QDateTime& modificationTime)
+{
+	if (dataInterface_) return dataInterface_->readHttpModificationTime(location, modificationTime);
+	else return DataInterface::fetchHttpModificationTime(location, modificationTime);
+}
+
+// Return target Journal
+Journal* JournalLoader::journal()
+{
+	return journal_;
+}
+
+// Set whether parsed entries are staged, to be added to the Journal from the GUI thread, rather than added to it here
+void JournalLoader::setStageEntries(bool stage)
+{
+	stageEntries_ = stage;
+}
+
+/*
+ * Retrieved Data
+ */
+
+// Retrieve data appended to the Journal source since it was last read
+bool JournalLoader::retrieveDelta()
+{
+	// Need to know where the last complete entry ended - we request data starting from its closing tag so we can check it is still there
+	if (journal_->lastEntryOffset() < 10) return false;
+	fragmentOffset_ = journal_->lastEntryOffset() - 10;
+
+	data_.clear();
+	if (sourceType_ == JournalViewer::DiskOnlyAccess)
+	{
+		QFile file(journal_->filePath());
+		if ((!file.open(QIODevice::ReadOnly)) || (file.size() < journal_->lastEntryOffset()) || (!file.seek(fragmentOffset_))) return false;
+		data_ = file.readAll();
+		file.close();
+	}
+	else if (sourceType_ == JournalViewer::NetOnlyAccess)
+	{
+		if (!readHttp(journal_->httpPath(), data_, fragmentOffset_)) return false;
+	}
+	else return false;
+
+	// Check that the fragment follows on from the data we have, so we can fall back to a full retrieval here if not
+	if (!data_.startsWith("</NXentry>"))
+	{
+		msg.print("Delta update of Journal '" + journal_->name() + "' not possible - full update required.");
+		data_.clear();
+		return false;
+	}
+
+	return true;
+}
+
+// Retrieve full Journal data
+bool JournalLoader::retrieveFull()
+{
+	netFallback_ = false;
+	data_.clear();
+
+	if (sourceType_ == JournalViewer::DiskOnlyAccess)
+	{
+		// Local copy is newer (somehow) so load it in
+		if (DataInterface::readFile(journal_->filePath(), data_)) return true;
+
+		// Failed to load local copy - we can update it from the net, if the access type permits it
+		if (accessType_ != JournalViewer::DiskAndNetAccess) return false;
+		netFallback_ = true;
+		if (!readHttp(journal_->httpPath(), data_)) return false;
+		readHttpModificationTime(journal_->httpPath(), result_.modificationTime_);
+		return true;
+	}
+	else if (sourceType_ == JournalViewer::NetOnlyAccess) return readHttp(journal_->httpPath(), data_);
+
+	return false;
+}
+
+// Add parsed entries to the Journal, or stage them
+bool JournalLoader::addEntries(QSharedPointer<JournalEntries> entries)
+{
+	if (stageEntries_)
+	{
+		result_.stagedEntries_ = entries;
+		return true;
+	}
+	if (!journal_->addEntries(*entries, updateOnly_)) return false;
+
+	msg.print("Journal '%s' has %i runs (%i added or changed, catalogue uses %lli bytes, shared string pool %lli bytes for %i strings).", qPrintable(journal_->name()), journal_->runData().nItems(), journal_->changedRuns().count(), journal_->catalogue()->memoryUsage(), RunCatalogue::stringPool().memoryUsage(), RunCatalogue::nStrings());
+	return true;
+}
+
+// Parse retrieved fragment into the Journal
+bool JournalLoader::processDelta()
+{
+	// Take a copy of the raw fragment, since the parser may modify it, and we might want to update our local copy
+	// If the Journal has been reloaded since the fragment was retrieved, it no longer applies
+	QByteArray rawFragment = data_;
+	QSharedPointer<JournalEntries> entries(new JournalEntries);
+	if ((!ISIS::parseJournalFragmentEntries(journal_, data_, fragmentOffset_, *entries, forceISOEncoding_)) || (!addEntries(entries)))
+	{
+		msg.print("Delta update of Journal '" + journal_->name() + "' failed - full update required.");
+		return false;
+	}
+
+	msg.print("Journal '%s' updated from %i new bytes (%s) for instrument %s", qPrintable(journal_->name()), rawFragment.size() - 10, sourceType_ == JournalViewer::DiskOnlyAccess ? "disk" : "net", qPrintable(journal_->parent()->capitalisedName()));
+
+	// Update local copy, if access type permits
+	if ((sourceType_ == JournalViewer::NetOnlyAccess) && (accessType_ == JournalViewer::DiskAndNetAccess))
+	{
+		result_.localCopyData_ = rawFragment;
+		result_.localCopyOffset_ = fragmentOffset_;
+	}
+
+	return true;
+}
+
+// Parse retrieved full data into the Journal
+bool JournalLoader::processFull()
+{
+	QString journalText = "Journal '" + journal_->name() + "'";
+	QString instrumentText = " for instrument " + journal_->parent()->capitalisedName();
+
+	// Take a copy of the raw data if it came from the net, since the parser may modify it and we might want to save it
+	bool fromNet = (sourceType_ == JournalViewer::NetOnlyAccess) || netFallback_;
+	QByteArray rawData;
+	if (fromNet) rawData = data_;
+	QSharedPointer<JournalEntries> entries(new JournalEntries);
+	bool result = ISIS::parseJournalEntries(journal_, data_, *entries, forceISOEncoding_);
+
+	// If the local copy couldn't be parsed, try the net instead (if the access type permits it)
+	if ((!result) && (!fromNet) && (accessType_ == JournalViewer::DiskAndNetAccess))
+	{
+		netFallback_ = fromNet = true;
+		result = readHttp(journal_->httpPath(), data_);
+		rawData = data_;
+		if (result) result = ISIS::parseJournalEntries(journal_, data_, *entries, forceISOEncoding_);
+		if (result && (!readHttpModificationTime(journal_->httpPath(), result_.modificationTime_))) rawData.clear();
+	}
+	if (result) result = addEntries(entries);
+
+	// Set message, and save local copy of net data if access type permits
+	if (result)
+	{
+		if (!fromNet) result_.message_ = "Updated " + journalText + " loaded from disk" + instrumentText;
+		else result_.message_ = "Updated " + journalText + " loaded from net" + (netFallback_ ? " (failed to read local copy)" : "") + instrumentText;
+		if (fromNet && (accessType_ == JournalViewer::DiskAndNetAccess)) result_.localCopyData_ = rawData;
+	}
+	else if (fromNet) result_.message_ = "Failed to load " + journalText + instrumentText + (netFallback_ ? " from both local disk and net." : " from net.");
+	else result_.message_ = "Failed to load " + journalText + instrumentText + " from disk.";
+
+	data_.clear();
+
+	return result;
+}
+
+/*
+ * Execution
+ */
+
+// Probe source and retrieve any data required to bring the Journal up to date
+void JournalLoader::retrieve()
+{
+	QString journalText = "Journal '" + journal_->name() + "'";
+	QString instrumentText = " for instrument " + journal_->parent()->capitalisedName();
+
+	action_ = JournalLoader::NoAction;
+	result_.result_ = false;
+	result_.upToDate_ = false;
+	result_.localCopyData_.clear();
+	result_.stagedEntries_.clear();
+	result_.localCopyOffset_ = -1;
+
+	// If the data was checked against its source recently (e.g. by the background preload) just use it as it is
+	QDateTime checkTime = journal_->checkTime();
+	if ((!updateOnly_) && (journal_->runData().nItems() != 0) && checkTime.isValid() && (checkTime.secsTo(QDateTime::currentDateTime()) < JournalViewer::revalidationInterval))
+	{
+		action_ = JournalLoader::CachedAction;
+		result_.modificationTime_ = journal_->modificationTime();
+		result_.message_ = "Using cached data for " + journalText + instrumentText;
+		return;
+	}
+
+	if (!DataInterface::mostRecent(accessType_, journal_->filePath(), journal_->httpPath(), result_.modificationTime_, sourceType_, dataInterface_))
+	{
+		result_.message_ = "Failed to load journal data '" + journal_->fileName() + "'" + instrumentText;
+		return;
+	}
+
+	if (sourceType_ == JournalViewer::NoAccess)
+	{
+		action_ = JournalLoader::FullAction;
+		result_.message_ = "No source available for " + journalText + instrumentText;
+	}
+	else if (result_.modificationTime_ == journal_->modificationTime())
+	{
+		action_ = JournalLoader::UpToDateAction;
+		result_.message_ = "Current data for " + journalText + instrumentText + " is up to date";
+	}
+	else if (updateOnly_ && (journal_->runData().nItems() != 0) && retrieveDelta()) action_ = JournalLoader::DeltaAction;
+	else if (((!updateOnly_) || (journal_->runData().nItems() == 0)) && (!stageEntries_) && QFile::exists(JournalSnapshot::fileName(journal_))) action_ = JournalLoader::SnapshotAction;
+	else
+	{
+		action_ = JournalLoader::FullAction;
+		if (!retrieveFull()) result_.message_ = "Failed to retrieve " + journalText + instrumentText;
+	}
+}
+
+// Process retrieved data into the Journal (or stage it)
+void JournalLoader::process()
+{
+	QString journalText = "Journal '" + journal_->name() + "'";
+	QString instrumentText = " for instrument " + journal_->parent()->capitalisedName();
+	bool parsed = false;
+
+	switch (action_)
+	{
+		// Nothing to do (check times are left as they are)
+		case (JournalLoader::NoAction):
+			msg.print(result_.message_);
+			return;
+		case (JournalLoader::CachedAction):
+			result_.result_ = result_.upToDate_ = true;
+			msg.print(result_.message_);
+			return;
+		case (JournalLoader::UpToDateAction):
+			result_.result_ = result_.upToDate_ = true;
+			break;
+		case (JournalLoader::DeltaAction):
+			// Only the data appended since we last read the journal was retrieved - if it can't be applied, a full retrieval is required
+			if (processDelta())
+			{
+				result_.result_ = parsed = true;
+				result_.message_ = journalText + " updated (" + QString::number(stageEntries_ ? result_.stagedEntries_->entries().nItems() : journal_->changedRuns().count()) + " runs added or changed)" + instrumentText;
+				break;
+			}
+			data_.clear();
+			if (retrieveFull()) result_.result_ = parsed = processFull();
+			break;
+		case (JournalLoader::SnapshotAction):
+			// Snapshot of the same source is available, so no need to parse the XML
+			if (JournalSnapshot::read(parent_, journal_, result_.modificationTime_))
+			{
+				result_.result_ = true;
+				result_.message_ = journalText + " loaded from snapshot" + instrumentText;
+				break;
+			}
+			if (retrieveFull()) result_.result_ = parsed = processFull();
+			else result_.message_ = "Failed to retrieve " + journalText + instrumentText;
+			break;
+		case (JournalLoader::FullAction):
+			if (sourceType_ != JournalViewer::NoAccess) result_.result_ = parsed = ((!data_.isEmpty()) && processFull());
+			break;
+	}
+	msg.print(result_.message_);
+
+	// Staged entries are added to the Journal (and its times set) by the receiver
+	if (result_.stagedEntries_) return;
+
+	// Set modification and check times
+	journal_->setModificationTime(result_.result_ ? result_.modificationTime_ : QDateTime());
+	journal_->setCheckTime(result_.result_ ? QDateTime::currentDateTime() : QDateTime());
+
+	// Store a snapshot of freshly-parsed data so the XML need not be parsed again
+	if (result_.result_ && parsed) JournalSnapshot::write(journal_, result_.modificationTime_);
+}
+
+// Probe, retrieve and process the Journal, returning the result
+JournalLoadResult JournalLoader::load()
+{
+	retrieve();
+	process();
+
+	return result_;
+}
+
+// Load the Journal, and pass the result to the parent
+void JournalLoader::run()
+{
+	// The result is copied into the queued call, so the parent never touches the loader itself
+	QMetaObject::invokeMethod(parent_, finishedSlot_, Qt::QueuedConnection, Q_ARG(JournalLoadResult, load()));
+}
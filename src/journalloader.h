@@ -0,0 +1,140 @@
+/*
+	*** Journal Loader
+	*** src/journalloader.h
+	Copyright T. Youngs 2012-2016
+
+	This file is part of JournalViewer.
+
+	JournalViewer is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	JournalViewer is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with JournalViewer.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef JOURNALVIEWER_JOURNALLOADER_H
+#define JOURNALVIEWER_JOURNALLOADER_H
+
+#include "jv.h"
+#include "journalloadresult.h"
+#include <QRunnable>
+#include <QByteArray>
+#include <QDateTime>
+#include <QSharedPointer>
+
+// Forward Declarations
+class Journal;
+class JournalEntries;
+class DataInterface;
+
+/*
+ * Journal Loader
+ * When run by a thread pool the loader is deleted once it has run, its result being passed by value to the named slot of the parent
+ * JournalViewer, which must take a JournalLoadResult. It may also be created on the stack and load() called directly.
+ */
+class JournalLoader : public QRunnable
+{
+	public:
+	// Constructor
+	JournalLoader(JournalViewer* parent, Journal* jrnl, JournalViewer::JournalAccess accessType, bool updateOnly, bool forceISOEncoding, const char* finishedSlot, DataInterface* dataInterface = NULL);
+
+
+	/*
+	 * Source Data
+	 */
+	private:
+	// Parent JournalViewer
+	JournalViewer* parent_;
+	// Target Journal
+	Journal* journal_;
+	// Permitted access type
+	JournalViewer::JournalAccess accessType_;
+	// Whether only new entries should be added to the Journal
+	bool updateOnly_;
+	// Whether to force ISO-8859-1 encoding when reading XML
+	bool forceISOEncoding_;
+	// DataInterface to use for http requests (if NULL, requests are made without progress indication)
+	DataInterface* dataInterface_;
+
+	// Whether parsed entries are staged, to be added to the Journal from the GUI thread, rather than added to it here
+	bool stageEntries_;
+
+	private:
+	// Load data from net into QByteArray
+	bool readHttp(QUrl location, QByteArray& data, qint64 rangeStart = 0);
+	// Get modification time from HTTP header
+	bool readHttpModificationTime(QUrl location, QDateTime& modificationTime);
+
+	public:
+	// Return target Journal
+	Journal* journal();
+	// Set whether parsed entries are staged, to be added to the Journal from the GUI thread, rather than added to it here
+	void setStageEntries(bool stage);
+
+
+	/*
+	 * Retrieved Data
+	 */
+	private:
+	// Actions required to bring the Journal up to date
+	enum LoadAction { NoAction, CachedAction, UpToDateAction, DeltaAction, SnapshotAction, FullAction };
+	// Action determined by retrieve()
+	LoadAction action_;
+	// Source the data was retrieved from
+	JournalViewer::JournalAccess sourceType_;
+	// Retrieved data (full journal, or fragment following the last complete entry)
+	QByteArray data_;
+	// Offset in source at which fragment data begins
+	qint64 fragmentOffset_;
+	// Whether full data was retrieved from the net because the local copy could not be read
+	bool netFallback_;
+
+	private:
+	// Retrieve data appended to the Journal source since it was last read
+	bool retrieveDelta();
+	// Retrieve full Journal data
+	bool retrieveFull();
+	// Add parsed entries to the Journal, or stage them
+	bool addEntries(QSharedPointer<JournalEntries> entries);
+	// Parse retrieved fragment into the Journal
+	bool processDelta();
+	// Parse retrieved full data into the Journal
+	bool processFull();
+
+
+	/*
+	 * Result
+	 */
+	private:
+	// Result of loading the Journal
+	JournalLoadResult result_;
+
+
+	/*
+	 * Execution
+	 */
+	private:
+	// Name of parent's slot to call with the result (when run by a thread pool)
+	const char* finishedSlot_;
+
+	private:
+	// Probe source and retrieve any data required to bring the Journal up to date
+	void retrieve();
+	// Process retrieved data into the Journal (or stage it)
+	void process();
+
+	public:
+	// Probe, retrieve and process the Journal, returning the result
+	JournalLoadResult load();
+	// Load the Journal, and pass the result to the parent
+	void run();
+};
+
+#endif
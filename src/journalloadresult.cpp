@@ -0,0 +1,80 @@
+/*
+	*** Journal Load Result
+	*** src/journalloadresult.cpp
+	Copyright T. Youngs 2012-2016
+
+	This file is part of JournalViewer.
+
+	JournalViewer is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	JournalViewer is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with JournalViewer.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "journalloadresult.h"
+#include "journal.h"
+
+// Constructor
+JournalLoadResult::JournalLoadResult(Journal* jrnl)
+{
+	journal_ = jrnl;
+	result_ = false;
+	upToDate_ = false;
+	localCopyOffset_ = -1;
+}
+
+// Return target Journal
+Journal* JournalLoadResult::journal() const
+{
+	return journal_;
+}
+
+// Return whether the Journal was loaded successfully
+bool JournalLoadResult::result() const
+{
+	return result_;
+}
+
+// Return whether the Journal data was already up to date
+bool JournalLoadResult::upToDate() const
+{
+	return upToDate_;
+}
+
+// Return modification time of the source the Journal was loaded from
+QDateTime JournalLoadResult::modificationTime() const
+{
+	return modificationTime_;
+}
+
+// Return data to be saved as the local copy of the journal (if any)
+const QByteArray& JournalLoadResult::localCopyData() const
+{
+	return localCopyData_;
+}
+
+// Return offset at which localCopyData_ should be written to the local copy (-1 to replace it completely)
+qint64 JournalLoadResult::localCopyOffset() const
+{
+	return localCopyOffset_;
+}
+
+// Return status message describing the result
+QString JournalLoadResult::message() const
+{
+	return message_;
+}
+
+// Return entries parsed but not yet added to the Journal (if the loader was staging them)
+QSharedPointer<JournalEntries> JournalLoadResult::stagedEntries() const
+{
+	return stagedEntries_;
+}
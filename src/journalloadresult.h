@@ -0,0 +1,87 @@
+/*
+	*** Journal Load Result
+	*** src/journalloadresult.h
+	Copyright T. Youngs 2012-2016
+
+	This file is part of JournalViewer.
+
+	JournalViewer is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	JournalViewer is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with JournalViewer.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef JOURNALVIEWER_JOURNALLOADRESULT_H
+#define JOURNALVIEWER_JOURNALLOADRESULT_H
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QString>
+#include <QSharedPointer>
+#include <QMetaType>
+
+// Forward Declarations
+class Journal;
+class JournalEntries;
+
+/*
+ * Result of loading a Journal.
+ * Loaders are deleted by their thread pool once they have run, so the result is passed by value to a slot of the receiver
+ * (and the receiver never touches the loader itself).
+ */
+class JournalLoadResult
+{
+	public:
+	// Constructor
+	JournalLoadResult(Journal* jrnl = NULL);
+
+	private:
+	// Target Journal
+	Journal* journal_;
+	// Whether the Journal was loaded successfully
+	bool result_;
+	// Whether the Journal data was already up to date
+	bool upToDate_;
+	// Modification time of the source the Journal was loaded from
+	QDateTime modificationTime_;
+	// Data to be saved as the local copy of the journal (if any)
+	QByteArray localCopyData_;
+	// Offset at which localCopyData_ should be written to the local copy (-1 to replace it completely)
+	qint64 localCopyOffset_;
+	// Status message describing the result
+	QString message_;
+	// Entries parsed but not yet added to the Journal (if the loader was staging them)
+	QSharedPointer<JournalEntries> stagedEntries_;
+	// Loaders fill in their own results
+	friend class JournalLoader;
+
+	public:
+	// Return target Journal
+	Journal* journal() const;
+	// Return whether the Journal was loaded successfully
+	bool result() const;
+	// Return whether the Journal data was already up to date
+	bool upToDate() const;
+	// Return modification time of the source the Journal was loaded from
+	QDateTime modificationTime() const;
+	// Return data to be saved as the local copy of the journal (if any)
+	const QByteArray& localCopyData() const;
+	// Return offset at which localCopyData_ should be written to the local copy (-1 to replace it completely)
+	qint64 localCopyOffset() const;
+	// Return status message describing the result
+	QString message() const;
+	// Return entries parsed but not yet added to the Journal (if the loader was staging them)
+	QSharedPointer<JournalEntries> stagedEntries() const;
+};
+
+Q_DECLARE_METATYPE(JournalLoadResult)
+
+#endif
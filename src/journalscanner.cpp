@@ -0,0 +1,455 @@
+/*
+	*** Journal Scanner
+	*** src/journalscanner.cpp
+	Copyright T. Youngs 2012-2016
+
+	This file is part of JournalViewer.
+
+	JournalViewer is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	JournalViewer is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with JournalViewer.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "journalscanner.h"
+#include "journal.h"
+#include "instrument.h"
+#include "jv.h"
+#include "messenger.hui"
+#include <string.h>
+
+// Hash of NXentry element name (perfect over the names we recognise - duplicate case labels in property() will fail to compile otherwise)
+constexpr unsigned int nxHash(const char* name, int length)
+{
+	return (length < 2 ? 64 : (length*67 + (unsigned char) name[0]*3 + (unsigned char) name[length-2]) % 64);
+}
+
+// Constructor
+JournalScanner::JournalScanner(const QByteArray& data, bool forceISOEncoding)
+{
+	begin_ = data.constData();
+	end_ = begin_ + data.size();
+	pos_ = begin_;
+	latin1_ = forceISOEncoding;
+
+	// Check encoding declared in the prolog (if there is one)
+	if ((!latin1_) && (data.startsWith("<?xml")))
+	{
+		int prologEnd = data.indexOf("?>");
+		if (prologEnd != -1)
+		{
+			QByteArray prolog = QByteArray::fromRawData(begin_, prologEnd).toLower();
+			if (prolog.contains("iso-8859-1") || prolog.contains("latin1")) latin1_ = true;
+		}
+	}
+}
+
+/*
+ * Source Data
+ */
+
+// Advance to the character following the next occurrence of the specified string
+bool JournalScanner::skipPast(const char* s, int length)
+{
+	while (pos_ <= end_ - length)
+	{
+		const char* c = (const char*) memchr(pos_, s[0], (end_ - length + 1) - pos_);
+		if (c == NULL) break;
+		if (memcmp(c, s, length) == 0)
+		{
+			pos_ = c + length;
+			return true;
+		}
+		pos_ = c + 1;
+	}
+	pos_ = end_;
+	return false;
+}
+
+// Read element name at current position, returning its length
+int JournalScanner::readName()
+{
+	const char* name = pos_;
+	while ((pos_ < end_) && (*pos_ != '>') && (*pos_ != '/') && (*pos_ != ' ') && (*pos_ != '\t') && (*pos_ != '\n') && (*pos_ != '\r')) ++pos_;
+	return pos_ - name;
+}
+
+// Find end of tag beginning at current position, returning the position of its closing '>'
+const char* JournalScanner::tagEnd()
+{
+	// Attribute values may legitimately contain '>', so step over quoted text
+	char quote = '\0';
+	for (const char* c = pos_; c < end_; ++c)
+	{
+		if (quote != '\0')
+		{
+			if (*c == quote) quote = '\0';
+		}
+		else if ((*c == '"') || (*c == '\'')) quote = *c;
+		else if (*c == '>') return c;
+	}
+	return NULL;
+}
+
+// Return whether the specified range contains only whitespace
+bool JournalScanner::isWhitespace(const char* begin, const char* end)
+{
+	for (const char* c = begin; c < end; ++c) if ((*c != ' ') && (*c != '\t') && (*c != '\n') && (*c != '\r')) return false;
+	return true;
+}
+
+/*
+ * Element / Value Conversion
+ */
+
+// Return property for specified NXentry element name
+RunProperty::Property JournalScanner::property(const char* name, int length)
+{
+	RunProperty::Property prop;
+	const char* nxName;
+	switch (nxHash(name, length))
+	{
+		case (nxHash("isis_cycle", 10)):
+			prop = RunProperty::Cycle;
+			nxName = "isis_cycle";
+			break;
+		case (nxHash("duration", 8)):
+			prop = RunProperty::Duration;
+			nxName = "duration";
+			break;
+		case (nxHash("end_time", 8)):
+			prop = RunProperty::EndTimeAndDate;
+			nxName = "end_time";
+			break;
+		case (nxHash("instrument_name", 15)):
+			prop = RunProperty::InstrumentName;
+			nxName = "instrument_name";
+			break;
+		case (nxHash("proton_charge", 13)):
+			prop = RunProperty::ProtonCharge;
+			nxName = "proton_charge";
+			break;
+		case (nxHash("experiment_identifier", 21)):
+			prop = RunProperty::RBNumber;
+			nxName = "experiment_identifier";
+			break;
+		case (nxHash("run_number", 10)):
+			prop = RunProperty::RunNumber;
+			nxName = "run_number";
+			break;
+		case (nxHash("start_time", 10)):
+			prop = RunProperty::StartTimeAndDate;
+			nxName = "start_time";
+			break;
+		case (nxHash("title", 5)):
+			prop = RunProperty::Title;
+			nxName = "title";
+			break;
+		case (nxHash("total_mevents", 13)):
+			prop = RunProperty::TotalMEvents;
+			nxName = "total_mevents";
+			break;
+		case (nxHash("user_name", 9)):
+			prop = RunProperty::User;
+			nxName = "user_name";
+			break;
+		default:
+			return RunProperty::nProperties;
+	}
+
+	// Hash matched, so check the name itself
+	if (((int) strlen(nxName) == length) && (memcmp(name, nxName, length) == 0)) return prop;
+	return RunProperty::nProperties;
+}
+
+// Convert text to QString, decoding any entities
+QString JournalScanner::text(const char* begin, const char* end)
+{
+	// Most text has no entities in it, so convert it directly
+	const char* amp = (const char*) memchr(begin, '&', end - begin);
+	if (amp == NULL) return latin1_ ? QString::fromLatin1(begin, end - begin) : QString::fromUtf8(begin, end - begin);
+
+	// Decode entities into a temporary buffer
+	QByteArray decoded;
+	decoded.reserve(end - begin);
+	const char* c = begin;
+	while (c < end)
+	{
+		if (*c != '&')
+		{
+			decoded += *c;
+			++c;
+			continue;
+		}
+
+		const char* semicolon = (const char*) memchr(c, ';', end - c);
+		if (semicolon == NULL)
+		{
+			decoded.append(c, end - c);
+			break;
+		}
+		QByteArray entity = QByteArray::fromRawData(c+1, semicolon - c - 1);
+		if (entity == "lt") decoded += '<';
+		else if (entity == "gt") decoded += '>';
+		else if (entity == "amp") decoded += '&';
+		else if (entity == "quot") decoded += '"';
+		else if (entity == "apos") decoded += '\'';
+		else if (entity.startsWith('#'))
+		{
+			bool ok;
+			uint code = (entity.startsWith("#x") ? entity.mid(2).toUInt(&ok, 16) : entity.mid(1).toUInt(&ok, 10));
+			if (ok) decoded += latin1_ ? QByteArray(1, (char) code) : QString(QChar(code)).toUtf8();
+		}
+		else decoded.append(c, semicolon - c + 1);
+		c = semicolon + 1;
+	}
+	return latin1_ ? QString::fromLatin1(decoded) : QString::fromUtf8(decoded);
+}
+
+// Convert text to integer
+int JournalScanner::toInt(const char* begin, const char* end)
+{
+	// Skip surrounding whitespace
+	while ((begin < end) && ((*begin == ' ') || (*begin == '\t') || (*begin == '\n') || (*begin == '\r'))) ++begin;
+	while ((end > begin) && ((end[-1] == ' ') || (end[-1] == '\t') || (end[-1] == '\n') || (end[-1] == '\r'))) --end;
+	if (begin == end) return 0;
+
+	bool negative = (*begin == '-');
+	if ((*begin == '-') || (*begin == '+')) ++begin;
+	if (begin == end) return 0;
+
+	qint64 result = 0;
+	for (const char* c = begin; c < end; ++c)
+	{
+		// Anything other than a digit means the text is not a valid integer
+		if ((*c < '0') || (*c > '9') || (result > 2147483648LL)) return 0;
+		result = result*10 + (*c - '0');
+	}
+	if (negative) result = -result;
+	if ((result > 2147483647LL) || (result < -2147483648LL)) return 0;
+	return (int) result;
+}
+
+// Convert text to double
+double JournalScanner::toDouble(const char* begin, const char* end)
+{
+	return QByteArray::fromRawData(begin, end - begin).trimmed().toDouble();
+}
+
+/*
+ * Scanning
+ */
+
+// Scan attributes in specified range, returning the value of the 'name' attribute (if present)
+bool JournalScanner::nameAttribute(const char* begin, const char* end, QString& name)
+{
+	const char* c = begin;
+	while (c < end)
+	{
+		// Skip whitespace, and find end of attribute name
+		while ((c < end) && ((*c == ' ') || (*c == '\t') || (*c == '\n') || (*c == '\r'))) ++c;
+		const char* attrName = c;
+		while ((c < end) && (*c != '=') && (*c != ' ') && (*c != '\t') && (*c != '\n') && (*c != '\r')) ++c;
+		int attrNameLength = c - attrName;
+
+		// Find start and end of value
+		while ((c < end) && (*c != '"') && (*c != '\'')) ++c;
+		if (c == end) break;
+		char quote = *c;
+		const char* value = ++c;
+		while ((c < end) && (*c != quote)) ++c;
+		if (c == end) break;
+
+		if ((attrNameLength == 4) && (memcmp(attrName, "name", 4) == 0))
+		{
+			name = text(value, c);
+			return true;
+		}
+		++c;
+	}
+
+	return false;
+}
+
+// Scan NXentry contents into specified RunData
+bool JournalScanner::scanEntry(JournalViewer* parent, Instrument* inst, RunData* rd)
+{
+	while (true)
+	{
+		// Find next tag
+		const char* lt = (const char*) memchr(pos_, '<', end_ - pos_);
+		if (lt == NULL) return false;
+		pos_ = lt + 1;
+		if (pos_ >= end_) return false;
+
+		// Skip comments and processing instructions
+		if (*pos_ == '!')
+		{
+			if ((end_ - pos_ < 3) || (memcmp(pos_, "!--", 3) != 0)) return false;
+			if (!skipPast("-->", 3)) return false;
+			continue;
+		}
+		if (*pos_ == '?')
+		{
+			if (!skipPast("?>", 2)) return false;
+			continue;
+		}
+
+		// End tag - should be the NXentry's
+		if (*pos_ == '/')
+		{
+			++pos_;
+			int length = readName();
+			if ((length != 7) || (memcmp(pos_ - length, "NXentry", 7) != 0)) return false;
+			const char* gt = tagEnd();
+			if (gt == NULL) return false;
+			pos_ = gt + 1;
+			return true;
+		}
+
+		// Start of child element
+		const char* name = pos_;
+		int nameLength = readName();
+		const char* gt = tagEnd();
+		if (gt == NULL) return false;
+		pos_ = gt + 1;
+
+		// Locate element text
+		const char* textBegin = pos_, *textEnd = pos_;
+		if (gt[-1] != '/')
+		{
+			textEnd = (const char*) memchr(pos_, '<', end_ - pos_);
+			if (textEnd == NULL) return false;
+
+			// Text must be followed by the element's own end tag - anything else (nested elements, CDATA) we leave to a full XML reader
+			pos_ = textEnd;
+			if ((end_ - pos_ < nameLength + 3) || (pos_[1] != '/') || (memcmp(pos_ + 2, name, nameLength) != 0)) return false;
+			pos_ += nameLength + 2;
+			gt = tagEnd();
+			if ((gt == NULL) || (!isWhitespace(pos_, gt))) return false;
+			pos_ = gt + 1;
+		}
+
+		switch (property(name, nameLength))
+		{
+			case (RunProperty::Cycle):
+				rd->setCycle(ISIS::cycleIndex(text(textBegin, textEnd)));
+				break;
+			case (RunProperty::Duration):
+				rd->setDuration(toInt(textBegin, textEnd));
+				break;
+			case (RunProperty::EndTimeAndDate):
+				rd->setEndEpoch(ISIS::epochSeconds(textBegin, textEnd - textBegin));
+				break;
+			case (RunProperty::InstrumentName):
+				if (inst->instrument() != ISIS::LOCAL) break;
+				rd->setInstrument(parent->instrument(ISIS::instrument(text(textBegin, textEnd))));
+				break;
+			case (RunProperty::ProtonCharge):
+				rd->setProtonCharge(toDouble(textBegin, textEnd));
+				break;
+			case (RunProperty::RBNumber):
+				rd->setRBNumber(toInt(textBegin, textEnd));
+				break;
+			case (RunProperty::RunNumber):
+				rd->setRunNumber(toInt(textBegin, textEnd));
+				break;
+			case (RunProperty::StartTimeAndDate):
+				rd->setStartEpoch(ISIS::epochSeconds(textBegin, textEnd - textBegin));
+				break;
+			case (RunProperty::Title):
+				rd->setTitle(text(textBegin, textEnd));
+				break;
+			case (RunProperty::TotalMEvents):
+				rd->setTotalMEvents(toDouble(textBegin, textEnd));
+				break;
+			case (RunProperty::User):
+				rd->setUser(text(textBegin, textEnd));
+				break;
+			default:
+				break;
+		}
+	}
+
+	return false;
+}
+
+// Scan data, creating RunData (with values stored in the supplied catalogue) for each NXentry in the supplied list
+bool JournalScanner::scan(JournalViewer* parent, Journal* jrnl, RunCatalogue* catalogue, List<RunData>& entries)
+{
+	Instrument* inst = jrnl->parent();
+	bool rootClosed = false;
+	pos_ = begin_;
+
+	while (pos_ < end_)
+	{
+		// Find next tag
+		const char* lt = (const char*) memchr(pos_, '<', end_ - pos_);
+		if (lt == NULL) break;
+		pos_ = lt + 1;
+		if (pos_ >= end_) return false;
+
+		// Skip prolog / processing instructions, comments and doctype
+		if (*pos_ == '?')
+		{
+			if (!skipPast("?>", 2)) return false;
+			continue;
+		}
+		if (*pos_ == '!')
+		{
+			if ((end_ - pos_ >= 3) && (memcmp(pos_, "!--", 3) == 0))
+			{
+				if (!skipPast("-->", 3)) return false;
+			}
+			else if (!skipPast(">", 1)) return false;
+			continue;
+		}
+
+		// End tag?
+		bool closing = (*pos_ == '/');
+		if (closing) ++pos_;
+		const char* name = pos_;
+		int nameLength = readName();
+		const char* gt = tagEnd();
+		if (gt == NULL) return false;
+
+		if (closing)
+		{
+			if ((nameLength == 6) && (memcmp(name, "NXroot", 6) == 0)) rootClosed = true;
+			pos_ = gt + 1;
+			continue;
+		}
+
+		// Only interested in NXentry start tags from here on
+		if ((nameLength != 7) || (memcmp(name, "NXentry", 7) != 0))
+		{
+			pos_ = gt + 1;
+			continue;
+		}
+
+		// Create new RunData and set target instrument / journal
+		RunData* rd = new RunData(catalogue);
+		entries.own(rd);
+		rd->setInstrument(inst);
+		rd->setJournalSource(jrnl);
+
+		// Grab NXentry attributes (should just be 'name')
+		QString entryName;
+		if (nameAttribute(pos_, gt, entryName)) rd->setName(entryName);
+		else msg.print("Warning - NXentry has no 'name' attribute");
+		pos_ = gt + 1;
+
+		// Scan entry contents (unless it was an empty element)
+		if ((gt[-1] != '/') && (!scanEntry(parent, inst, rd))) return false;
+	}
+
+	return rootClosed;
+}
@@ -0,0 +1,95 @@
+/*
+	*** Journal Scanner
+	*** src/journalscanner.h
+	Copyright T. Youngs 2012-2016
+
+	This file is part of JournalViewer.
+
+	JournalViewer is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	JournalViewer is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with JournalViewer.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef JOURNALVIEWER_JOURNALSCANNER_H
+#define JOURNALVIEWER_JOURNALSCANNER_H
+
+#include "list.h"
+#include "rundata.h"
+#include <QByteArray>
+
+// Forward Declarations
+class JournalViewer;
+class Journal;
+
+/*
+ * Scanner for journal XML files (NXroot containing flat NXentry elements), working directly on the raw data.
+ * Anything outside the expected schema (nested child elements, CDATA sections etc.) causes scan() to fail, in which
+ * case the data should be parsed by a full XML reader instead.
+ */
+class JournalScanner
+{
+	public:
+	// Constructor
+	JournalScanner(const QByteArray& data, bool forceISOEncoding);
+
+
+	/*
+	 * Source Data
+	 */
+	private:
+	// Start and end of data
+	const char* begin_, *end_;
+	// Current scan position
+	const char* pos_;
+	// Whether text is encoded as ISO-8859-1 (rather than UTF-8)
+	bool latin1_;
+
+	private:
+	// Advance to the character following the next occurrence of the specified string
+	bool skipPast(const char* s, int length);
+	// Read element name at current position, returning its length
+	int readName();
+	// Find end of tag beginning at current position, returning the position of its closing '>'
+	const char* tagEnd();
+	// Return whether the specified range contains only whitespace
+	static bool isWhitespace(const char* begin, const char* end);
+
+
+	/*
+	 * Element / Value Conversion
+	 */
+	private:
+	// Return property for specified NXentry element name
+	static RunProperty::Property property(const char* name, int length);
+	// Convert text to QString, decoding any entities
+	QString text(const char* begin, const char* end);
+	// Convert text to integer
+	static int toInt(const char* begin, const char* end);
+	// Convert text to double
+	static double toDouble(const char* begin, const char* end);
+
+
+	/*
+	 * Scanning
+	 */
+	private:
+	// Scan attributes in specified range, returning the value of the 'name' attribute (if present)
+	bool nameAttribute(const char* begin, const char* end, QString& name);
+	// Scan NXentry contents into specified RunData
+	bool scanEntry(JournalViewer* parent, Instrument* inst, RunData* rd);
+
+	public:
+	// Scan data, creating RunData (with values stored in the supplied catalogue) for each NXentry in the supplied list
+	bool scan(JournalViewer* parent, Journal* jrnl, RunCatalogue* catalogue, List<RunData>& entries);
+};
+
+#endif
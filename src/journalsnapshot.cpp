@@ -0,0 +1,245 @@
+/*
+	*** Journal Snapshot
+	*** src/journalsnapshot.cpp
+	Copyright T. Youngs 2012-2016
+
+	This file is part of JournalViewer.
+
+	JournalViewer is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	JournalViewer is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with JournalViewer.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "journalsnapshot.h"
+#include "journal.h"
+#include "instrument.h"
+#include "jv.h"
+#include "messenger.hui"
+#include <QFile>
+#include <QSaveFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QVector>
+#include <QStandardPaths>
+#include <string.h>
+
+// Magic identifier
+const char snapshotMagic[8] = { 'J', 'V', 'S', 'N', 'A', 'P', '\0', '\0' };
+
+// Constructor
+JournalSnapshot::JournalSnapshot()
+{
+}
+
+/*
+ * Read / Write
+ */
+
+// Return snapshot filename for specified Journal
+QString JournalSnapshot::fileName(Journal* jrnl)
+{
+	QDir cacheDir(QStandardPaths::writableLocation(QStandardPaths::CacheLocation));
+	QString instrumentDir = (jrnl->parent() == NULL ? QString("unknown") : jrnl->parent()->ndxName());
+	return cacheDir.absoluteFilePath("snapshots/" + instrumentDir + "/" + jrnl->fileName() + ".jvs");
+}
+
+// Write snapshot of specified Journal's current RunData
+bool JournalSnapshot::write(Journal* jrnl, QDateTime modificationTime)
+{
+	if (!modificationTime.isValid()) return false;
+
+	QString snapshotFile = fileName(jrnl);
+	QDir dir = QFileInfo(snapshotFile).absoluteDir();
+	if ((!dir.exists()) && (!dir.mkpath(dir.path())))
+	{
+		msg.print("JournalSnapshot::write() - Failed to create snapshot directory '" + dir.path() + "'.");
+		return false;
+	}
+
+	// Construct run records and string table
+	QVector<Run> runs;
+	runs.reserve(jrnl->runData().nItems());
+	QHash<QString,quint32> stringIds;
+	QVector<quint32> stringIndex;
+	QString stringData;
+	Run run;
+	for (RunData* rd = jrnl->runData().first(); rd != NULL; rd = rd->next)
+	{
+		QString strings[4] = { rd->name(), rd->title(), rd->user(), rd->cycle() < 0 ? QString() : ISIS::cycleText(rd->cycle()) };
+		quint32 ids[4];
+		for (int n=0; n<4; ++n)
+		{
+			QHash<QString,quint32>::const_iterator it = stringIds.constFind(strings[n]);
+			if (it != stringIds.constEnd()) ids[n] = it.value();
+			else
+			{
+				ids[n] = stringIds.count();
+				stringIds.insert(strings[n], ids[n]);
+				stringIndex << stringData.length() << strings[n].length();
+				stringData += strings[n];
+			}
+		}
+
+		run.runNumber = rd->runNumber();
+		run.rbNumber = rd->rbNumber();
+		run.duration = rd->duration();
+		run.instrument = (rd->instrument() == NULL ? ISIS::nInstruments : rd->instrument()->instrument());
+		run.name = ids[0];
+		run.title = ids[1];
+		run.user = ids[2];
+		run.cycle = ids[3];
+		run.protonCharge = rd->protonCharge();
+		run.totalMEvents = rd->totalMEvents();
+		run.startTime = rd->startEpoch() == ISIS::invalidTime ? -1 : rd->startEpoch()*1000;
+		run.endTime = rd->endEpoch() == ISIS::invalidTime ? -1 : rd->endEpoch()*1000;
+		runs << run;
+	}
+
+	// Construct header
+	Header header;
+	memcpy(header.magic, snapshotMagic, 8);
+	header.version = formatVersion;
+	header.nRuns = runs.count();
+	header.modificationTime = modificationTime.toMSecsSinceEpoch();
+	header.lastEntryOffset = jrnl->lastEntryOffset();
+	header.nStrings = stringIds.count();
+	header.stringDataSize = stringData.length();
+
+	// Write the file (atomically, so a partially-written snapshot is never read back)
+	QSaveFile file(snapshotFile);
+	if (!file.open(QIODevice::WriteOnly))
+	{
+		msg.print("JournalSnapshot::write() - Failed to open snapshot file '" + snapshotFile + "' for writing.");
+		return false;
+	}
+	file.write((const char*) &header, sizeof(Header));
+	file.write((const char*) runs.constData(), runs.count()*sizeof(Run));
+	file.write((const char*) stringIndex.constData(), stringIndex.count()*sizeof(quint32));
+	file.write((const char*) stringData.constData(), stringData.length()*sizeof(QChar));
+	if (!file.commit())
+	{
+		msg.print("JournalSnapshot::write() - Failed to write snapshot file '" + snapshotFile + "'.");
+		return false;
+	}
+
+	msg.print("Wrote snapshot of journal '%s' (%i runs, %i strings).", qPrintable(jrnl->name()), header.nRuns, header.nStrings);
+
+	return true;
+}
+
+// Read snapshot for specified Journal, provided it matches the modification time given
+bool JournalSnapshot::read(JournalViewer* parent, Journal* jrnl, QDateTime modificationTime)
+{
+	if (!modificationTime.isValid()) return false;
+
+	QString snapshotFile = fileName(jrnl);
+	if (!QFile::exists(snapshotFile)) return false;
+
+	QFile file(snapshotFile);
+	if (!file.open(QIODevice::ReadOnly))
+	{
+		msg.print("JournalSnapshot::read() - Can't open snapshot file '" + snapshotFile + "' for reading.");
+		return false;
+	}
+	qint64 fileSize = file.size();
+	if (fileSize < (qint64) sizeof(Header)) return false;
+
+	// Map the file and check the header
+	const uchar* data = file.map(0, fileSize);
+	if (data == NULL)
+	{
+		msg.print("JournalSnapshot::read() - Failed to map snapshot file '" + snapshotFile + "'.");
+		return false;
+	}
+	const Header* header = (const Header*) data;
+	if ((memcmp(header->magic, snapshotMagic, 8) != 0) || (header->version != formatVersion))
+	{
+		msg.print("JournalSnapshot::read() - Snapshot file '" + snapshotFile + "' has an unrecognised format - ignored.");
+		return false;
+	}
+	if (header->modificationTime != modificationTime.toMSecsSinceEpoch())
+	{
+		msg.print("Snapshot for journal '" + jrnl->name() + "' is out of date - ignored.");
+		return false;
+	}
+	qint64 expectedSize = sizeof(Header) + qint64(header->nRuns)*sizeof(Run) + qint64(header->nStrings)*2*sizeof(quint32) + qint64(header->stringDataSize)*sizeof(QChar);
+	if (expectedSize != fileSize)
+	{
+		msg.print("JournalSnapshot::read() - Snapshot file '" + snapshotFile + "' is truncated or corrupt - ignored.");
+		return false;
+	}
+
+	// Set up pointers to the sections of the file
+	const Run* runs = (const Run*) (data + sizeof(Header));
+	const quint32* stringIndex = (const quint32*) (runs + header->nRuns);
+	const QChar* stringData = (const QChar*) (stringIndex + 2*header->nStrings);
+
+	// Convert string table - strings are interned into the shared string pool (or cycle pool) the first time they are encountered
+	QVector<QString> strings(header->nStrings);
+	QVector<int> stringIds(header->nStrings, -1), cycleIndices(header->nStrings, -1);
+	for (quint32 n=0; n<header->nStrings; ++n)
+	{
+		quint32 offset = stringIndex[n*2], length = stringIndex[n*2+1];
+		if ((offset + length) > header->stringDataSize)
+		{
+			msg.print("JournalSnapshot::read() - Snapshot file '" + snapshotFile + "' has a corrupt string table - ignored.");
+			return false;
+		}
+		strings[n] = QString(stringData+offset, length);
+	}
+
+	// Check string ids in run records before we touch the Journal
+	for (quint32 n=0; n<header->nRuns; ++n)
+	{
+		const Run& run = runs[n];
+		if ((run.name >= header->nStrings) || (run.title >= header->nStrings) || (run.user >= header->nStrings) || (run.cycle >= header->nStrings))
+		{
+			msg.print("JournalSnapshot::read() - Snapshot file '" + snapshotFile + "' has a corrupt run table - ignored.");
+			return false;
+		}
+	}
+
+	// All good - recreate RunData in Journal
+	Instrument* inst = jrnl->parent();
+	jrnl->clearRunData();
+	jrnl->catalogue()->reserve(header->nRuns);
+	for (quint32 n=0; n<header->nRuns; ++n)
+	{
+		const Run& run = runs[n];
+		RunData* rd = new RunData(jrnl->catalogue());
+		if ((inst == NULL) || (run.instrument == inst->instrument())) rd->setInstrument(inst);
+		else if ((run.instrument >= 0) && (run.instrument < ISIS::nInstruments)) rd->setInstrument(parent->instrument((ISIS::ISISInstrument) run.instrument));
+		else rd->setInstrument(NULL);
+		rd->setJournalSource(jrnl);
+		if (stringIds[run.name] == -1) stringIds[run.name] = RunCatalogue::stringId(strings[run.name]);
+		if (stringIds[run.title] == -1) stringIds[run.title] = RunCatalogue::stringId(strings[run.title]);
+		if (stringIds[run.user] == -1) stringIds[run.user] = RunCatalogue::stringId(strings[run.user]);
+		jrnl->catalogue()->setNameId(rd->row(), stringIds[run.name]);
+		rd->setRunNumber(run.runNumber);
+		jrnl->catalogue()->setTitleId(rd->row(), stringIds[run.title]);
+		rd->setRBNumber(run.rbNumber);
+		jrnl->catalogue()->setUserId(rd->row(), stringIds[run.user]);
+		rd->setProtonCharge(run.protonCharge);
+		rd->setDuration(run.duration);
+		rd->setStartEpoch(run.startTime == -1 ? ISIS::invalidTime : run.startTime/1000);
+		rd->setEndEpoch(run.endTime == -1 ? ISIS::invalidTime : run.endTime/1000);
+		if ((cycleIndices[run.cycle] == -1) && (!strings[run.cycle].isEmpty())) cycleIndices[run.cycle] = ISIS::cycleIndex(strings[run.cycle]);
+		rd->setCycle(cycleIndices[run.cycle]);
+		rd->setTotalMEvents(run.totalMEvents);
+		jrnl->addRunData(rd);
+	}
+	jrnl->setLastEntryOffset(header->lastEntryOffset);
+
+	msg.print("Loaded journal '%s' from snapshot (%i runs).", qPrintable(jrnl->name()), header->nRuns);
+
+	return true;
+}
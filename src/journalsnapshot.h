@@ -0,0 +1,107 @@
+/*
+	*** Journal Snapshot
+	*** src/journalsnapshot.h
+	Copyright T. Youngs 2012-2016
+
+	This file is part of JournalViewer.
+
+	JournalViewer is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	JournalViewer is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with JournalViewer.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef JOURNALVIEWER_JOURNALSNAPSHOT_H
+#define JOURNALVIEWER_JOURNALSNAPSHOT_H
+
+#include <QString>
+#include <QDateTime>
+
+// Forward Declarations
+class JournalViewer;
+class Journal;
+
+/*
+ * Binary snapshot of a parsed Journal, stored in the user's cache location and keyed by the modification time of the source it was parsed from.
+ * Layout (native byte order):
+ *   Header
+ *   Run records (fixed width, Header::nRuns of them)
+ *   String index (Header::nStrings pairs of QChar offset / length)
+ *   String data (UTF-16)
+ */
+class JournalSnapshot
+{
+	public:
+	// Constructor
+	JournalSnapshot();
+
+
+	/*
+	 * File Format
+	 */
+	public:
+	// Format version (increment whenever Header or Run changes)
+	static const quint32 formatVersion = 2;
+
+	// File header
+	struct Header
+	{
+		// Magic identifier
+		char magic[8];
+		// Format version
+		quint32 version;
+		// Number of runs in file
+		quint32 nRuns;
+		// Modification time (ms since epoch, UTC) of the journal source
+		qint64 modificationTime;
+		// Byte offset in journal source immediately following the last complete NXentry
+		qint64 lastEntryOffset;
+		// Number of strings in string table
+		quint32 nStrings;
+		// Size of string data (in QChars)
+		quint32 stringDataSize;
+	};
+
+	// Fixed-width run record
+	struct Run
+	{
+		// Run number
+		qint32 runNumber;
+		// RB number
+		qint32 rbNumber;
+		// Duration (seconds)
+		qint32 duration;
+		// Source instrument (ISIS::ISISInstrument)
+		qint32 instrument;
+		// String ids (into string table)
+		quint32 name, title, user, cycle;
+		// Proton charge (uAmps)
+		double protonCharge;
+		// Total MEvents
+		double totalMEvents;
+		// Start / end times (ms since epoch, UTC, or -1 if invalid)
+		qint64 startTime, endTime;
+	};
+
+
+	/*
+	 * Read / Write
+	 */
+	public:
+	// Return snapshot filename for specified Journal
+	static QString fileName(Journal* jrnl);
+	// Write snapshot of specified Journal's current RunData
+	static bool write(Journal* jrnl, QDateTime modificationTime);
+	// Read snapshot for specified Journal, provided it matches the modification time given
+	static bool read(JournalViewer* parent, Journal* jrnl, QDateTime modificationTime);
+};
+
+#endif
@@ -25,10 +25,24 @@
 #include "ui_jv.h"
 #include "list.h"
 #include "rundata.h"
+#include "runindex.h"
+#include "intervalindex.h"
+#include "trigramindex.h"
+#include "runfilter.h"
+#include "facetindex.h"
+#include "rungrouping.h"
+#include "runtablemodel.h"
+#include "searchtask.h"
 #include "instrument.h"
 #include "logwindow.h"
+#include "journalloadresult.h"
+#include "indexloadresult.h"
 #include <QDir>
+#include <QSet>
 #include <QTimer>
+#include <QThreadPool>
+#include <QElapsedTimer>
+#include <QJsonObject>
 #include <QtPrintSupport/QPrinter>
 
 // Forward Declarations
@@ -38,9 +52,12 @@ class QPushButton;
 class QProgressBar;
 class LogWindow;
 class FindWindow;
+class MemoryWindow;
+class RunningWindow;
 class PrintSetup;
 class Document;
 class DataInterface;
+class QSettings;
 
 class JournalViewer : public QMainWindow
 {
@@ -86,6 +103,8 @@ class JournalViewer : public QMainWindow
 	// -- Search Panel
 	// Search text entered
 	void on_SearchEdit_returnPressed();
+	// Search text edited
+	void on_SearchEdit_textEdited(QString text);
 	// Search style changed
 	void on_SearchStyleCombo_currentIndexChanged(int index);
 	// Search box clear button pressed
@@ -125,9 +144,9 @@ class JournalViewer : public QMainWindow
 	// Header of data table clicked
 	void dataTable_headerClicked(int section);
 	// Table cell single-clicked
-	void on_DataTable_itemClicked(QTableWidgetItem* item);
+	void on_DataTable_clicked(const QModelIndex& index);
 	// Table cell double-clicked
-	void on_DataTable_itemDoubleClicked(QTableWidgetItem* item);
+	void on_DataTable_doubleClicked(const QModelIndex& index);
 	// Context menu event
 	void dataTable_contextMenuEvent(const QPoint& pos);
 	
@@ -166,6 +185,10 @@ class JournalViewer : public QMainWindow
 	void on_actionToolsFindNext_triggered(bool checked);
 	// Tools->FindPrevious selected
 	void on_actionToolsFindPrevious_triggered(bool checked);
+	// Tools->Go To Run selected
+	void on_actionToolsGoToRun_triggered(bool checked);
+	// Tools->Runs At Time selected
+	void on_actionToolsRunsAtTime_triggered(bool checked);
 	// Tools->Reload Data selected
 	void on_actionToolsReloadData_triggered(bool checked);
 	// Tools->GroupData selected
@@ -180,6 +203,8 @@ class JournalViewer : public QMainWindow
 	void on_actionToolsSettings_triggered(bool checked);
 	// Tools->Log Window selected
 	void on_actionToolsLogWindow_triggered(bool checked);
+	// Tools->Memory Usage selected
+	void on_actionToolsMemoryUsage_triggered(bool checked);
 	// Tools->Regenerate Local Journals selected
 	void on_actionToolsRegenerateLocalJournals_triggered(bool checked);
 	// Tools->Show License selected
@@ -203,6 +228,8 @@ class JournalViewer : public QMainWindow
 	LogWindow* logWindow_;
 	// FindWindow Dialog
 	FindWindow* findWindow_;
+	// MemoryWindow Dialog
+	MemoryWindow* memoryWindow_;
 	// Label for displaying date / source information in status bar
 	QLabel* statusSourceLabel_;
 	// Label for displaying search / filter data
@@ -253,6 +280,8 @@ class JournalViewer : public QMainWindow
 	JournalAccess journalAccessType_;
 	// Preferred source for loading SE block data
 	RunData::BlockDataSource blockDataSource_;
+	// Memory budget (MB) for loaded block data (zero for unlimited)
+	int blockDataMemoryBudget_;
 	// Default Instrument to display
 	ISIS::ISISInstrument defaultInstrument_;
 	// Colours for CSS
@@ -321,6 +350,10 @@ class JournalViewer : public QMainWindow
 	void setBlockDataSource(RunData::BlockDataSource source);
 	// Return preferred source for loading SE block data
 	RunData::BlockDataSource blockDataSource();
+	// Set memory budget (MB) for loaded block data (zero for unlimited)
+	void setBlockDataMemoryBudget(int mb);
+	// Return memory budget (MB) for loaded block data
+	int blockDataMemoryBudget();
 	// Return default Instrument to display
 	ISIS::ISISInstrument defaultInstrument();
 	// Set default Instrument to display
@@ -407,6 +440,44 @@ class JournalViewer : public QMainWindow
 	Instrument* currentInstrument_;
 	// Currently-selected journal entry
 	Journal* currentJournal_;
+	// Thread pool for concurrent journal loading
+	QThreadPool journalLoaderPool_;
+	// Number of journal loaders still running
+	int nPendingJournalLoads_;
+	// Whether the running journal loaders are updating (rather than replacing) the displayed data
+	bool updatingJournalData_;
+	// Timer triggering background preload of instrument data when idle
+	QTimer preloadTimer_;
+	// Instrument most recently selected for background preload
+	Instrument* preloadInstrument_;
+	// Whether a background preload task is running
+	bool preloadRunning_;
+	// Whether background preloading is enabled
+	bool preloadEnabled_;
+	// Journals whose data is being loaded in a pool thread (and so must not be looked at until it has arrived)
+	QSet<Journal*> loadingJournals_;
+	// Instrument to select, journal to select (by name), and whether to update the current journal, once the running preload has finished
+	Instrument* deferredInstrument_;
+	QString deferredJournal_;
+	bool deferredUpdate_;
+	// Whether to re-initialise once the running preload has finished
+	bool deferredInitialise_;
+
+	public:
+	// Time (seconds) after which cached index / journal data is revalidated against its source
+	static const int revalidationInterval = 600;
+
+	private:
+	// Finalise loading of journal index, parsing its data into the target Instrument
+	bool finaliseIndexLoad(const IndexLoadResult& result);
+	// Return whether a background preload of the specified instrument is running
+	bool preloading(Instrument* inst);
+	// Background preload task has finished, so carry on with anything that was deferred until it had
+	void preloadTaskFinished();
+	// Remove specified journal's runs from the run, interval, filter and facet indexes
+	void unindexJournal(Journal* jrnl);
+	// Remove all journals of specified instrument from the run, interval, filter and facet indexes
+	void unindexInstrument(Instrument* inst);
 
 	public:
 	// Add new instrument
@@ -421,11 +492,72 @@ class JournalViewer : public QMainWindow
 	void setJournal(Journal* jrnl);
 	// Load specified journal data
 	bool loadJournalData(Journal* jrnl, bool addUniqueOnly);
+	// Load data for all journals of the current instrument concurrently, newest first
+	void loadAllJournalData(bool updateOnly);
+	// Update limits, filters and controls now that new journal data has been loaded
+	void journalDataLoaded(bool updateOnly);
+	// Finalise loading of journal data, optionally adding its RunData to the current list
+	bool finaliseJournalLoad(const JournalLoadResult& result, bool addToRunData = true);
+	// Return access type to use for the specified instrument's index and journals
+	JournalViewer::JournalAccess effectiveAccessType(Instrument* inst);
 
 	public slots:
 	// Update current journal data
 	bool updateJournalData();
 
+	private slots:
+	// Journal loader has finished
+	void journalLoaderFinished(JournalLoadResult result);
+	// Start background preload of next instrument's index and current journal
+	void preloadNext();
+	// Background index preload has finished
+	void indexPreloadFinished(IndexLoadResult result);
+	// Background journal preload has finished
+	void journalPreloadFinished(JournalLoadResult result);
+
+
+	/*
+	 * Startup / Revalidation
+	 */
+	private:
+	// Timer measuring time from construction to the first populated table
+	QElapsedTimer startupTimer_;
+	// Whether index and journal data are being loaded from local (cached) sources only
+	bool startingFromCache_;
+	// Name of journal to select once the startup instrument has been set
+	QString startupJournal_;
+	// Sort property and order to restore once the startup table has been populated
+	RunProperty::Property startupSortProperty_;
+	Qt::SortOrder startupSortOrder_;
+	// Number of background revalidation loaders still running
+	int nPendingRevalidations_;
+	// Whether a background revalidation is re-selecting the current journal (and so must not wait for itself)
+	bool reselectingJournal_;
+	// Whether revalidation must wait until the current journal's data has been loaded
+	bool revalidateAfterLoad_;
+
+	public:
+	// Time budget (ms) for showing the first populated table on startup
+	static const int firstTableBudget = 1000;
+
+	private:
+	// Store current session state (instrument, journal, filters and sort order)
+	void storeSession(QSettings& settings);
+	// Retrieve previous session state, returning the instrument that was displayed
+	ISIS::ISISInstrument retrieveSession(QSettings& settings);
+	// Start background revalidation of the current instrument's index and journal data
+	void revalidate();
+	// Start background revalidation of the current journal data
+	void revalidateJournals();
+	// Background revalidation task has finished
+	void revalidationTaskFinished();
+
+	private slots:
+	// Background index revalidation has finished
+	void revalidationIndexFinished(IndexLoadResult result);
+	// Background journal revalidation has finished
+	void revalidationJournalFinished(JournalLoadResult result);
+
 
 	/*
 	 * Local Data
@@ -467,6 +599,10 @@ class JournalViewer : public QMainWindow
 	List<RunProperty> visibleProperties_;
 	// Number of items in runData that are visible
 	int nRunDataVisible_;
+	// Model of the data table, serving the visible runs
+	RunTableModel dataTableModel_;
+	// Visible runs shown in the data table, in run list order (as supplied to the model)
+	QVector<RunData*> tableRuns_;
 	// Whether view by group is enabled
 	bool viewByGroup_;
 	// Stored filter limits
@@ -485,6 +621,8 @@ class JournalViewer : public QMainWindow
 	int lastFindMatchIndex_;
 
 	private:
+	// Return the distinct journals whose runs are in runData_, in order of first appearance
+	QVector<Journal*> runDataJournals();
 	// Determine limits, including construction of unique lists
 	void findFilterLimits();
 	// Store current filter values
@@ -497,6 +635,10 @@ class JournalViewer : public QMainWindow
 	void createGroups();
 	// Update data table
 	void updateDataTable();
+	// Set column widths of data table, estimated from a sample of its rows
+	void estimateDataTableColumnWidths();
+	// Select (exclusively) specified rows of the data table
+	void selectDataTableRows(QVector<int> rows);
 	// Filter run data
 	void filterRunData();
 	// Update data table highlighting
@@ -527,9 +669,145 @@ class JournalViewer : public QMainWindow
 	bool findPrevious();
 
 
+	/*
+	 * Run Index
+	 */
+	private:
+	// Index of runs in all loaded journals, by instrument and run number
+	RunIndex runIndex_;
+
+	public:
+	// Return RunData for specified run of instrument (or NULL if it is not loaded)
+	RunData* findRun(Instrument* inst, int runNumber);
+	// Select specified run of current instrument in the data table, changing journal if necessary
+	bool goToRun(int runNumber);
+
+
+	/*
+	 * Run Intervals
+	 */
+	private:
+	// Index of the start and end times of runs in all loaded journals
+	IntervalIndex intervalIndex_;
+	// Dialog showing runs in progress at a given time
+	RunningWindow* runningWindow_;
+
+	public:
+	// Return runs of all instruments overlapping the (inclusive) time range (seconds since epoch), in order of start time
+	QVector<RunData*> runsOverlapping(qint64 fromTime, qint64 toTime);
+	// Change to specified instrument and select run in the data table, changing journal if necessary
+	bool goToRun(Instrument* inst, int runNumber);
+
+
+	/*
+	 * Run Filter
+	 */
+	private:
+	// Cached filter bitsets over the runs of loaded journals
+	RunFilter runFilter_;
+
+
+	/*
+	 * Facets
+	 */
+	private:
+	// Users, RB numbers and cycles of the runs in loaded journals
+	FacetIndex facetIndex_;
+
+	private:
+	// Set up filter combo to show run counts and proton charge alongside each value
+	void setupFacetCombo(QComboBox* combo);
+	// Update run counts and proton charge of each value shown in filter combo
+	void updateFacetCombo(QComboBox* combo, FacetIndex::Facet facet);
+	// Update run counts and proton charge shown for users, RB numbers and cycles
+	void updateFacetCounts();
+
+
+	/*
+	 * Grouping
+	 */
+	private:
+	// Groups of the runs in the data table, by exact title (shared by table grouping, Select Similar and Sample Report)
+	RunGrouping tableGrouping_;
+
+	private:
+	// Group runs in the data table (in display order), reusing the cached groups if the table is unchanged
+	RunGrouping& tableGrouping();
+
+
+	/*
+	 * Title Index
+	 */
+	private:
+	// Trigram index of the strings in the shared string pool (titles, users etc.)
+	TrigramIndex titleIndex_;
+
+	private:
+	// Update title index and initialise match cache for the supplied expression, ruling out titles which cannot match
+	void prepareTitleMatches(const QRegExp& expr, QVector<int>& matches);
+	// Return whether the title with specified string id matches the supplied expression, caching the result
+	bool titleMatches(int titleId, const QRegExp& expr, QVector<int>& matches);
+	// Create search expression from text in the specified style
+	QRegExp searchExpression(QString text, JournalViewer::SearchStyle style, bool caseSensitive);
+
+
+	/*
+	 * Background Search
+	 */
+	private:
+	// Timer delaying the title search until typing pauses
+	QTimer searchTimer_;
+	// Thread pool for background searches
+	QThreadPool searchPool_;
+	// Background title search in progress (if any)
+	SearchHandle titleSearch_;
+	// Background Find in progress (if any)
+	SearchHandle findSearch_;
+
+	private:
+	// Resolve title matches for the supplied title ids, starting a background search (whose handle is returned) unless there are only a few to test
+	SearchHandle startSearch(const QRegExp& expr, const QVector<int>& titleIds, QVector<int>& matches, const char* finishedSlot);
+	// Apply resolved title matches to the run filter, updating the data table
+	void applyTitleMatches(const QRegExp& expr, const QVector<int>& matches);
+	// Return title ids of the runs in the data table, in display order (-1 for rows with no run)
+	QVector<int> tableTitleIds();
+	// Set Find matches from the runs in the data table, returning the number of matches
+	int setFindMatches(const QRegExp& expr, QVector<int>& matches);
+
+	public:
+	// Start Find in the background, emitting findFinished() when it is done
+	void startFind(QString text, JournalViewer::SearchStyle style, bool caseSensitive);
+	// Cancel any Find running in the background
+	void cancelFind();
+
+	private slots:
+	// Start title search for the current search text
+	void startTitleSearch();
+	// Background title search has finished
+	void titleSearchFinished(int searchId, QRegExp expr, QVector<int> matches);
+	// Background Find has finished
+	void findSearchFinished(int searchId, QRegExp expr, QVector<int> matches);
+
+	signals:
+	// Find has finished
+	void findFinished(int nMatches);
+
+
+	/*
+	 * Memory Accounting
+	 */
+	public:
+	// Return report of estimated memory used by journals, block data, plots etc.
+	QJsonObject memoryReport();
+
+
 	/*
 	 * CLI Control Interface
 	 */
+	private:
+	// Display supplied runs, formatted in columns of the visible properties
+	void printRuns(RefList<RunData,Journal*>& runs);
+
 	public:
 	// Change current journal
 	bool changeJournal(const char* journalName);
@@ -539,6 +817,12 @@ class JournalViewer : public QMainWindow
 	void showJournals();
 	// Search for and display runs matching supplied string / search style
 	bool searchRuns(QString searchString, QRegExp::PatternSyntax searchType);
+	// Display runs of current instrument in specified run number range ('<run>' or '<first>-<last>')
+	bool showRuns(const char* runRange);
+	// Display runs of all instruments in progress at specified time ('<time>'), or overlapping specified range ('<from>,<to>')
+	bool showRunsAtTime(const char* timeRange);
+	// Write memory report as JSON to specified file (or stdout if NULL)
+	bool dumpMemoryReport(const char* fileName);
 };
 
 #endif
@@ -22,8 +22,11 @@
 #include "jv.h"
 #include "instrument.h"
 #include "datainterface.h"
+#include "stringmatcher.h"
 #include "messenger.hui"
 #include <QRegExp>
+#include <QJsonDocument>
+#include <QFile>
 
 // Change current journal
 bool JournalViewer::changeJournal(const char* journalName)
@@ -103,32 +106,16 @@ void JournalViewer::showJournals()
 	if (!cycleStrings.isEmpty()) msg.print(cycleStrings);
 }
 
-// Search for and display runs matching supplied string / search style
-bool JournalViewer::searchRuns(QString searchString, QRegExp::PatternSyntax searchType)
+// Display supplied runs, formatted in columns of the visible properties
+void JournalViewer::printRuns(RefList<RunData,Journal*>& runs)
 {
-	// Construct a regexp from the supplied text
-	QRegExp re(searchString);
-	re.setPatternSyntax(searchType);
-	if (!re.isValid())
-	{
-		msg.print("Error: Search string is invalid. No search performed.");
-		return false;
-	}
-
-	// We will store matching runs in a reflist for now, also storing the character lengths of the visible properties so we can print it out nicely
-	RefList<RunData, Journal*> matches;
+	// Determine the character lengths of the visible properties so we can print them out nicely
 	int columnWidths[visibleProperties_.nItems()];
 	int n;
 	for (n=0; n<visibleProperties_.nItems(); ++n) columnWidths[n] = -1;
-	for (RefListItem<RunData,Journal*>* ri = runData_.first(); ri != NULL; ri = ri->next)
+	for (RefListItem<RunData,Journal*>* ri = runs.first(); ri != NULL; ri = ri->next)
 	{
 		RunData* rd = ri->item;
-
-		// Is this a match?
-		if (re.indexIn(rd->title()) == -1) continue;
-
-		// Add run to our reflist, and store character lengths
-		matches.add(rd);
 		n = 0;
 		for (RunProperty* property = visibleProperties_.first(); property != NULL; property = property->next, ++n)
 		{
@@ -138,10 +125,7 @@ bool JournalViewer::searchRuns(QString searchString, QRegExp::PatternSyntax sear
 	}
 
 	// Print out data in a nice format
-	QString format;
-	n = 0;
-	for (RunProperty* property = visibleProperties_.first(); property != NULL; property = property->next, ++n) format += "%"+QString::number(columnWidths[n])+"s  ";
-	for (RefListItem<RunData,Journal*>* ri = matches.first(); ri != NULL; ri = ri->next)
+	for (RefListItem<RunData,Journal*>* ri = runs.first(); ri != NULL; ri = ri->next)
 	{
 		RunData* rd = ri->item;
 
@@ -151,7 +135,137 @@ bool JournalViewer::searchRuns(QString searchString, QRegExp::PatternSyntax sear
 		msg.print(data);
 	}
 	msg.print("");
+}
+
+// Search for and display runs matching supplied string / search style
+bool JournalViewer::searchRuns(QString searchString, QRegExp::PatternSyntax searchType)
+{
+	// Construct a regexp from the supplied text
+	QRegExp re(searchString);
+	re.setPatternSyntax(searchType);
+	if (!re.isValid())
+	{
+		msg.print("Error: Search string is invalid. No search performed.");
+		return false;
+	}
+
+	// We will store matching runs in a reflist for now
+	RefList<RunData, Journal*> matches;
+	QVector<int> titleIds, titleMatchCache;
+	titleIds.reserve(runData_.nItems());
+	for (RefListItem<RunData,Journal*>* ri = runData_.first(); ri != NULL; ri = ri->next) titleIds.append(ri->item->titleId());
+	prepareTitleMatches(re, titleMatchCache);
+	StringMatcher::match(re, titleIds.constData(), titleIds.count(), titleMatchCache);
+	for (RefListItem<RunData,Journal*>* ri = runData_.first(); ri != NULL; ri = ri->next)
+	{
+		RunData* rd = ri->item;
+
+		// Is this a match?
+		if (!titleMatches(rd->titleId(), re, titleMatchCache)) continue;
+
+		matches.add(rd, ri->data);
+	}
+
+	printRuns(matches);
 	msg.print("%i matching run(s).", matches.nItems());
 
 	return true;
 }
+
+// Display runs of current instrument in specified run number range ('<run>' or '<first>-<last>')
+bool JournalViewer::showRuns(const char* runRange)
+{
+	if (currentInstrument_ == NULL) return false;
+
+	// Parse run number, or range of run numbers
+	QStringList parts = QString(runRange).split('-');
+	bool firstOk = false, lastOk = false;
+	int firstRun = parts.at(0).toInt(&firstOk);
+	int lastRun = (parts.count() == 2 ? parts.at(1).toInt(&lastOk) : firstRun);
+	if (parts.count() == 1) lastOk = firstOk;
+	if ((!firstOk) || (!lastOk) || (parts.count() > 2))
+	{
+		msg.print("Error: Invalid run number or range '%s'.", runRange);
+		return false;
+	}
+
+	// Retrieve runs straight from the run index, which covers all loaded journals
+	RefList<RunData, Journal*> runs;
+	if (firstRun == lastRun)
+	{
+		RunData* rd = findRun(currentInstrument_, firstRun);
+		if (rd != NULL) runs.add(rd, rd->journalSource());
+	}
+	else
+	{
+		QVector<RunData*> range = runIndex_.range(currentInstrument_->instrument(), firstRun, lastRun);
+		for (int n=0; n<range.count(); ++n) runs.add(range.at(n), range.at(n)->journalSource());
+	}
+
+	printRuns(runs);
+	msg.print("%i run(s) found in loaded journals.", runs.nItems());
+	if (runs.nItems() == 0) msg.print("Only loaded journals are searched - use '-j All' to load all journals for the current instrument.");
+
+	return true;
+}
+
+// Display runs of all instruments in progress at specified time ('<time>'), or overlapping specified range ('<from>,<to>')
+bool JournalViewer::showRunsAtTime(const char* timeRange)
+{
+	// Parse time, or range of times (in the same format as the journals, e.g. '2016-03-14T09:26:53')
+	QStringList parts = QString(timeRange).split(',');
+	qint64 fromTime = ISIS::epochSeconds(parts.at(0).trimmed());
+	qint64 toTime = (parts.count() == 2 ? ISIS::epochSeconds(parts.at(1).trimmed()) : fromTime);
+	if ((fromTime == ISIS::invalidTime) || (toTime == ISIS::invalidTime) || (parts.count() > 2))
+	{
+		msg.print("Error: Invalid time or range '%s' (expected e.g. '2016-03-14T09:26:53' or '2016-03-14T09:00:00,2016-03-14T10:00:00').", timeRange);
+		return false;
+	}
+	if (toTime < fromTime)
+	{
+		msg.print("Error: End of time range '%s' is before its start.", timeRange);
+		return false;
+	}
+
+	// Retrieve runs straight from the interval index, which covers all loaded journals of all instruments
+	QVector<RunData*> runs = runsOverlapping(fromTime, toTime);
+
+	// Display runs of each instrument in turn, in order of start time
+	for (Instrument* inst = instruments_.first(); inst != NULL; inst = inst->next)
+	{
+		RefList<RunData, Journal*> instrumentRuns;
+		for (int n=0; n<runs.count(); ++n) if (runs.at(n)->journalSource()->parent() == inst) instrumentRuns.add(runs.at(n), runs.at(n)->journalSource());
+		if (instrumentRuns.nItems() == 0) continue;
+
+		msg.print("%s:", qPrintable(inst->capitalisedName()));
+		printRuns(instrumentRuns);
+	}
+	msg.print("%i run(s) found in loaded journals.", runs.count());
+	if (runs.count() == 0) msg.print("Only loaded journals are searched - use '-j All' to load all journals for the current instrument.");
+
+	return true;
+}
+
+// Write memory report as JSON to specified file (or stdout if NULL)
+bool JournalViewer::dumpMemoryReport(const char* fileName)
+{
+	QByteArray json = QJsonDocument(memoryReport()).toJson(QJsonDocument::Indented);
+
+	if (fileName == NULL)
+	{
+		printf("%s", json.constData());
+		return true;
+	}
+
+	QFile file(fileName);
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Text))
+	{
+		msg.print("Error: Couldn't open file '%s' for writing.", fileName);
+		return false;
+	}
+	file.write(json);
+	file.close();
+	msg.print("Memory report written to '%s'.", fileName);
+
+	return true;
+}
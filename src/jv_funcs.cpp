@@ -25,7 +25,6 @@
 #include "version.h"
 #include "datainterface.h"
 #include "document.h"
-#include "ttablewidgetitem.h"
 #include "isis.h"
 #include "reflist.h"
 #include "messenger.hui"
@@ -33,6 +32,8 @@
 #include "quickreport.h"
 #include "licensewindow.h"
 #include "findwindow.h"
+#include "memorywindow.h"
+#include "runningwindow.h"
 #include <QFileDialog>
 #include <QMessageBox>
 #include <QPushButton>
@@ -41,6 +42,7 @@
 #include <QtPrintSupport/QPrintDialog>
 #include <QClipboard>
 #include <QSettings>
+#include <QInputDialog>
 
 // Constructor
 JournalViewer::JournalViewer(QMainWindow *parent) : QMainWindow(parent)
@@ -51,6 +53,9 @@ JournalViewer::JournalViewer(QMainWindow *parent) : QMainWindow(parent)
 	// Call the main creation function
 	ui.setupUi(this);
 	
+	// Start measuring time to first table
+	startupTimer_.start();
+
 	// Set pointer in ISISParser
 	ISIS::setParent(this);
 
@@ -63,6 +68,10 @@ JournalViewer::JournalViewer(QMainWindow *parent) : QMainWindow(parent)
 #endif
 	setWindowTitle(title);
 
+	// Set up Data Table to show the visible runs through its model, which sorts them itself
+	ui.DataTable->setModel(&dataTableModel_);
+	ui.DataTable->setSortingEnabled(true);
+
 	// Connect Data Table's header 
 	connect((QObject*)ui.DataTable->horizontalHeader(), SIGNAL(sectionClicked(int)), this, SLOT(dataTable_headerClicked(int)));
 	ui.DataTable->horizontalHeader()->setSectionsMovable(false);
@@ -70,10 +79,16 @@ JournalViewer::JournalViewer(QMainWindow *parent) : QMainWindow(parent)
 	// Connect contextMenuEvent in DataTable
 	connect(ui.DataTable, SIGNAL(customContextMenuRequested(QPoint)), this, SLOT(dataTable_contextMenuEvent(QPoint)));
 
+	// Show run counts alongside the values in the user and RB filter combos
+	setupFacetCombo(ui.FilterUserCombo);
+	setupFacetCombo(ui.FilterRBCombo);
+
 	// Create Dialogs and set pointer in Messenger
 	logWindow_ = new LogWindow(this);
 	msg.setTextBrowser(logWindow_->ui.LogBrowser);
 	findWindow_ = new FindWindow(*this);
+	memoryWindow_ = new MemoryWindow(*this);
+	runningWindow_ = new RunningWindow(*this);
 
 	// Set default settings, then attempt to load in stored settings
 	setDefaultSettings();
@@ -113,13 +128,33 @@ JournalViewer::JournalViewer(QMainWindow *parent) : QMainWindow(parent)
 	dataInterface_ = new DataInterface(statusHttpProgress_, statusHttpProgressLabel_);
 	connect(ui.actionCancelDownload, SIGNAL(triggered(bool)), dataInterface_, SLOT(cancel()));
 
+	// Limit the number of journals loaded at once (each is mostly waiting on the network or disk)
+	journalLoaderPool_.setMaxThreadCount(4);
+
 	// Set initial variable values
 	currentJournal_ = NULL;
 	currentInstrument_ = NULL;
+	nPendingJournalLoads_ = 0;
+	updatingJournalData_ = false;
+	nPendingRevalidations_ = 0;
+	reselectingJournal_ = false;
+	revalidateAfterLoad_ = false;
+	startingFromCache_ = false;
+	startupSortProperty_ = RunProperty::nProperties;
+	startupSortOrder_ = Qt::AscendingOrder;
+	preloadInstrument_ = NULL;
+	preloadRunning_ = false;
+	preloadEnabled_ = false;
+	deferredInstrument_ = NULL;
+	deferredUpdate_ = false;
+	deferredInitialise_ = false;
 	nRunDataVisible_ = 0;
 	viewByGroup_ = false;
 	refreshing_ = false;
 
+	// Revalidation checks for runs already in the (potentially very long) list of displayed runs
+	runData_.setIndexed(true);
+
 	// Update status bar
 	updateStatusBarPermanentWidgets();
 
@@ -133,6 +168,23 @@ JournalViewer::JournalViewer(QMainWindow *parent) : QMainWindow(parent)
 	hideProgressTimer_.setSingleShot(true);
 	hideProgressTimer_.setInterval(3000);
 
+	// Setup QTimer for background preloading when idle
+	connect(&preloadTimer_, SIGNAL(timeout()), this, SLOT(preloadNext()));
+	preloadTimer_.setSingleShot(true);
+	preloadTimer_.setInterval(5000);
+
+	// Setup QTimer for starting the title search once typing pauses
+	connect(&searchTimer_, SIGNAL(timeout()), this, SLOT(startTitleSearch()));
+	searchTimer_.setSingleShot(true);
+	searchTimer_.setInterval(250);
+
+	// Background searches pass their match caches to us in queued calls
+	qRegisterMetaType< QVector<int> >("QVector<int>");
+
+	// Journal and index loaders pass their results to us in queued calls
+	qRegisterMetaType<JournalLoadResult>("JournalLoadResult");
+	qRegisterMetaType<IndexLoadResult>("IndexLoadResult");
+
 	/* JV Lite */
 #ifdef LITE
 	// Change 'Cycle' label to 'Experiment'
@@ -143,16 +195,33 @@ JournalViewer::JournalViewer(QMainWindow *parent) : QMainWindow(parent)
 // Destructor
 JournalViewer::~JournalViewer()
 {
+	// Stop any background searches (their results are no longer needed)
+	searchTimer_.stop();
+	titleSearch_.cancel();
+	findSearch_.cancel();
+	searchPool_.waitForDone();
+
+	// Loaders post their results to us, so must not outlive us
+	journalLoaderPool_.waitForDone();
 }
 
 // Clear all loaded data
 void JournalViewer::clear()
 {
+	// Stop background preloading before the instruments go away (initialise() makes sure none is running)
+	preloadTimer_.stop();
+	preloadInstrument_ = NULL;
+
 	refreshing_ = true;
 	ui.InstrumentCombo->clear();
 	ui.JournalCombo->clear();
 	setJournal(NULL);
 	setInstrument(NULL);
+	runIndex_.clear();
+	intervalIndex_.clear();
+	runFilter_.clear();
+	facetIndex_.clear();
+	tableGrouping_.invalidate();
 	instruments_.clear();
 	runData_.clear();
 	refreshing_ = false;
@@ -163,6 +232,17 @@ void JournalViewer::clear()
 // Initialise JournalViewer
 bool JournalViewer::initialise(bool startTimers)
 {
+	// Journals still being loaded can't be cleared from under their loaders
+	if (nPendingJournalLoads_ > 0) return false;
+
+	// A background preload may be loading into the journals, so carry on from preloadTaskFinished() once it has finished
+	if (preloadRunning_)
+	{
+		preloadTimer_.stop();
+		deferredInitialise_ = true;
+		return false;
+	}
+
 	// Clear existing Instrument / Journal data
 	clear();
 
@@ -191,6 +271,15 @@ bool JournalViewer::initialise(bool startTimers)
 
 	refreshing_ = true;
 
+	// Restore state of the previous session (GUI only)
+	QSettings settings;
+	ISIS::ISISInstrument startInstrument = defaultInstrument_;
+	if (startTimers)
+	{
+		ISIS::ISISInstrument sessionInstrument = retrieveSession(settings);
+		if (sessionInstrument != ISIS::nInstruments) startInstrument = sessionInstrument;
+	}
+
 	// Add instruments...
 	for (int n=0; n<ISIS::nInstruments; ++n)
 	{
@@ -213,7 +302,7 @@ bool JournalViewer::initialise(bool startTimers)
 	for (Instrument* inst = instruments_.first(); inst != NULL; inst = inst->next)
 	{
 		ui.InstrumentCombo->addItem(inst->capitalisedName());
-		if (inst->instrument() == defaultInstrument_)
+		if (inst->instrument() == startInstrument)
 		{
 			ui.InstrumentCombo->setCurrentIndex(ui.InstrumentCombo->count()-1);
 			defInst = inst;
@@ -225,18 +314,50 @@ bool JournalViewer::initialise(bool startTimers)
 	refreshing_ = false;
 
 	// Set default instrument (starting journal combo will be set automatically)
+	// On startup only cached data is shown here - it is revalidated in the background once the table is populated
+	startingFromCache_ = startTimers;
 	setInstrument(defInst);
+	startingFromCache_ = false;
+	startupJournal_.clear();
+
+	// Restore user / RB filters of the previous session, now that their combos are populated
+	if (startTimers)
+	{
+		refreshing_ = true;
+		ui.FilterUserCombo->setCurrentText(settings.value("Session/UserFilter", "<All>").toString());
+		ui.FilterRBCombo->setCurrentText(settings.value("Session/RBFilter", "<All>").toString());
+		refreshing_ = false;
+	}
 
 	// Start timers?
 	if (startTimers)
 	{
 		if (autoReload_) autoReloadTimer_.start();
+		preloadEnabled_ = true;
+		preloadTimer_.start();
 	}
 
 	// Good to go - show some data
 	filterRunData();
 	updateDataTable();
 
+	if (startTimers)
+	{
+		// Restore sort order of the previous session
+		int sortColumn = (startupSortProperty_ == RunProperty::nProperties ? -1 : runPropertyColumn(startupSortProperty_));
+		if (sortColumn != -1) ui.DataTable->sortByColumn(sortColumn, startupSortOrder_);
+		startupSortProperty_ = RunProperty::nProperties;
+
+		// Record time to first table, and check it against our budget
+		qint64 timeToFirstTable = startupTimer_.elapsed();
+		msg.print("Time to first table: %lli ms (budget %i ms)", timeToFirstTable, firstTableBudget);
+		if (timeToFirstTable > firstTableBudget) msg.print("Warning - Time to first table exceeded budget of %i ms", firstTableBudget);
+		settings.setValue("Session/TimeToFirstTable", timeToFirstTable);
+
+		// Now check cached data against its source
+		revalidate();
+	}
+
 	return true;
 }
 
@@ -321,33 +442,37 @@ void JournalViewer::on_ReloadJournalButton_clicked(bool checked)
  * Search Panel
  */
 
-// Search text modified
+// Search text entered
 void JournalViewer::on_SearchEdit_returnPressed()
 {
-	filterRunData();
-	updateDataTable();
+	startTitleSearch();
+}
+
+// Search text edited
+void JournalViewer::on_SearchEdit_textEdited(QString text)
+{
+	// Abandon any search for the previous text, and search once typing pauses
+	titleSearch_.cancel();
+	searchTimer_.start();
 }
 
 // Search style changed
 void JournalViewer::on_SearchStyleCombo_currentIndexChanged(int index)
 {
-	filterRunData();
-	updateDataTable();
+	startTitleSearch();
 }
 
 // Search box clear button pressed
 void JournalViewer::on_SearchClearButton_clicked(bool checked)
 {
 	ui.SearchEdit->clear();
-	filterRunData();
-	updateDataTable();
+	startTitleSearch();
 }
 
 // Case Sensitivity checkbox clicked
 void JournalViewer::on_SearchCaseSensitiveCheck_clicked(bool checked)
 {
-	filterRunData();
-	updateDataTable();
+	startTitleSearch();
 }
 
 /*
@@ -466,12 +591,12 @@ void JournalViewer::dataTable_headerClicked(int section)
 }
 
 // Table cell single-clicked
-void JournalViewer::on_DataTable_itemClicked(QTableWidgetItem* item)
+void JournalViewer::on_DataTable_clicked(const QModelIndex& index)
 {
 }
 
 // Table cell double-clicked
-void JournalViewer::on_DataTable_itemDoubleClicked(QTableWidgetItem* item)
+void JournalViewer::on_DataTable_doubleClicked(const QModelIndex& index)
 {
 	plotSelectedRunData(RunData::LogBeforeNexusSource);
 }
@@ -479,9 +604,9 @@ void JournalViewer::on_DataTable_itemDoubleClicked(QTableWidgetItem* item)
 // Context menu event
 void JournalViewer::dataTable_contextMenuEvent(const QPoint &pos)
 {
-	// Get QTableWidteItem under clicked point
-	TTableWidgetItem* sourceItem = (TTableWidgetItem*) ui.DataTable->itemAt(pos);
-	if (!sourceItem) return;
+	// Get run under clicked point
+	RunData* sourceRun = dataTableModel_.runData(ui.DataTable->indexAt(pos).row());
+	if (!sourceRun) return;
 
 	// Create and execute context menu
 	QMenu menu(this);
@@ -493,17 +618,13 @@ void JournalViewer::dataTable_contextMenuEvent(const QPoint &pos)
 	// Act on action!
 	if (selectedAction == selectSimilarAction) 
 	{
-		// Loop over DataTable items and set new selection
-		ui.DataTable->clearSelection();
-		ui.DataTable->setSelectionMode(QAbstractItemView::MultiSelection);
-		TTableWidgetItem* item;
-		for (int row = 0; row < ui.DataTable->rowCount(); ++row)
-		{
-			item = (TTableWidgetItem*) ui.DataTable->item(row, 0);
-			if (!item) continue;
-			if (item->source()->title() == sourceItem->source()->title()) ui.DataTable->selectRow(row);
-		}
-		ui.DataTable->setSelectionMode(QAbstractItemView::ExtendedSelection);
+		// Loop over DataTable rows and set new selection
+		RunGrouping& grouping = tableGrouping();
+		int group = grouping.groupOf(sourceRun);
+		const QVector<RunData*>& runs = dataTableModel_.runs();
+		QVector<int> rows;
+		for (int row = 0; row < runs.count(); ++row) if (grouping.groupOf(runs.at(row)) == group) rows << row;
+		selectDataTableRows(rows);
 	}
 	else if (selectedAction == sampleReportAction) 
 	{
@@ -514,7 +635,7 @@ void JournalViewer::dataTable_contextMenuEvent(const QPoint &pos)
 		SampleReport* sampleReportWin = new SampleReport(this);
 		Instrument* inst = selectedData.first()->item->instrument();
 		sampleReportWin->setWindowTitle(inst->capitalisedName() + " Sample Report");
-		sampleReportWin->addRunData(selectedData, inst->location() == ISIS::Muon);
+		sampleReportWin->addRunData(selectedData, tableGrouping(), inst->location() == ISIS::Muon);
 		sampleReportWin->finaliseAndShow();
 	}
 	else if (selectedAction == copyForGudrun)
@@ -543,7 +664,7 @@ void JournalViewer::dataTable_contextMenuEvent(const QPoint &pos)
 void JournalViewer::on_actionFileSaveAsText_triggered(bool checked)
 {
 	// Count current visible items
-	int nSelected = ui.DataTable->selectedItems().count();
+	int nSelected = ui.DataTable->selectionModel()->selectedRows().count();
 
 	if (nRunDataVisible_ == 0)
 	{
@@ -586,7 +707,7 @@ void JournalViewer::on_actionFileSaveAsText_triggered(bool checked)
 void JournalViewer::on_actionFileSaveAsPDF_triggered(bool checked)
 {
 	// Count current visible items
-	int nSelected = ui.DataTable->selectedItems().count();
+	int nSelected = ui.DataTable->selectionModel()->selectedRows().count();
 
 	if (nRunDataVisible_ == 0)
 	{
@@ -782,6 +903,23 @@ void JournalViewer::on_actionToolsFindPrevious_triggered(bool checked)
 	findPrevious();
 }
 
+// Tools->Go To Run selected
+void JournalViewer::on_actionToolsGoToRun_triggered(bool checked)
+{
+	if (currentInstrument_ == NULL) return;
+
+	bool ok;
+	int runNumber = QInputDialog::getInt(this, "Go To Run", "Run number (" + currentInstrument_->capitalisedName() + "):", lastRunNumber_, 0, 2147483647, 1, &ok);
+	if (ok) goToRun(runNumber);
+}
+
+// Tools->Runs At Time selected
+void JournalViewer::on_actionToolsRunsAtTime_triggered(bool checked)
+{
+	runningWindow_->show();
+	runningWindow_->raise();
+}
+
 // Tools->Reload Data selected
 void JournalViewer::on_actionToolsReloadData_triggered(bool checked)
 {
@@ -815,9 +953,8 @@ void JournalViewer::on_actionToolsResetFilters_triggered(bool checked)
 	// Reset filters
 	resetFilters();
 
-	// Update
-	filterRunData();
-	updateDataTable();
+	// Update (clearing the title search, which needs no background search)
+	startTitleSearch();
 }
 
 // File->CreateExperimentReport selected
@@ -947,6 +1084,13 @@ void JournalViewer::on_actionToolsLogWindow_triggered(bool checked)
 	logWindow_->show();
 }
 
+// Tools->Memory Usage selected
+void JournalViewer::on_actionToolsMemoryUsage_triggered(bool checked)
+{
+	memoryWindow_->refresh();
+	memoryWindow_->show();
+}
+
 // Tools->Regenerate Local Journals selected
 void JournalViewer::on_actionToolsRegenerateLocalJournals_triggered(bool checked)
 {
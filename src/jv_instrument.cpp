@@ -22,6 +22,8 @@
 #include "jv.h"
 #include "instrument.h"
 #include "datainterface.h"
+#include "journalloader.h"
+#include "indexloader.h"
 #include "messenger.hui"
 
 /*
@@ -67,6 +69,17 @@ void JournalViewer::setInstrument(Instrument* inst)
 	// Is instrument different from current?
 	if (inst == currentInstrument_) return;
 
+	// A background preload of the instrument must finish before we touch it, so carry on from preloadTaskFinished() once it has
+	if (preloading(inst))
+	{
+		deferredInstrument_ = inst;
+		deferredJournal_.clear();
+		deferredUpdate_ = false;
+		setJournalControlsEnabled(false);
+		ui.statusbar->showMessage("Waiting for background load of instrument " + inst->capitalisedName() + " to finish...");
+		return;
+	}
+
 	refreshing_ = true;
 
 	// Different instrument, so update InstrumentCombo and JournalCombo
@@ -88,105 +101,24 @@ void JournalViewer::setInstrument(Instrument* inst)
 	// Stop progress hide timer, in case we re-use the progress bar here...
 	hideProgressTimer_.stop();
 
-	// Probe journal file
-	QByteArray data;
-	bool result;
-	QDateTime modificationTime;
-	JournalViewer::JournalAccess accessType, sourceType;
-	accessType = (currentInstrument_->instrument() == ISIS::LOCAL ? JournalViewer::DiskOnlyAccess : journalAccessType_);
-	
-	if (dataInterface_->mostRecent(accessType, currentInstrument_->indexLocalFile(), currentInstrument_->indexHttpFile(), modificationTime, sourceType))
+	// Has the index been checked recently (e.g. by the background preload)? If so, use it as it is (local indices are always checked, since it costs nothing)
+	QDateTime checkTime = currentInstrument_->indexCheckTime();
+	if ((currentInstrument_->instrument() != ISIS::LOCAL) && checkTime.isValid() && (checkTime.secsTo(QDateTime::currentDateTime()) < revalidationInterval))
 	{
-		if (sourceType == JournalViewer::NoAccess)
-		{
-			result = false;
-			msg.print("Error: No source available for index file for instrument " + currentInstrument_->capitalisedName());
-			ui.statusbar->showMessage(QString("No source available for index file for instrument ") + currentInstrument_->capitalisedName(), 3000);
-		}
-		else if (modificationTime == currentInstrument_->indexModificationTime())
-		{
-			result = true;
-			msg.print("Index file is up to date for instrument " + currentInstrument_->capitalisedName());
-			ui.statusbar->showMessage(QString("Index file is up to date for instrument ") + currentInstrument_->capitalisedName(), 3000);
-		}
-		else if (sourceType == JournalViewer::DiskOnlyAccess)
-		{
-			// Clear journals from current instrument
-			currentInstrument_->clearJournals();
-
-			// Local copy is newer (somehow) so load it in
-			result = dataInterface_->readFile(currentInstrument_->indexLocalFile(), data);
-			if (result) result = ISIS::parseJournalIndex(inst, data);
-
-			// Did we succeed?
-			if (result)
-			{
-				// Add default 'All' journal option
-				currentInstrument_->addJournal("All");
-
-				msg.print("Updated index loaded from disk for instrument " + currentInstrument_->capitalisedName());
-				ui.statusbar->showMessage("Updated index loaded from disk for instrument " + currentInstrument_->capitalisedName(), 3000);
-			}
-			else if (accessType == JournalViewer::DiskAndNetAccess)
-			{
-				// Failed to load local copy - we can update it from the net, since the access type permits it
-				result = dataInterface_->readHttp(currentInstrument_->indexHttpFile(), data);
-				if (result) result = result = ISIS::parseJournalIndex(inst, data);
-
-				// Check overall success of reading local copy
-				if (result)
-				{
-					// Add default 'All' journal option
-					currentInstrument_->addJournal("All");
-
-					msg.print("Updated index loaded from net (failed to read local copy) for instrument " + currentInstrument_->capitalisedName());
-					ui.statusbar->showMessage("Updated index loaded from net (failed to read local copy) for instrument " + currentInstrument_->capitalisedName(), 3000);
-					if (dataInterface_->readHttpModificationTime(currentInstrument_->indexHttpFile(), modificationTime)) dataInterface_->saveLocalCopy(data, currentInstrument_->indexLocalFile(), modificationTime);
-				}
-				else 
-				{
-					msg.print("Failed to load index for instrument " + currentInstrument_->capitalisedName() + " from both local disk and net.");
-					ui.statusbar->showMessage("Failed to load index for instrument " + currentInstrument_->capitalisedName() + " from both local disk and net.", 3000);
-				}
-			}
-		}
-		else if (sourceType == JournalViewer::NetOnlyAccess)
-		{
-			// Clear journals from current instrument
-			currentInstrument_->clearJournals();
-
-			// Net copy is newer
-			result = dataInterface_->readHttp(currentInstrument_->indexHttpFile(), data);
-			if (result) result = result = ISIS::parseJournalIndex(inst, data);
-
-			// Check overall success of reading net copy
-			if (result)
-			{
-				msg.print("Updated index loaded from net for instrument " + currentInstrument_->capitalisedName());
-				ui.statusbar->showMessage("Updated index loaded from net for instrument " + currentInstrument_->capitalisedName(), 3000);
-
-				// Add default 'All' journal option
-				currentInstrument_->addJournal("All");
-
-				// Save local copy, if access type permits
-				if (accessType == JournalViewer::DiskAndNetAccess)
-				{
-					if (dataInterface_->readHttpModificationTime(currentInstrument_->indexHttpFile(), modificationTime)) dataInterface_->saveLocalCopy(data, currentInstrument_->indexLocalFile(), modificationTime);
-				}
-			}
-			else
-			{
-				msg.print("Failed to load index instrument " + currentInstrument_->capitalisedName() + " from net.");
-				ui.statusbar->showMessage("Failed to load index instrument " + currentInstrument_->capitalisedName() + " from net.", 3000);
-			}
-		}
-		
-		// Set modification time
-		currentInstrument_->setIndexModificationTime(result ? modificationTime : QDateTime());
+		msg.print("Using cached index for instrument " + currentInstrument_->capitalisedName());
+		ui.statusbar->showMessage("Using cached index for instrument " + currentInstrument_->capitalisedName(), 3000);
+	}
+	else
+	{
+		// Probe journal index file here and now, using our DataInterface so progress is shown
+		IndexLoader loader(this, currentInstrument_, effectiveAccessType(currentInstrument_), NULL, dataInterface_);
 
 		// Check final result
-		if (result)
+		if (finaliseIndexLoad(loader.load()))
 		{
+			// If only the local copy was consulted, it still needs to be checked against its source
+			if (startingFromCache_) currentInstrument_->setIndexCheckTime(QDateTime());
+
 			msg.print("Successfully found/probed journal index for " + ISIS::capitalisedName(currentInstrument_->instrument()));
 			ui.statusbar->showMessage("Journal index successfully loaded for instrument " + ISIS::capitalisedName(currentInstrument_->instrument()), 3000);
 		}
@@ -195,12 +127,6 @@ void JournalViewer::setInstrument(Instrument* inst)
 			msg.print("Failed to parse journal index for " + ISIS::capitalisedName(currentInstrument_->instrument()));
 			ui.statusbar->showMessage("Journal index not available for instrument " + ISIS::capitalisedName(currentInstrument_->instrument()), 3000);
 		}
-
-	}
-	else
-	{
-		msg.print("Failed to load journal index file for " + ISIS::capitalisedName(currentInstrument_->instrument()));
-// 		currentInstrument_ = NULL;
 	}
 
 	ui.JournalCombo->setEnabled(currentInstrument_);
@@ -215,8 +141,9 @@ void JournalViewer::setInstrument(Instrument* inst)
 
 	refreshing_ = false;
 
-	// Update current Journal
-	setJournal(currentInstrument_->currentCycleJournal());
+	// Update current Journal (the one from the previous session, if we're starting up and it still exists)
+	Journal* startupJournal = startupJournal_.isEmpty() ? NULL : currentInstrument_->journal(startupJournal_);
+	setJournal(startupJournal ? startupJournal : currentInstrument_->currentCycleJournal());
 }
 
 // Return current instrument
@@ -231,12 +158,343 @@ Instrument* JournalViewer::instrument(ISIS::ISISInstrument instrmnt)
 	return instruments_[instrmnt];
 }
 
+// Finalise loading of journal index, parsing its data into the target Instrument
+bool JournalViewer::finaliseIndexLoad(const IndexLoadResult& loadResult)
+{
+	Instrument* inst = loadResult.instrument();
+	bool result = loadResult.result();
+
+	// Parse new index data (if there is any)
+	if (result && (!loadResult.upToDate()))
+	{
+		unindexInstrument(inst);
+		inst->clearJournals();
+		QByteArray data = loadResult.data();
+		result = ISIS::parseJournalIndex(inst, data);
+		if (result)
+		{
+			// Add default 'All' journal option
+			inst->addJournal("All");
+
+			// Save local copy, if the loader retrieved it from the net
+			if (loadResult.saveLocalCopy()) DataInterface::saveLocalCopy(loadResult.data(), inst->indexLocalFile(), loadResult.modificationTime());
+		}
+	}
+
+	// Set modification and check times
+	inst->setIndexModificationTime(result ? loadResult.modificationTime() : QDateTime());
+	inst->setIndexCheckTime(result ? QDateTime::currentDateTime() : QDateTime());
+
+	return result;
+}
+
+// Return whether a background preload of the specified instrument is running
+bool JournalViewer::preloading(Instrument* inst)
+{
+	return preloadRunning_ && (inst == preloadInstrument_);
+}
+
+// Background preload task has finished, so carry on with anything that was deferred until it had
+void JournalViewer::preloadTaskFinished()
+{
+	preloadRunning_ = false;
+
+	// Re-initialising replaces everything else
+	if (deferredInitialise_)
+	{
+		deferredInitialise_ = false;
+		deferredInstrument_ = NULL;
+		deferredJournal_.clear();
+		deferredUpdate_ = false;
+		initialise();
+		return;
+	}
+
+	if (deferredInstrument_ != NULL)
+	{
+		Instrument* inst = deferredInstrument_;
+		deferredInstrument_ = NULL;
+		setJournalControlsEnabled(true);
+		setInstrument(inst);
+	}
+
+	// A changed index recreates the instrument's journals, so the journal is looked up (by name) only now
+	if (!deferredJournal_.isEmpty())
+	{
+		Journal* jrnl = (currentInstrument_ == NULL ? NULL : currentInstrument_->journal(deferredJournal_));
+		deferredJournal_.clear();
+		setJournalControlsEnabled(true);
+		if (jrnl != NULL) setJournal(jrnl);
+	}
+
+	if (deferredUpdate_)
+	{
+		deferredUpdate_ = false;
+		updateJournalData();
+	}
+}
+
+// Remove specified journal's runs from the run, interval, filter and facet indexes
+void JournalViewer::unindexJournal(Journal* jrnl)
+{
+	runIndex_.removeJournal(jrnl);
+	intervalIndex_.removeJournal(jrnl);
+	runFilter_.removeJournal(jrnl);
+	facetIndex_.removeJournal(jrnl);
+}
+
+// Remove all journals of specified instrument from the run, interval, filter and facet indexes
+void JournalViewer::unindexInstrument(Instrument* inst)
+{
+	runIndex_.removeInstrument(inst);
+	intervalIndex_.removeInstrument(inst);
+	runFilter_.removeInstrument(inst);
+	facetIndex_.removeInstrument(inst);
+}
+
+// Start background preload of next instrument's index and current journal
+void JournalViewer::preloadNext()
+{
+	if (!preloadEnabled_) return;
+
+	// Don't compete with anything the user has asked for - try again later
+	if (refreshing_ || preloadRunning_ || (nPendingJournalLoads_ > 0))
+	{
+		preloadTimer_.start();
+		return;
+	}
+
+	// Find next instrument whose index hasn't been checked recently, continuing on from the last one we looked at
+	QDateTime now = QDateTime::currentDateTime();
+	Instrument* inst = preloadInstrument_;
+	for (int n=0; n<instruments_.nItems(); ++n)
+	{
+		inst = ((inst == NULL) || (inst->next == NULL)) ? instruments_.first() : inst->next;
+		if ((inst == currentInstrument_) || (inst->instrument() == ISIS::LOCAL)) continue;
+		if ((!inst->indexCheckTime().isValid()) || (inst->indexCheckTime().secsTo(now) >= revalidationInterval)) break;
+		inst = NULL;
+	}
+	if (inst == NULL)
+	{
+		// Everything is up to date, so check again later
+		preloadTimer_.start();
+		return;
+	}
+
+	// Make sure the instrument array is generated before any loaders look up instruments from their threads
+	instruments_.array();
+
+	// Start low-priority index load for the instrument
+	preloadInstrument_ = inst;
+	preloadRunning_ = true;
+	journalLoaderPool_.start(new IndexLoader(this, inst, journalAccessType_, "indexPreloadFinished"), -1);
+}
+
+// Background index preload has finished
+void JournalViewer::indexPreloadFinished(IndexLoadResult loadResult)
+{
+	Instrument* inst = loadResult.instrument();
+	bool result = finaliseIndexLoad(loadResult);
+
+	// Now preload the instrument's current cycle journal
+	Journal* jrnl = inst->currentCycleJournal();
+	if (result && (jrnl != NULL) && (jrnl->name() != "All"))
+	{
+		unindexJournal(jrnl);
+		loadingJournals_.insert(jrnl);
+		journalLoaderPool_.start(new JournalLoader(this, jrnl, journalAccessType_, jrnl->runData().nItems() != 0, forceISOEncoding_, "journalPreloadFinished"), -1);
+		return;
+	}
+
+	preloadTimer_.start();
+	preloadTaskFinished();
+}
+
+// Background journal preload has finished
+void JournalViewer::journalPreloadFinished(JournalLoadResult result)
+{
+	loadingJournals_.remove(result.journal());
+	finaliseJournalLoad(result, false);
+
+	preloadTimer_.start();
+	preloadTaskFinished();
+}
+
+/*
+ * Startup / Revalidation
+ */
+
+// Start background revalidation of the current instrument's index and journal data
+void JournalViewer::revalidate()
+{
+	if ((currentInstrument_ == NULL) || preloadRunning_) return;
+
+	// The journal data must have arrived before it can be revalidated
+	if (nPendingJournalLoads_ > 0)
+	{
+		revalidateAfterLoad_ = true;
+		return;
+	}
+
+	// Make sure the instrument array is generated before any loaders look up instruments from their threads
+	instruments_.array();
+
+	// Revalidation is run as a preload task for the current instrument, so anything needing its data is deferred until it has finished
+	preloadInstrument_ = currentInstrument_;
+	preloadRunning_ = true;
+	nPendingRevalidations_ = 0;
+
+	// Local indices come from disk anyway, so go straight on to the journal data
+	if (currentInstrument_->instrument() == ISIS::LOCAL)
+	{
+		revalidateJournals();
+		return;
+	}
+
+	msg.print("Revalidating journal index for instrument " + currentInstrument_->capitalisedName() + " in the background");
+	journalLoaderPool_.start(new IndexLoader(this, currentInstrument_, journalAccessType_, "revalidationIndexFinished"));
+}
+
+// Start background revalidation of the current journal data
+void JournalViewer::revalidateJournals()
+{
+	if (currentJournal_ != NULL)
+	{
+		// Work backwards from the current cycle if 'All' is displayed (as loadAllJournalData() does)
+		Journal* first = (currentJournal_->name() == "All" ? currentInstrument_->currentCycleJournal() : currentJournal_);
+		for (Journal* journal = first; journal != NULL; journal = journal->prev)
+		{
+			if (journal->name() != "All")
+			{
+				JournalLoader* loader = new JournalLoader(this, journal, effectiveAccessType(currentInstrument_), true, forceISOEncoding_, "revalidationJournalFinished");
+				loader->setStageEntries(true);
+				++nPendingRevalidations_;
+				journalLoaderPool_.start(loader);
+			}
+			if (currentJournal_->name() != "All") break;
+		}
+	}
+
+	if (nPendingRevalidations_ == 0) revalidationTaskFinished();
+}
+
+// Background revalidation task has finished
+void JournalViewer::revalidationTaskFinished()
+{
+	if (preloadEnabled_) preloadTimer_.start();
+	preloadTaskFinished();
+}
+
+// Background index revalidation has finished
+void JournalViewer::revalidationIndexFinished(IndexLoadResult loadResult)
+{
+	Instrument* inst = loadResult.instrument();
+
+	// If the index has changed its journals will be recreated, so any of their RunData we are displaying must be released first
+	bool changed = loadResult.result() && (!loadResult.upToDate());
+	QString journalName = ((inst == currentInstrument_) && currentJournal_) ? currentJournal_->name() : QString();
+	if (changed && (runData_.first() != NULL) && (runData_.first()->data->parent() == inst))
+	{
+		runData_.clear();
+		updateDataTable();
+	}
+	bool result = finaliseIndexLoad(loadResult);
+
+	// Nothing more to do if the user has moved on to another instrument in the meantime
+	if ((inst != currentInstrument_) || refreshing_)
+	{
+		revalidationTaskFinished();
+		return;
+	}
+
+	// Re-select the journal we were displaying from the new index, showing its cached data before revalidating it
+	if (changed)
+	{
+		refreshing_ = true;
+		ui.JournalCombo->clear();
+		for (Journal* jrnl = currentInstrument_->journals(); jrnl != NULL; jrnl = jrnl->next) ui.JournalCombo->addItem(jrnl->name());
+		refreshing_ = false;
+
+		Journal* jrnl = currentInstrument_->journal(journalName);
+		currentJournal_ = NULL;
+		startingFromCache_ = true;
+		reselectingJournal_ = true;
+		setJournal(jrnl ? jrnl : currentInstrument_->currentCycleJournal());
+		reselectingJournal_ = false;
+		startingFromCache_ = false;
+
+		// If it is 'All', its journals are still loading - they are revalidated once they have arrived
+		if (result && (nPendingJournalLoads_ > 0))
+		{
+			revalidateAfterLoad_ = true;
+			return;
+		}
+	}
+
+	if (result) revalidateJournals();
+	else revalidationTaskFinished();
+}
+
+// Background journal revalidation has finished
+void JournalViewer::revalidationJournalFinished(JournalLoadResult loadResult)
+{
+	// The loader parsed the new data into staged entries, since the Journal's RunData may be on display - they are added to it here
+	Journal* jrnl = loadResult.journal();
+	bool result = finaliseJournalLoad(loadResult, false);
+
+	// Apply changes to the displayed data (if it is)
+	bool shown = (!refreshing_) && (currentJournal_ != NULL) && ((currentJournal_ == jrnl) || ((currentJournal_->name() == "All") && (jrnl->parent() == currentInstrument_)));
+	if (result && shown && (!jrnl->changedRuns().isEmpty()))
+	{
+		// Rebuild the journal's span of runData_ where it is, in journal order, so that each journal's runs stay contiguous
+		RefListItem<RunData,Journal*>* span = runData_.first();
+		while ((span != NULL) && (span->data != jrnl)) span = span->next;
+		int nAdded = jrnl->runData().nItems();
+		for (RefListItem<RunData,Journal*>* ri = span; (ri != NULL) && (ri->data == jrnl); ri = ri->next) --nAdded;
+		RefListItem<RunData,Journal*>* target = (span == NULL ? runData_.last() : span->prev);
+		bool atStart = (span != NULL) && (target == NULL);
+		runData_.prune(jrnl);
+		for (RunData* rd = jrnl->runData().first(); rd != NULL; rd = rd->next)
+		{
+			target = (atStart ? runData_.addStart(rd, jrnl) : runData_.addAfter(target, rd));
+			target->data = jrnl;
+			atStart = false;
+		}
+
+		// Update limits, keeping the current user / RB filters
+		refreshing_ = true;
+		QString userFilter = ui.FilterUserCombo->currentText(), rbFilter = ui.FilterRBCombo->currentText();
+		storeFilters();
+		findFilterLimits();
+		retrieveFilters();
+		ui.FilterUserCombo->setCurrentText(userFilter);
+		ui.FilterRBCombo->setCurrentText(rbFilter);
+		refreshing_ = false;
+		filterRunData();
+		updateDataTable();
+
+		msg.print("Revalidation of journal '%s' added %i and updated %i runs", qPrintable(jrnl->name()), nAdded, jrnl->changedRuns().count() - nAdded);
+		ui.statusbar->showMessage("Journal '" + jrnl->name() + "' updated (" + QString::number(nAdded) + " new runs)", 3000);
+	}
+
+	if (--nPendingRevalidations_ == 0) revalidationTaskFinished();
+}
+
 // Set current Journal (loads data)
 void JournalViewer::setJournal(Journal* jrnl)
 {
 	// Refreshing?
 	if (refreshing_) return;
 
+	// A background preload / revalidation of the instrument must finish before we touch its data, so carry on from preloadTaskFinished() once it has
+	if ((!reselectingJournal_) && (jrnl != NULL) && preloading(currentInstrument_))
+	{
+		deferredJournal_ = jrnl->name();
+		setJournalControlsEnabled(false);
+		ui.statusbar->showMessage("Waiting for background update of instrument " + currentInstrument_->capitalisedName() + " to finish...");
+		return;
+	}
+
 	// Is journal valid?
 	if (jrnl == NULL)
 	{
@@ -267,18 +525,10 @@ void JournalViewer::setJournal(Journal* jrnl)
 	hideProgressTimer_.stop();
 
 	// Check for 'All' being selected
+	// If 'All' is selected its journals are loaded in the background, and journalDataLoaded() is called once they have all arrived
 	runData_.clear();
 	updateDataTable();
-	if (currentJournal_->name() == "All")
-	{
-		for (Journal* journal = currentInstrument_->journals(); journal != NULL; journal = journal->next)
-		{
-			// Skip 'All' journal entry
-			if (journal->name() == "All") continue;
-			
-			loadJournalData(journal, false);
-		}
-	}
+	if (currentJournal_->name() == "All") loadAllJournalData(false);
 	else
 	{
 		if (loadJournalData(currentJournal_, false)) ui.statusbar->showMessage(QString("Journal '") + currentJournal_->name() + QString("' loaded for instrument ") + currentInstrument_->capitalisedName(), 3000);
@@ -287,19 +537,8 @@ void JournalViewer::setJournal(Journal* jrnl)
 			msg.print("Failed to load journal '" + currentJournal_->name() + "' for instrument " + currentInstrument_->capitalisedName());
 			ui.statusbar->showMessage("Failed to load journal '" + currentJournal_->name() + "' for instrument " + currentInstrument_->capitalisedName(), 3000);
 		}
+		journalDataLoaded(false);
 	}
-
-	// New journal data has been loaded (hopefully), so must update limits and unique lists
-	storeFilters();
-	findFilterLimits();
-	resetFilters();
-	filterRunData();
-	updateDataTable();
-	
-	hideProgressTimer_.start();
-
-	refreshing_ = false;
-	setJournalControlsEnabled(true);
 }
 
 // Load specified journal data
@@ -307,101 +546,187 @@ bool JournalViewer::loadJournalData(Journal* jrnl, bool updateOnly)
 {
 	dataInterface_->setLabelText(jrnl->fileName());
 
-	QByteArray data;
-	bool result = false;
-	QDateTime modificationTime;
-
 	// Stop progress hide timer, in case we re-use the progress bar here...
 	hideProgressTimer_.stop();
 
-	JournalViewer::JournalAccess accessType, sourceType;
-	accessType = (currentInstrument_->instrument() == ISIS::LOCAL ? JournalViewer::DiskOnlyAccess : journalAccessType_);
+	// Load the journal here and now, using our DataInterface so progress is shown
+	unindexJournal(jrnl);
+	JournalLoader loader(this, jrnl, effectiveAccessType(currentInstrument_), updateOnly, forceISOEncoding_, NULL, dataInterface_);
+	bool result = finaliseJournalLoad(loader.load());
+
+	// Start the progress hide timer, if the progressBar is now visible
+	if (statusHttpProgress_->isVisible()) hideProgressTimer_.start();
+
+	return result;
+}
+
+// Load data for all journals of the current instrument concurrently, newest first
+void JournalViewer::loadAllJournalData(bool updateOnly)
+{
+	JournalViewer::JournalAccess accessType = effectiveAccessType(currentInstrument_);
+
+	// Make sure the instrument array is generated before any loaders look up instruments from their threads
+	instruments_.array();
 
+	// All rows are shown as they arrive - filters are applied once everything has finished loading
+	setAllRunDataVisible(true);
+	nRunDataVisible_ = runData_.nItems();
 
-	if (dataInterface_->mostRecent(accessType, jrnl->filePath(), jrnl->httpPath(), modificationTime, sourceType))
+	// Without a visible window (i.e. on the command line) there is no event loop to deliver results to us, so load each journal here and now
+	if (!isVisible())
 	{
-		if (sourceType == JournalViewer::NoAccess)
-		{
-			result = false;
-			msg.print("No source available for Journal '" + jrnl->name() + "' for instrument " + currentInstrument_->capitalisedName());
-			ui.statusbar->showMessage("No source available for Journal '" + jrnl->name() + "' for instrument " + currentInstrument_->capitalisedName(), 3000);
-		}
-		else if (modificationTime == jrnl->modificationTime())
+		for (Journal* journal = currentInstrument_->currentCycleJournal(); journal != NULL; journal = journal->prev)
 		{
-			result = true;
-			msg.print("Current data for Journal '" + jrnl->name() + "' for instrument " + currentInstrument_->capitalisedName() + " is up to date");
-			ui.statusbar->showMessage("Current data for Journal '" + jrnl->name() + "' for instrument " + currentInstrument_->capitalisedName() + " is up to date", 3000);
+			if (journal->name() == "All") continue;
+			unindexJournal(journal);
+			JournalLoader loader(this, journal, accessType, updateOnly, forceISOEncoding_, NULL);
+			if (finaliseJournalLoad(loader.load())) nRunDataVisible_ += journal->runData().nItems();
 		}
-		else if (sourceType == JournalViewer::DiskOnlyAccess)
-		{
-			// Local copy is newer (somehow) so load it in
-			result = DataInterface::readFile(jrnl->filePath(), data);
-			if (result) result = ISIS::parseJournalData(jrnl, data, updateOnly, forceISOEncoding_);
+		journalDataLoaded(updateOnly);
+		return;
+	}
 
-			// Did we succeed?
-			if (result)
-			{
-				msg.print("Updated Journal '" + jrnl->name() + "' loaded from disk for instrument " + currentInstrument_->capitalisedName());
-				ui.statusbar->showMessage("Updated Journal '" + jrnl->name() + "' loaded from disk for instrument " + currentInstrument_->capitalisedName(), 3000);
-			}
-			else if (accessType == JournalViewer::DiskAndNetAccess)
-			{
-				// Failed to load local copy - we can update it from the net, since the access type permits it
-				result = dataInterface_->readHttp(jrnl->httpPath(), data);
-				if (result) result = ISIS::parseJournalData(jrnl, data, updateOnly, forceISOEncoding_);
-
-				// Check overall success of reading local copy
-				if (result)
-				{
-					msg.print("Updated Journal '" + jrnl->name() + "' loaded from net (failed to read local copy) for instrument " + currentInstrument_->capitalisedName());
-					ui.statusbar->showMessage("Updated Journal '" + jrnl->name() + "' loaded from net (failed to read local copy) for instrument " + currentInstrument_->capitalisedName(), 3000);
-					if (dataInterface_->readHttpModificationTime(jrnl->httpPath(), modificationTime)) dataInterface_->saveLocalCopy(data, jrnl->filePath(), modificationTime);
-				}
-				else
-				{
-					msg.print("Failed to load Journal '" + jrnl->name() + "' instrument " + currentInstrument_->capitalisedName() + " from both local disk and net.");
-					ui.statusbar->showMessage("Failed to load Journal '" + jrnl->name() + "' instrument " + currentInstrument_->capitalisedName() + " from both local disk and net.", 3000);
-				}
-			}
-		}
-		else if (sourceType == JournalViewer::NetOnlyAccess)
-		{
-			// Net copy is newer
-			result = dataInterface_->readHttp(jrnl->httpPath(), data);
-			if (result) result = ISIS::parseJournalData(jrnl, data, updateOnly, forceISOEncoding_);
+	// Journals are listed oldest first (with 'All' at the end), so work backwards from the current cycle
+	for (Journal* journal = currentInstrument_->currentCycleJournal(); journal != NULL; journal = journal->prev)
+	{
+		// Skip 'All' journal entry
+		if (journal->name() == "All") continue;
 
-			// Check overall success of reading net copy
-			if (result)
-			{
-				msg.print("Updated Journal '" + jrnl->name() + "' loaded from net for instrument " + currentInstrument_->capitalisedName());
-				ui.statusbar->showMessage("Updated Journal '" + jrnl->name() + "' loaded from net for instrument " + currentInstrument_->capitalisedName(), 3000);
-
-				// Save local copy, if access type permits
-				if (accessType == JournalViewer::DiskAndNetAccess)
-				{
-					if (dataInterface_->readHttpModificationTime(jrnl->httpPath(), modificationTime)) dataInterface_->saveLocalCopy(data, jrnl->filePath(), modificationTime);
-				}
-			}
-			else
-			{
-				msg.print("Failed to load Journal '" + jrnl->name() + "' instrument " + currentInstrument_->capitalisedName() + " from net.");
-				ui.statusbar->showMessage("Failed to load Journal '" + jrnl->name() + "' instrument " + currentInstrument_->capitalisedName() + " from net.", 3000);
-			}
-		}
-		
-		// Set modification time
-		jrnl->setModificationTime(result ? modificationTime : QDateTime());
+		unindexJournal(journal);
+		loadingJournals_.insert(journal);
+		++nPendingJournalLoads_;
+		journalLoaderPool_.start(new JournalLoader(this, journal, accessType, updateOnly, forceISOEncoding_, "journalLoaderFinished"));
+	}
+	if (nPendingJournalLoads_ == 0)
+	{
+		journalDataLoaded(updateOnly);
+		return;
+	}
+
+	// Results are processed as they arrive in journalLoaderFinished() - keep the user away from the (partial) data until they all have
+	updatingJournalData_ = updateOnly;
+	ui.menubar->setEnabled(false);
+	ui.DisplayGroup->setEnabled(false);
+	ui.FilterGroup->setEnabled(false);
+}
 
-		// Success?
-		// Add data to run list, if we were successful
-		if (result) for (RunData* rd = jrnl->runData().first(); rd != NULL; rd = rd->next) runData_.add(rd, jrnl);
-		else msg.print(("Failed to load journal data '") + jrnl->fileName() + "' for instrument " + jrnl->parent()->capitalisedName());
+// Update limits, filters and controls now that new journal data has been loaded
+void JournalViewer::journalDataLoaded(bool updateOnly)
+{
+	// New journal data has been loaded (hopefully), so must update limits and unique lists
+	storeFilters();
+	findFilterLimits();
+	if (updateOnly) retrieveFilters();
+	else resetFilters();
+	filterRunData();
+	updateDataTable();
+
+	if (updateOnly)
+	{
+		ui.DataTable->setEnabled(true);
+		ui.ReloadJournalButton->setEnabled(true);
+
+		// Restart reload timer (if active)
+		if (autoReload_) autoReloadTimer_.start();
+
+		// Start the progress hide timer, if the progressBar is now visible
+		if (statusHttpProgress_->isVisible()) hideProgressTimer_.start();
+
+		refreshing_ = false;
 	}
+	else
+	{
+		hideProgressTimer_.start();
 
-	// Start the progress hide timer, if the progressBar is now visible
-	if (statusHttpProgress_->isVisible()) hideProgressTimer_.start();
+		// Postpone background preloading while the user is busy
+		if (preloadEnabled_) preloadTimer_.start();
 
-	return result;
+		refreshing_ = false;
+		setJournalControlsEnabled(true);
+	}
+
+	// Carry on with any revalidation that was waiting for the data to arrive (if it has already revalidated the index, it was running when it had to wait)
+	if (revalidateAfterLoad_)
+	{
+		revalidateAfterLoad_ = false;
+		if (preloadRunning_) revalidateJournals();
+		else revalidate();
+	}
+}
+
+// Finalise loading of journal data, optionally adding its RunData to the current list
+bool JournalViewer::finaliseJournalLoad(const JournalLoadResult& loadResult, bool addToRunData)
+{
+	Journal* jrnl = loadResult.journal();
+
+	if (addToRunData) ui.statusbar->showMessage(loadResult.message(), 3000);
+
+	// Save / update local copy of the journal (if the loader retrieved it from the net)
+	if (!loadResult.localCopyData().isEmpty())
+	{
+		if (loadResult.localCopyOffset() == -1) DataInterface::saveLocalCopy(loadResult.localCopyData(), jrnl->filePath(), loadResult.modificationTime());
+		else DataInterface::appendLocalCopy(loadResult.localCopyData(), jrnl->filePath(), loadResult.localCopyOffset(), loadResult.modificationTime());
+	}
+
+	// Add any entries the loader staged rather than adding to the Journal itself (existing runs are updated in place, since they may be on display)
+	bool result = loadResult.result();
+	QSharedPointer<JournalEntries> stagedEntries = loadResult.stagedEntries();
+	if (result && stagedEntries)
+	{
+		result = jrnl->addEntries(*stagedEntries, true);
+		if (!result) msg.print("Journal '" + jrnl->name() + "' was reloaded while its update was being parsed, so the update was discarded.");
+		jrnl->setModificationTime(result ? loadResult.modificationTime() : QDateTime());
+		jrnl->setCheckTime(result ? QDateTime::currentDateTime() : QDateTime());
+	}
+
+	// (Re)index the journal's runs, run times and facets - whatever it now contains, even if loading failed - and discard its now out of date filter bitsets
+	runIndex_.addJournal(jrnl);
+	intervalIndex_.addJournal(jrnl);
+	facetIndex_.addJournal(jrnl);
+	runFilter_.removeJournal(jrnl);
+	tableGrouping_.invalidate();
+
+	// Index any new titles so that searches don't have to scan them
+	titleIndex_.update(RunCatalogue::stringPool());
+
+	// Add data to run list, if we were successful
+	if (!result)
+	{
+		msg.print(("Failed to load journal data '") + jrnl->fileName() + "' for instrument " + jrnl->parent()->capitalisedName());
+		return false;
+	}
+	if (addToRunData) for (RunData* rd = jrnl->runData().first(); rd != NULL; rd = rd->next) runData_.add(rd, jrnl);
+
+	return true;
+}
+
+// Return access type to use for the specified instrument's index and journals
+JournalViewer::JournalAccess JournalViewer::effectiveAccessType(Instrument* inst)
+{
+	// Local instrument data only ever comes from disk, and on startup we show only what we already have
+	if ((inst->instrument() == ISIS::LOCAL) || startingFromCache_) return JournalViewer::DiskOnlyAccess;
+	return journalAccessType_;
+}
+
+// Journal loader has finished
+void JournalViewer::journalLoaderFinished(JournalLoadResult result)
+{
+	loadingJournals_.remove(result.journal());
+
+	// Add the new data, and show it straight away
+	if (finaliseJournalLoad(result))
+	{
+		for (RunData* rd = result.journal()->runData().first(); rd != NULL; rd = rd->next) rd->setVisible(true);
+		nRunDataVisible_ += result.journal()->runData().nItems();
+		updateDataTable();
+	}
+	if (--nPendingJournalLoads_ > 0) return;
+
+	// All journals have arrived, so give the controls back and carry on from where setJournal() / updateJournalData() left off
+	ui.menubar->setEnabled(true);
+	ui.DisplayGroup->setEnabled(true);
+	ui.FilterGroup->setEnabled(true);
+	journalDataLoaded(updatingJournalData_);
 }
 
 // Update current journal data
@@ -420,6 +745,13 @@ bool JournalViewer::updateJournalData()
 		return false;
 	}
 
+	// A background revalidation of the instrument must finish before we touch its data, so carry on from preloadTaskFinished() once it has
+	if (preloading(currentInstrument_))
+	{
+		deferredUpdate_ = true;
+		return false;
+	}
+
 	refreshing_ = true;
 
 	// Stop progress hide timer, in case we re-use the progress bar here...
@@ -430,19 +762,8 @@ bool JournalViewer::updateJournalData()
 	ui.ReloadJournalButton->setEnabled(false);
 	runData_.clear();
 
-	// Check for 'All' being selected
-	QDateTime modificationTime;
-	JournalViewer::JournalAccess sourceType;
-	if (currentJournal_->name() == "All")
-	{
-		for (Journal* journal = currentInstrument_->journals(); journal != NULL; journal = journal->next)
-		{
-			// Skip 'All' journal entry
-			if (journal->name() == "All") continue;
-
-			if (!loadJournalData(journal, true)) msg.print("Failed to check for most recent version of journal.");
-		}
-	}
+	// Check for 'All' being selected (in which case its journals are loaded in the background, and journalDataLoaded() is called once they have all arrived)
+	if (currentJournal_->name() == "All") loadAllJournalData(true);
 	else
 	{
 		if (!loadJournalData(currentJournal_, true))
@@ -451,24 +772,8 @@ bool JournalViewer::updateJournalData()
 			msg.print("Failed to update journal '" + currentJournal_->name() + "' for instrument " + currentInstrument_->capitalisedName());
 			ui.statusbar->showMessage("Failed to update journal '" + currentJournal_->name() + "' for instrument " + currentInstrument_->capitalisedName(), 3000);
 		}
+		journalDataLoaded(true);
 	}
 
-	// New journal data has been loaded (hopefully), so must update limits and unique lists
-	storeFilters();
-	findFilterLimits();
-	retrieveFilters();
-	filterRunData();
-	updateDataTable();
-	ui.DataTable->setEnabled(true);
-	ui.ReloadJournalButton->setEnabled(true);
-
-	// Restart reload timer (if active)
-	if (autoReload_) autoReloadTimer_.start();
-	
-	// Start the progress hide timer, if the progressBar is now visible
-	if (statusHttpProgress_->isVisible()) hideProgressTimer_.start();
-
-	refreshing_ = false;
-
 	return true;
 }
@@ -0,0 +1,155 @@
+/*
+	*** JournalViewer Memory Accounting
+	*** src/jv_memory.cpp
+	Copyright T. Youngs 2012-2016
+
+	This file is part of JournalViewer.
+
+	JournalViewer is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	JournalViewer is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with JournalViewer.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "jv.h"
+#include "document.h"
+#include "rundatawindow.h"
+#include <QJsonArray>
+
+// Return report of estimated memory used by journals, block data, plots etc.
+QJsonObject JournalViewer::memoryReport()
+{
+	QJsonObject report;
+	qint64 totalBytes = 0;
+
+	// Journals (run catalogues and RunData), broken down by instrument
+	QJsonArray instruments;
+	for (Instrument* inst = instruments_.first(); inst != NULL; inst = inst->next)
+	{
+		QJsonArray journals;
+		qint64 instBytes = 0, instBlockDataBytes = 0;
+		int instRuns = 0;
+		for (Journal* jrnl = inst->journals(); jrnl != NULL; jrnl = jrnl->next)
+		{
+			// Skip journals which have not been loaded, or are being loaded in the background
+			if (loadingJournals_.contains(jrnl)) continue;
+			int nRuns = jrnl->runData().nItems();
+			if (nRuns == 0) continue;
+
+			qint64 bytes = jrnl->memoryUsage(), blockDataBytes = jrnl->blockDataMemoryUsage();
+			QJsonObject journal;
+			journal["name"] = jrnl->name();
+			journal["runs"] = nRuns;
+			journal["bytes"] = bytes;
+			journal["catalogueBytes"] = jrnl->catalogue()->memoryUsage();
+			journal["blockDataBytes"] = blockDataBytes;
+			journals.append(journal);
+
+			instRuns += nRuns;
+			instBytes += bytes;
+			instBlockDataBytes += blockDataBytes;
+		}
+		if (journals.isEmpty()) continue;
+
+		QJsonObject instrument;
+		instrument["name"] = inst->capitalisedName();
+		instrument["runs"] = instRuns;
+		instrument["bytes"] = instBytes;
+		instrument["blockDataBytes"] = instBlockDataBytes;
+		instrument["journals"] = journals;
+		instruments.append(instrument);
+
+		totalBytes += instBytes;
+	}
+	report["instruments"] = instruments;
+
+	// Loaded block data
+	QJsonObject blockData;
+	BlockDataCache& cache = RunData::blockDataCache();
+	blockData["bytes"] = cache.memoryUsage();
+	blockData["runs"] = cache.nRuns();
+	blockData["budgetBytes"] = cache.budget();
+	blockData["evictions"] = cache.nEvictions();
+	report["blockData"] = blockData;
+	totalBytes += cache.memoryUsage();
+
+	// Block value enumerations
+	QJsonObject enumerations;
+	enumerations["bytes"] = RunData::enumerationMemoryUsage();
+	report["enumerations"] = enumerations;
+	totalBytes += RunData::enumerationMemoryUsage();
+
+	// Shared string pool
+	QJsonObject strings;
+	strings["bytes"] = RunCatalogue::stringPool().memoryUsage();
+	strings["strings"] = RunCatalogue::nStrings();
+	report["stringPool"] = strings;
+	totalBytes += RunCatalogue::stringPool().memoryUsage();
+
+	// Run index
+	QJsonObject index;
+	index["bytes"] = runIndex_.memoryUsage();
+	index["runs"] = runIndex_.nRuns();
+	report["runIndex"] = index;
+	totalBytes += runIndex_.memoryUsage();
+
+	// Run time interval index
+	QJsonObject intervals;
+	intervals["bytes"] = intervalIndex_.memoryUsage();
+	intervals["runs"] = intervalIndex_.nRuns();
+	report["intervalIndex"] = intervals;
+	totalBytes += intervalIndex_.memoryUsage();
+
+	// Title search index
+	QJsonObject titles;
+	titles["bytes"] = titleIndex_.memoryUsage();
+	titles["strings"] = titleIndex_.nIndexed();
+	report["titleIndex"] = titles;
+	totalBytes += titleIndex_.memoryUsage();
+
+	// Cached filter bitsets
+	QJsonObject filter;
+	filter["bytes"] = runFilter_.memoryUsage();
+	report["runFilter"] = filter;
+	totalBytes += runFilter_.memoryUsage();
+
+	// Facets
+	QJsonObject facets;
+	facets["bytes"] = facetIndex_.memoryUsage();
+	report["facetIndex"] = facets;
+	totalBytes += facetIndex_.memoryUsage();
+
+	// Cached groups of the data table
+	QJsonObject grouping;
+	grouping["bytes"] = tableGrouping_.memoryUsage();
+	grouping["groups"] = tableGrouping_.nGroups();
+	report["tableGrouping"] = grouping;
+	totalBytes += tableGrouping_.memoryUsage();
+
+	// Copies of block data held by open plot windows
+	QList<RunDataWindow*> windows = findChildren<RunDataWindow*>();
+	qint64 plotBytes = 0;
+	for (int n=0; n<windows.count(); ++n) plotBytes += windows.at(n)->ui.PlotArea->dataSetMemoryUsage();
+	QJsonObject plots;
+	plots["windows"] = windows.count();
+	plots["bytes"] = plotBytes;
+	report["plots"] = plots;
+	totalBytes += plotBytes;
+
+	// Documents only exist while printing, so report the largest seen (not included in the total)
+	QJsonObject documents;
+	documents["largestBytes"] = Document::largestMemoryUsage();
+	report["documents"] = documents;
+
+	report["totalBytes"] = totalBytes;
+
+	return report;
+}
@@ -21,7 +21,6 @@
 
 #include "jv.h"
 #include "document.h"
-#include "ttablewidgetitem.h"
 #include "messenger.hui"
 
 // Create Document ready for printing
@@ -168,10 +167,8 @@ void JournalViewer::createDocument(Document& document, const RefList<RunData,int
 // Create text document
 void JournalViewer::createText(QString& string, const RefList<RunData,int>& data, QString separator)
 {
-	// Loop over table items rather than RunData, so we preserve the sort order of the items within it...
+	// The supplied RunData are already in the table's display (sort) order, as returned by getTableContents()
 	RunData* rd = NULL;
-	TTableWidgetItem* item = NULL, *nextItem;
-	int lastRunNumber = -1;
 
 	// Loop over list of selected RunData
 	for (RefListItem<RunData,int>* ri = data.first(); ri != NULL; ri = ri->next)
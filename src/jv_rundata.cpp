@@ -21,16 +21,40 @@
 
 #include "jv.h"
 #include "messenger.hui"
-#include "ttablewidgetitem.h"
 #include "rundatawindow.h"
 #include "datainterface.h"
+#include "stringmatcher.h"
+#include "searchtask.h"
 #include <QMessageBox>
 #include <QProgressDialog>
+#include <QTreeView>
+#include <QHeaderView>
+#include <QSignalBlocker>
+#include <QItemSelection>
+#include <QSet>
+#include <algorithm>
 
 /*
  * Run Data
  */
 
+// Return the distinct journals whose runs are in runData_, in order of first appearance
+QVector<Journal*> JournalViewer::runDataJournals()
+{
+	// Each journal's runs are contiguous in runData_ (revalidation rebuilds a journal's span in place), so only a change of journal needs checking against the set
+	QVector<Journal*> journals;
+	QSet<Journal*> seen;
+	for (RefListItem<RunData,Journal*>* ri = runData_.first(); ri != NULL; ri = ri->next)
+	{
+		if ((!journals.isEmpty()) && (journals.last() == ri->data)) continue;
+		if (seen.contains(ri->data)) continue;
+		seen.insert(ri->data);
+		journals << ri->data;
+	}
+
+	return journals;
+}
+
 // Determine limits, including construction of unique lists
 void JournalViewer::findFilterLimits()
 {
@@ -39,40 +63,36 @@ void JournalViewer::findFilterLimits()
 	availableRB_.clear();
 	availableRBUsers_.clear();
 
-	// Set initial values
-	RefListItem<RunData,Journal*>* ri = runData_.first();
-	if (ri != NULL)
+	// Merge the facets of the journals in the list (a journal's runs are always all present in runData_)
+	facetIndex_.merge(runDataJournals());
+
+	// Set limits
+	qint64 earliestStart, latestEnd;
+	if (facetIndex_.hasRuns())
 	{
-		RunData* rd = ri->item;
-		earliestRunStart_ = rd->startDateTime();
-		latestRunStart_ = rd->endDateTime();
-		firstRunNumber_ = rd->runNumber();
-		lastRunNumber_ = rd->runNumber();
+		earliestStart = facetIndex_.earliestStart();
+		latestEnd = facetIndex_.latestEnd();
+		firstRunNumber_ = facetIndex_.firstRunNumber();
+		lastRunNumber_ = facetIndex_.lastRunNumber();
 	}
 	else
 	{
-		earliestRunStart_ = QDateTime::currentDateTime();
-		latestRunStart_ = QDateTime::currentDateTime();
+		earliestStart = ISIS::epochSeconds(QDateTime::currentDateTime());
+		latestEnd = earliestStart;
 		firstRunNumber_ = 0;
 		lastRunNumber_ = 0;
 	}
+	earliestRunStart_ = ISIS::dateTime(earliestStart);
+	latestRunStart_ = ISIS::dateTime(latestEnd);
 
-	// Loop over items...
-	for (ri = runData_.first(); ri != NULL; ri = ri->next)
+	// Get unique users and RB numbers (with the user of the first run of each RB number)
+	for (int n=0; n<facetIndex_.nValues(FacetIndex::UserFacet); ++n) availableUsers_ << RunCatalogue::string(facetIndex_.value(FacetIndex::UserFacet, n));
+	for (int n=0; n<facetIndex_.nValues(FacetIndex::RBFacet); ++n)
 	{
-		RunData* rd = ri->item;
-		if (!availableUsers_.contains(rd->user())) availableUsers_ << rd->user();
-		if (!availableRB_.contains(rd->rbNumber()))
-		{
-			availableRB_ << rd->rbNumber();
-			availableRBUsers_ << rd->user();
-		}
-		if (rd->runNumber() < firstRunNumber_) firstRunNumber_ = rd->runNumber();
-		if (rd->runNumber() > lastRunNumber_) lastRunNumber_ = rd->runNumber();
-		if (rd->startDateTime() < earliestRunStart_) earliestRunStart_ = rd->startDateTime();
-		if (rd->endDateTime() > latestRunStart_) latestRunStart_ = rd->endDateTime();
+		availableRB_ << facetIndex_.value(FacetIndex::RBFacet, n);
+		availableRBUsers_ << RunCatalogue::string(facetIndex_.firstUser(FacetIndex::RBFacet, n));
 	}
-	
+
 	// Recreate combo box items
 	ui.FilterUserCombo->clear();
 	ui.FilterUserCombo->addItem("<All>");
@@ -151,137 +171,45 @@ void JournalViewer::resetFilters()
 // Create groups over visible RunData
 void JournalViewer::createGroups()
 {
-	int index, row, nRows = ui.DataTable->rowCount();
-	int column = visibleProperties_.nItems();
-	TTableWidgetItem* item;
-	RunData* runData;
-	
-	// Create a list of unique Run Titles from the visible table items, and assign group numbers from that
-	QList<QString> runTitles;
-	for (row = 0; row < nRows; ++row)
-	{
-		item = (TTableWidgetItem*) ui.DataTable->item(row, 0);
-		if (!item)
-		{
-			msg.print("JournalViewer::createGroups() - Failed to get item from DataTable");
-			continue;
-		}
-		runData = item->source();
-		index = runTitles.indexOf(runData->title());
-		if (index == -1)
-		{
-			runTitles << runData->title();
-			index = runTitles.count()-1;
-		}
-		runData->setGroup(index);
-	}
-	
-	// Loop over DataTable items and set new Group numbers
-	for (row = 0; row < nRows; ++row)
-	{
-		item = (TTableWidgetItem*) ui.DataTable->item(row, column);
-		if (!item)
-		{
-			msg.print("JournalViewer::createGroups() - Failed to get item from DataTable");
-			continue;
-		}
-		item->setText(QString::number(item->source()->group()));
-	}
+	// Group the visible runs by their titles, and set new Group numbers
+	RunGrouping& grouping = tableGrouping();
+	const QVector<RunData*>& runs = dataTableModel_.runs();
+	for (int n=0; n<runs.count(); ++n) runs.at(n)->setGroup(grouping.groupOf(runs.at(n)));
+
+	dataTableModel_.groupsChanged();
 }
 
 // Update data table
 void JournalViewer::updateDataTable()
 {
-	// Store existing sort column and direction
-	QHeaderView* headerView = ui.DataTable->horizontalHeader();
-	RunProperty::Property sortProperty = RunProperty::nProperties;
-	Qt::SortOrder sortOrder = Qt::AscendingOrder;
-	if (headerView)
-	{
-		sortOrder = headerView->sortIndicatorOrder();
-		QTableWidgetItem* headerItem = ui.DataTable->horizontalHeaderItem(headerView->sortIndicatorSection());
-		if (headerItem) sortProperty = RunProperty::property(headerItem->text());
-	}
-
-	// Keep the current item selection in the table - construct a new list of the selected items.
+	// Keep the current selection in the table - construct a new list of the selected items.
 	RefList<RunData,int> selectedData = getTableContents(true);
 
-	// Clear table and set headers
-	ui.DataTable->clear();
-	ui.DataTable->setRowCount(nRunDataVisible_);
-	ui.DataTable->setSortingEnabled(false);
-	ui.DataTable->setColumnCount(visibleProperties_.nItems()+1);
-	ui.DataTable->setSelectionMode(QAbstractItemView::MultiSelection);
+	// Set columns, and swap in the visible runs - the model serves their data on demand, so there's nothing to create per cell
+	bool columnsChanged = dataTableModel_.setColumns(visibleProperties_);
+	tableRuns_.clear();
+	tableRuns_.reserve(nRunDataVisible_);
+	for (RefListItem<RunData,Journal*>* ri = runData_.first(); ri != NULL; ri = ri->next) if (ri->item->visible()) tableRuns_ << ri->item;
+	dataTableModel_.setRuns(tableRuns_);
 
-	QStringList headers;
-	for (RunProperty* rp = visibleProperties_.first(); rp != NULL; rp = rp->next) headers << RunProperty::property(rp->type());
-	headers << RunProperty::property(RunProperty::GroupNumber);
-	ui.DataTable->setHorizontalHeaderLabels(headers);
+	// Show the sort column and order kept by the model (it sorts the runs itself, so this won't sort them again)
+	ui.DataTable->horizontalHeader()->setSortIndicator(dataTableModel_.column(dataTableModel_.sortProperty()), dataTableModel_.sortOrder());
 
-	QTableWidgetItem* item;
-	int col, row = 0;
-	for (RefListItem<RunData,Journal*>* ri = runData_.first(); ri != NULL; ri = ri->next)
+	// Reselect previously-selected runs
+	if (selectedData.nItems() != 0)
 	{
-		RunData* rd = ri->item;
-		// If item is not visible (has been filtered) then continue
-		if (!rd->visible()) continue;
-
-		col = 0;
-		for (RunProperty* rp = visibleProperties_.first(); rp != NULL; rp = rp->next)
-		{
-			// Create table entry with proper sorting type...
-			switch (rp->type())
-			{
-				case (RunProperty::RunNumber):
-				case (RunProperty::RBNumber):
-					item = new TTableWidgetItem(rd, rd->propertyAsString(rp->type()), TTableWidgetItem::IntegerSort);
-					break;
-				case (RunProperty::Duration):
-					item = new TTableWidgetItem(rd, rd->propertyAsString(rp->type()), TTableWidgetItem::DurationSort);
-					break;
-				case (RunProperty::StartTimeAndDate):
-				case (RunProperty::StartTime):
-				case (RunProperty::StartDate):
-				case (RunProperty::EndTimeAndDate):
-				case (RunProperty::EndTime):
-				case (RunProperty::EndDate):
-					item = new TTableWidgetItem(rd, rd->propertyAsString(rp->type()), TTableWidgetItem::DateSort);
-					break;
-				default:
-					item = new TTableWidgetItem(rd, rd->propertyAsString(rp->type()), TTableWidgetItem::StringSort);
-					break;
-			}
-			
-			ui.DataTable->setItem(row, col, item);
-			++col;
-		}
-		
-		// Add Group data to last, hidden column
-		item = new TTableWidgetItem(rd, rd->propertyAsString(RunProperty::GroupNumber), TTableWidgetItem::IntegerSort);
-		ui.DataTable->setItem(row, col, item);
-
-		// Select item?
-		if (selectedData.contains(rd)) ui.DataTable->selectRow(row);
-
-		++row;
+		const QVector<RunData*>& runs = dataTableModel_.runs();
+		QVector<int> rows;
+		for (int row = 0; row < runs.count(); ++row) if (selectedData.contains(runs.at(row))) rows << row;
+		selectDataTableRows(rows);
 	}
 
-	// Final changes to table
-	ui.DataTable->setSelectionMode(QAbstractItemView::ExtendedSelection);
-	ui.DataTable->setSortingEnabled(true);
-	ui.DataTable->sortItems(0);
-	ui.DataTable->setRowCount(row);
-	// -- Does previous sort column still exist in new table?
-	if (sortProperty == RunProperty::GroupNumber) ui.DataTable->sortByColumn(visibleProperties_.nItems(), sortOrder);
-	else for (col = 0; col < visibleProperties_.nItems(); ++col) if (visibleProperties_[col]->type() == sortProperty) ui.DataTable->sortByColumn(col, sortOrder);
-	ui.DataTable->resizeColumnsToContents();
-
 	// Show all columns except the Group column
-	for (col = 0; col < visibleProperties_.nItems() + 1; ++col)
+	if (columnsChanged)
 	{
-		if (ui.DataTable->horizontalHeaderItem(col) == NULL) continue;
-		ui.DataTable->setColumnHidden(col, ui.DataTable->horizontalHeaderItem(col)->text() == "Group");
+		for (int col = 0; col < dataTableModel_.columnCount(); ++col) ui.DataTable->setColumnHidden(col, dataTableModel_.columnProperty(col) == RunProperty::GroupNumber);
 	}
+	estimateDataTableColumnWidths();
 
 	// Create groups if necessary
 	if (viewByGroup_) createGroups();
@@ -293,118 +221,94 @@ void JournalViewer::updateDataTable()
 	updateStatusBarPermanentWidgets();
 }
 
+// Set column widths of data table, estimated from a sample of its rows
+void JournalViewer::estimateDataTableColumnWidths()
+{
+	// Measure evenly-spaced rows (formatted values are similar in length, so this is representative) rather than every cell
+	const int nSamples = 100;
+	int nRows = dataTableModel_.rowCount(), step = qMax(1, nRows / nSamples), width;
+	QHeaderView* headerView = ui.DataTable->horizontalHeader();
+	for (int col = 0; col < dataTableModel_.columnCount(); ++col)
+	{
+		if (ui.DataTable->isColumnHidden(col)) continue;
+
+		width = headerView->sectionSizeHint(col);
+		for (int row = 0; row < nRows; row += step) width = qMax(width, ui.DataTable->sizeHintForIndex(dataTableModel_.index(row, col)).width());
+		if (nRows > 0) width = qMax(width, ui.DataTable->sizeHintForIndex(dataTableModel_.index(nRows-1, col)).width());
+		ui.DataTable->setColumnWidth(col, width);
+	}
+}
+
+// Select (exclusively) specified rows of the data table
+void JournalViewer::selectDataTableRows(QVector<int> rows)
+{
+	// Select runs of consecutive rows as single ranges, rather than row by row
+	std::sort(rows.begin(), rows.end());
+	QItemSelection selection;
+	int lastColumn = dataTableModel_.columnCount() - 1;
+	for (int n=0; n<rows.count(); )
+	{
+		int first = rows.at(n), last = first;
+		for (++n; (n < rows.count()) && (rows.at(n) <= last+1); ++n) last = rows.at(n);
+		selection.append(QItemSelectionRange(dataTableModel_.index(first, 0), dataTableModel_.index(last, lastColumn)));
+	}
+	ui.DataTable->selectionModel()->select(selection, QItemSelectionModel::ClearAndSelect | QItemSelectionModel::Rows);
+}
+
 // Filter run data 
 void JournalViewer::filterRunData()
 {
-	// Grab current search/filter parameters
-	QString search = ui.SearchEdit->text();
-	JournalViewer::SearchStyle style = (JournalViewer::SearchStyle) ui.SearchStyleCombo->currentIndex();
+	// Grab current filter parameters - the title search is the one last committed by startTitleSearch(), so that a search still being typed
+	// (or running in the background) is never run here on the GUI thread
 	bool filterUser = (ui.FilterUserCombo->currentText() != "<All>");
 	QString filterUserString = ui.FilterUserCombo->currentText();
 	bool filterRB = (ui.FilterRBCombo->currentText() != "<All>");
 	QString filterRBString = ui.FilterRBCombo->currentText();
-	QDateTime filterFromDateTime = ui.FilterFromDateTimeEdit->dateTime();
-	QDateTime filterToDateTime = ui.FilterToDateTimeEdit->dateTime();
+	qint64 filterFromTime = ISIS::epochSeconds(ui.FilterFromDateTimeEdit->dateTime());
+	qint64 filterToTime = ISIS::epochSeconds(ui.FilterToDateTimeEdit->dateTime());
 	int filterFromRunInt = ui.FilterFromRunSpin->value();
 	int filterToRunInt = ui.FilterToRunSpin->value();
 	bool dateFilterOnRunning = ui.FilterDateTypeCombo->currentIndex() == 0;
 
-	// Create a regular expression from the 'search' string
-	bool hasTitleSearch = (!search.isEmpty());
-	QRegExp titleExpr(search);
-	if (style == JournalViewer::TextStyle) titleExpr.setPatternSyntax(QRegExp::FixedString);
-	else if (style == JournalViewer::WildStyle) titleExpr.setPatternSyntax(QRegExp::WildcardUnix);
-	else titleExpr.setPatternSyntax(QRegExp::RegExp);
-	titleExpr.setCaseSensitivity(ui.SearchCaseSensitiveCheck->isChecked() ? Qt::CaseSensitive : Qt::CaseInsensitive);
-
-	// Check that RegExp is valid - if not, highlight text in red and exit
-	static QPalette palette;
-	if (!titleExpr.isValid())
-	{
-		palette.setColor(QPalette::Text, Qt::red);
-		ui.SearchEdit->setPalette(palette);
-		return;
-	}
-	palette.setColor(QPalette::Text, Qt::black);
-	ui.SearchEdit->setPalette(palette);
-
-	// Create a search pattern from the 'User' and RBNo strings
-	QRegExp userExpr(filterUserString);
-	userExpr.setPatternSyntax(QRegExp::FixedString);
-	userExpr.setCaseSensitivity(Qt::CaseInsensitive);
-	QRegExp rbExpr(filterRBString);
-	rbExpr.setPatternSyntax(QRegExp::FixedString);
-	rbExpr.setCaseSensitivity(Qt::CaseInsensitive);
+	// Update filter criteria - only those bitsets whose criterion has changed will be recalculated
+	runFilter_.setUser(filterUser ? filterUserString : QString());
+	runFilter_.setRBNumber(filterRB ? filterRBString : QString());
+	runFilter_.setDateRange(filterFromTime, filterToTime, dateFilterOnRunning);
+	runFilter_.setRunNumberRange(filterFromRunInt, filterToRunInt);
 
-	// Loop over loaded RunData and hide those for which the string matches
+	// Set visibility of loaded RunData, one journal at a time
 	nRunDataVisible_ = 0;
 	bool visible;
-	for (RefListItem<RunData,Journal*>* ri = runData_.first(); ri != NULL; ri = ri->next)
+	RefListItem<RunData,Journal*>* ri = runData_.first();
+	while (ri != NULL)
 	{
-		RunData* rd = ri->item;
-
-		// Simple filtering based on search string in title
-		if (hasTitleSearch) visible = (titleExpr.indexIn(rd->title()) != -1);
-		else visible = true;
-
-		// Now additional filters (unless no match to simple search string)
-		if (visible)
+		Journal* jrnl = ri->data;
+		QBitArray rowVisible = runFilter_.visibility(jrnl);
+		for (; (ri != NULL) && (ri->data == jrnl); ri = ri->next)
 		{
-			if (filterUser && (userExpr.indexIn(rd->user()) == -1)) visible = false;
-			else if (rd->endDateTime() < filterFromDateTime) visible = false;
-			else if (rd->startDateTime() > filterToDateTime) visible = false;
-// 			else if (dateFilterOnRunning && (rd->startDateTime() > filterToDateTime)) visible = false;
-			else if ((!dateFilterOnRunning) &&  (rd->startDateTime() < filterFromDateTime)) visible = false;
-			else if (filterRB && (rbExpr.indexIn(QString::number(rd->rbNumber())) == -1)) visible = false;
-			else if (rd->runNumber() < filterFromRunInt) visible = false;
-			else if (rd->runNumber() > filterToRunInt) visible = false;
+			visible = rowVisible.testBit(ri->item->row());
+			ri->item->setVisible(visible);
+			if (visible) ++nRunDataVisible_;
 		}
-
-		rd->setVisible(visible);
-		if (visible) ++nRunDataVisible_;
 	}
+
+	updateFacetCounts();
 }
 
 // Update data table highlighting
 void JournalViewer::updateDataTableHighlighting()
 {
-	// Setup brushes for colouring rows
-	QBrush normalRow(Qt::white), highlightedRow(highlightBGColour_);
-	
-	// Determine highlighting style
-	bool highlight = true;
+	// Highlight alternate rows, or alternate groups if viewing by group - the model serves the row backgrounds on demand
+	dataTableModel_.setHighlighting(viewByGroup_, highlightBGColour_);
+}
 
-	// Loop over TTableWidgetItems
-	TTableWidgetItem* item;
-	int nRows = ui.DataTable->rowCount(), nColumns = ui.DataTable->columnCount(), column;
-	for (int row = 0; row < nRows; ++row)
+// Pin (or unpin) block data of all runs in the supplied list
+static void pinBlockData(RefList<RunData,int>& runs, bool pin)
+{
+	for (RefListItem<RunData,int>* ri = runs.first(); ri != NULL; ri = ri->next)
 	{
-		// Set highlight status
-		if (viewByGroup_)
-		{
-			// Get item from table so we can check group number
-			item = (TTableWidgetItem*) ui.DataTable->item(row, 0);
-			if (!item)
-			{
-				msg.print("JournalViewer::updateDataTableHighlighting() - Failed to get item from DataTable.");
-				continue;
-			}
-			highlight = item->source()->group()%2 == 0;
-		}
-		else highlight = !highlight;
-
-		// Loop over columns...
-		for (column = 0; column < nColumns; ++column)
-		{
-			// Get item from table so we can check group number
-			item = (TTableWidgetItem*) ui.DataTable->item(row, column);
-			if (!item)
-			{
-				msg.print("JournalViewer::updateDataTableHighlighting() - Failed to get item from DataTable.");
-				continue;
-			}
-			item->setBackground(highlight ? highlightedRow : normalRow);
-		}
+		if (pin) RunData::blockDataCache().pin(BlockDataCache::runKey(ri->item));
+		else RunData::blockDataCache().unpin(BlockDataCache::runKey(ri->item));
 	}
 }
 
@@ -418,6 +322,9 @@ void JournalViewer::plotSelectedRunData(RunData::BlockDataSource source, bool fo
 
 	QProgressDialog progress("Loading data...", "Cancel", 0, selectedData.nItems(), this);
 	progress.setWindowModality(Qt::WindowModal);
+
+	// Pin the selected runs while loading, so that loading later runs can't evict earlier ones
+	pinBlockData(selectedData, true);
      
 	// Loop over selected RunData
 	RunData* rd;
@@ -439,70 +346,57 @@ void JournalViewer::plotSelectedRunData(RunData::BlockDataSource source, bool fo
 	progress.setValue(selectedData.nItems());
 
 	// Was the progress dialog canceled?
-	if (n != selectedData.nItems()) return;
+	if (n != selectedData.nItems())
+	{
+		pinBlockData(selectedData, false);
+		return;
+	}
 
 	// Did we load all (any?) data
 	if (nLoaded == 0)
 	{
+		pinBlockData(selectedData, false);
 		QMessageBox::warning(this, "Failed to Load Data", QString("Couldn't load any data for the selected runs.\nCheck the path to the data directories in Settings.\n"));
 		return;
 	}
 	else if (nLoaded != selectedData.nItems())
 	{
 		QMessageBox::StandardButton button = QMessageBox::question(this, "Failed to Load Data", QString("Not all log/Nexus files could be loaded - ") + QString::number(selectedData.nItems() - nLoaded) + " of " + QString::number(selectedData.nItems()) + " failed.\nPlot anyway?", QMessageBox::Yes | QMessageBox::No, QMessageBox::Yes);
-		if (button == QMessageBox::No) return;
+		if (button == QMessageBox::No)
+		{
+			pinBlockData(selectedData, false);
+			return;
+		}
 	}
 	
-	// Now create a RunDataWindow to display the data
+	// Now create a RunDataWindow to display the data (it holds its own pins on the runs)
 	RunDataWindow* runDataWin = new RunDataWindow(this, plotFont_);
 	runDataWin->setWindowTitle(rd->instrument()->capitalisedName() + " Run Data");
 	for (RefListItem<RunData,int>* ri = selectedData.first(); ri != NULL; ri = ri->next) runDataWin->addRunData(ri->item);
 	runDataWin->finaliseAndShow();
+	pinBlockData(selectedData, false);
 }
 
 // Create list of RunData from table
 RefList<RunData,int> JournalViewer::getTableContents(bool selectionOnly)
 {
+	// Index the list, since callers check for membership
 	RefList<RunData,int> data;
+	data.setIndexed(true);
 
 	// Depending on whether we're creating a document for the entire table, or just a selection of it, set up loop differently
-	QList<QTableWidgetItem*> selectedItems = ui.DataTable->selectedItems();
-	int totalItems = selectionOnly ? selectedItems.count() : ui.DataTable->rowCount();
-	RunData* rd = NULL;
-	TTableWidgetItem* item = NULL, *nextItem;
-	int lastRunNumber = -1;
-	for (int index = 0; index < totalItems; ++index)
-	{
-		// Grab an item in the row (it doesn't matter which) and grab its source RunData pointer
-		if (selectionOnly) nextItem = (TTableWidgetItem*) selectedItems[index];
-		else nextItem = (TTableWidgetItem*) ui.DataTable->item(index, 0);
-
-		// Check for valid item
-		if (nextItem == NULL)
-		{
-			msg.print("Failed to retrieve TTableWidgetItem for index %i", index);
-			continue;
-		}
-
-		// Since the list contains each cell in the row, we need to exclude duplicates...
-		if (selectionOnly && (nextItem->source() == rd)) continue;
-		item = nextItem;
-
-		// Get RunData pointer
-		rd = item->source();
-		if (rd == NULL)
-		{
-			msg.print("Strange - this TTableWidgetItem has no runData pointer. Table index = ", index);
-			continue;
-		}
-
-		// Check this run number with the last found (since multiple tablewidgetitems can have the same RunNumber)
-		// We don't know which order they'll be in in the list, though, so must still addUniqiue() to our list.
-		if (rd->runNumber() == lastRunNumber) continue;
-
-		data.addUnique(rd);
-		lastRunNumber = rd->runNumber();
+	const QVector<RunData*>& runs = dataTableModel_.runs();
+	if (selectionOnly)
+	{
+		// Selected rows are returned in the order they were selected, so sort them back into display order
+		QModelIndexList selectedRows = ui.DataTable->selectionModel()->selectedRows();
+		QVector<int> rows;
+		rows.reserve(selectedRows.count());
+		for (int n=0; n<selectedRows.count(); ++n) rows << selectedRows.at(n).row();
+		std::sort(rows.begin(), rows.end());
+		for (int n=0; n<rows.count(); ++n) data.add(runs.at(rows.at(n)));
 	}
+	else for (int row = 0; row < runs.count(); ++row) data.add(runs.at(row));
 
 	return data;
 }
@@ -581,25 +475,13 @@ int JournalViewer::find(QString text, JournalViewer::SearchStyle style, bool cas
 	int titleColumn = runPropertyColumn(RunProperty::Title);
 	if (titleColumn == -1) return -1;
 
-	// Create a regular expression from the 'search' string
-	QRegExp searchExpr(findText_);
-	if (style == JournalViewer::TextStyle) searchExpr.setPatternSyntax(QRegExp::FixedString);
-	else if (style == JournalViewer::WildStyle) searchExpr.setPatternSyntax(QRegExp::WildcardUnix);
-	else searchExpr.setPatternSyntax(QRegExp::RegExp);
-	searchExpr.setCaseSensitivity(ui.SearchCaseSensitiveCheck->isChecked() ? Qt::CaseSensitive : Qt::CaseInsensitive);
-
-	// Loop over current rows (in their display order)
-	int nRows = ui.DataTable->rowCount();
-	QTableWidgetItem* item;
-	for (int n=0; n < nRows; ++n)
-	{
-		// See if this item matches
-		item = ui.DataTable->item(n, titleColumn);
-
-		if (item->text().contains(findText_)) findMatches_.add(n);
-	}
+	// Create a regular expression from the 'search' string, and test the titles of all rows
+	QRegExp searchExpr = searchExpression(findText_, style, caseSensitive);
+	QVector<int> titleIds = tableTitleIds(), titleMatchCache;
+	prepareTitleMatches(searchExpr, titleMatchCache);
+	StringMatcher::match(searchExpr, titleIds.constData(), titleIds.count(), titleMatchCache);
 
-	return findMatches_.nItems();
+	return setFindMatches(searchExpr, titleMatchCache);
 }
 
 // Return current number of find matches
@@ -628,6 +510,7 @@ bool JournalViewer::findNext()
 	// Get table row from the findMatches_ array, and select all of its columns
 	int row = findMatches_[lastFindMatchIndex_];
 	ui.DataTable->selectRow(row);
+	ui.DataTable->scrollTo(dataTableModel_.index(row, 0));
 
 	return true;
 }
@@ -652,6 +535,387 @@ bool JournalViewer::findPrevious()
 	// Get table row from the findMatches_ array, and select all of its columns
 	int row = findMatches_[lastFindMatchIndex_];
 	ui.DataTable->selectRow(row);
+	ui.DataTable->scrollTo(dataTableModel_.index(row, 0));
 
 	return true;
 }
+
+/*
+ * Title Index
+ */
+
+// Update title index and initialise match cache for the supplied expression, ruling out titles which cannot match
+void JournalViewer::prepareTitleMatches(const QRegExp& expr, QVector<int>& matches)
+{
+	// Index any strings added since the last search
+	titleIndex_.update(RunCatalogue::stringPool());
+
+	// Strings not returned as candidates by the index cannot match (0) - all others must be tested (-1)
+	// Strings added to the pool after the update are beyond the end of the cache, and will be tested
+	QVector<int> candidates;
+	if (titleIndex_.candidates(expr, candidates))
+	{
+		matches.fill(0, titleIndex_.nIndexed());
+		for (int n=0; n<candidates.count(); ++n) matches[candidates.at(n)] = -1;
+	}
+	else matches.fill(-1, titleIndex_.nIndexed());
+}
+
+// Return whether the title with specified string id matches the supplied expression, caching the result
+bool JournalViewer::titleMatches(int titleId, const QRegExp& expr, QVector<int>& matches)
+{
+	// Strings may have been added to the pool since the cache was prepared
+	while (titleId >= matches.size()) matches.append(-1);
+	int& match = matches[titleId];
+	if (match == -1) match = (expr.indexIn(RunCatalogue::string(titleId)) != -1);
+	return match;
+}
+
+// Create search expression from text in the specified style
+QRegExp JournalViewer::searchExpression(QString text, JournalViewer::SearchStyle style, bool caseSensitive)
+{
+	QRegExp expr(text);
+	if (style == JournalViewer::TextStyle) expr.setPatternSyntax(QRegExp::FixedString);
+	else if (style == JournalViewer::WildStyle) expr.setPatternSyntax(QRegExp::WildcardUnix);
+	else expr.setPatternSyntax(QRegExp::RegExp);
+	expr.setCaseSensitivity(caseSensitive ? Qt::CaseSensitive : Qt::CaseInsensitive);
+
+	return expr;
+}
+
+/*
+ * Facets
+ */
+
+// Set up filter combo to show run counts and proton charge alongside each value
+void JournalViewer::setupFacetCombo(QComboBox* combo)
+{
+	// Extra columns (added when the counts are first set) are only shown in the popup list, since the combo itself only displays the first
+	QTreeView* view = new QTreeView(combo);
+	view->setHeaderHidden(true);
+	view->setRootIsDecorated(false);
+	view->setItemsExpandable(false);
+	view->setUniformRowHeights(true);
+	view->setAllColumnsShowFocus(true);
+	combo->setView(view);
+}
+
+// Update run counts and proton charge of each value shown in filter combo
+void JournalViewer::updateFacetCombo(QComboBox* combo, FacetIndex::Facet facet)
+{
+	// Changing the data of the current item resets any text typed into the combo, so keep hold of it
+	QSignalBlocker blocker(combo);
+	QString text = combo->currentText();
+
+	// Combo items follow the facet values, after the initial '<All>' item
+	QAbstractItemModel* model = combo->model();
+	if (model->columnCount() < 3) model->insertColumns(model->columnCount(), 3 - model->columnCount());
+	int nRuns;
+	double protonCharge;
+	for (int n=0; n<facetIndex_.nValues(facet); ++n)
+	{
+		if (n+1 >= model->rowCount()) break;
+		nRuns = facetIndex_.nRuns(facet, n);
+		protonCharge = facetIndex_.protonCharge(facet, n);
+		model->setData(model->index(n+1, 1), QString::number(nRuns) + (nRuns == 1 ? " run" : " runs"));
+		model->setData(model->index(n+1, 2), QString::number(protonCharge, 'f', 1) + " uAmps");
+	}
+
+	// The '<All>' item shows the totals (user counts overlap, since a run is counted for every user whose filter would match it)
+	if (model->rowCount() > 0)
+	{
+		int totalRuns = facetIndex_.totalRuns(facet);
+		double totalProtonCharge = facetIndex_.totalProtonCharge(facet);
+		model->setData(model->index(0, 1), QString::number(totalRuns) + (totalRuns == 1 ? " run" : " runs"));
+		model->setData(model->index(0, 2), QString::number(totalProtonCharge, 'f', 1) + " uAmps");
+	}
+	if (combo->currentText() != text) combo->setEditText(text);
+
+	// Make sure the popup is wide enough to show all columns
+	QTreeView* view = qobject_cast<QTreeView*>(combo->view());
+	if (view == NULL) return;
+	for (int n=0; n<3; ++n) view->resizeColumnToContents(n);
+	view->setMinimumWidth(view->header()->length() + view->frameWidth()*2);
+}
+
+// Update run counts and proton charge shown for users, RB numbers and cycles
+void JournalViewer::updateFacetCounts()
+{
+	// Users and RB numbers are counted over the runs passing all other filters, so the counts show what selecting each would give
+	facetIndex_.resetCounts();
+	foreach (Journal* jrnl, runDataJournals())
+	{
+		facetIndex_.count(FacetIndex::UserFacet, jrnl, runFilter_.visibility(jrnl, RunFilter::UserCriterion));
+		facetIndex_.count(FacetIndex::RBFacet, jrnl, runFilter_.visibility(jrnl, RunFilter::RBCriterion));
+		facetIndex_.count(FacetIndex::CycleFacet, jrnl, runFilter_.visibility(jrnl));
+	}
+
+	updateFacetCombo(ui.FilterUserCombo, FacetIndex::UserFacet);
+	updateFacetCombo(ui.FilterRBCombo, FacetIndex::RBFacet);
+
+	// Cycles are summarised in the journal combo's tooltip
+	QString cycleSummary = "Runs passing the current filters:";
+	int nRuns;
+	for (int n=0; n<facetIndex_.nValues(FacetIndex::CycleFacet); ++n)
+	{
+		nRuns = facetIndex_.nRuns(FacetIndex::CycleFacet, n);
+		if (nRuns == 0) continue;
+		cycleSummary += "\nCycle " + ISIS::cycleText(facetIndex_.value(FacetIndex::CycleFacet, n)) + " : " + QString::number(nRuns) + (nRuns == 1 ? " run, " : " runs, ") + QString::number(facetIndex_.protonCharge(FacetIndex::CycleFacet, n), 'f', 1) + " uAmps";
+	}
+	ui.JournalCombo->setToolTip(cycleSummary);
+}
+
+/*
+ * Grouping
+ */
+
+// Group runs in the data table (in display order), reusing the cached groups if the table is unchanged
+RunGrouping& JournalViewer::tableGrouping()
+{
+	// Groups are numbered in order of first appearance in the table, as they always have been
+	tableGrouping_.group(dataTableModel_.runs());
+	return tableGrouping_;
+}
+
+/*
+ * Background Search
+ */
+
+// Resolve title matches for the supplied title ids, starting a background search (whose handle is returned) unless there are only a few to test
+SearchHandle JournalViewer::startSearch(const QRegExp& expr, const QVector<int>& titleIds, QVector<int>& matches, const char* finishedSlot)
+{
+	prepareTitleMatches(expr, matches);
+
+	// Find the distinct titles which the title index couldn't rule out
+	QVector<int> pending;
+	int id;
+	for (int n=0; n<titleIds.count(); ++n)
+	{
+		id = titleIds.at(n);
+		if (id < 0) continue;
+		while (id >= matches.size()) matches.append(-1);
+		if (matches.at(id) != -1) continue;
+		matches[id] = -2;
+		pending.append(id);
+	}
+	for (int n=0; n<pending.count(); ++n) matches[pending.at(n)] = -1;
+
+	// Not worth a background task if there are only a few titles to test
+	if (pending.count() < StringMatcher::minimumChunkSize)
+	{
+		StringMatcher::match(expr, pending.constData(), pending.count(), matches);
+		return SearchHandle();
+	}
+
+	SearchTask* task = new SearchTask(expr, pending, matches, this, finishedSlot);
+	SearchHandle handle = task->handle();
+	searchPool_.start(task);
+
+	return handle;
+}
+
+// Apply resolved title matches to the run filter, updating the data table
+void JournalViewer::applyTitleMatches(const QRegExp& expr, const QVector<int>& matches)
+{
+	// The filter will not reinitialise its match cache since the expression will be unchanged when the filter is run
+	runFilter_.setTitleExpression(expr);
+	runFilter_.titleMatches() = matches;
+
+	filterRunData();
+	updateDataTable();
+}
+
+// Return title ids of the runs in the data table, in display order (-1 for rows with no run)
+QVector<int> JournalViewer::tableTitleIds()
+{
+	const QVector<RunData*>& runs = dataTableModel_.runs();
+	QVector<int> titleIds(runs.count(), -1);
+	for (int n=0; n < runs.count(); ++n) titleIds[n] = runs.at(n)->titleId();
+
+	return titleIds;
+}
+
+// Set Find matches from the runs in the data table, returning the number of matches
+int JournalViewer::setFindMatches(const QRegExp& expr, QVector<int>& matches)
+{
+	findMatches_.clear();
+	lastFindMatchIndex_ = -1;
+
+	// Table contents may have changed since the matches were resolved, so any new titles are tested here
+	QVector<int> titleIds = tableTitleIds();
+	for (int n=0; n < titleIds.count(); ++n)
+	{
+		if ((titleIds.at(n) != -1) && titleMatches(titleIds.at(n), expr, matches)) findMatches_.add(n);
+	}
+
+	return findMatches_.nItems();
+}
+
+// Start Find in the background, emitting findFinished() when it is done
+void JournalViewer::startFind(QString text, JournalViewer::SearchStyle style, bool caseSensitive)
+{
+	findSearch_.cancel();
+
+	findMatches_.clear();
+	findText_ = text;
+	findSearchStyle_ = style;
+	findCaseSensitive_ = caseSensitive;
+	lastFindMatchIndex_ = -1;
+
+	// Nothing to find if there is no search text or no title column to find it in
+	QRegExp searchExpr = searchExpression(findText_, style, caseSensitive);
+	if (findText_.isEmpty() || (!searchExpr.isValid()) || (runPropertyColumn(RunProperty::Title) == -1))
+	{
+		emit(findFinished(0));
+		return;
+	}
+
+	QVector<int> titleMatchCache;
+	findSearch_ = startSearch(searchExpr, tableTitleIds(), titleMatchCache, "findSearchFinished");
+	if (findSearch_.isNull()) emit(findFinished(setFindMatches(searchExpr, titleMatchCache)));
+}
+
+// Cancel any Find running in the background
+void JournalViewer::cancelFind()
+{
+	findSearch_.cancel();
+}
+
+// Start title search for the current search text
+void JournalViewer::startTitleSearch()
+{
+	searchTimer_.stop();
+	titleSearch_.cancel();
+
+	QRegExp titleExpr = searchExpression(ui.SearchEdit->text(), (JournalViewer::SearchStyle) ui.SearchStyleCombo->currentIndex(), ui.SearchCaseSensitiveCheck->isChecked());
+
+	// Check that RegExp is valid - if not, highlight text in red and leave the current search in place
+	static QPalette palette;
+	if (!titleExpr.isValid())
+	{
+		palette.setColor(QPalette::Text, Qt::red);
+		ui.SearchEdit->setPalette(palette);
+		return;
+	}
+	palette.setColor(QPalette::Text, Qt::black);
+	ui.SearchEdit->setPalette(palette);
+
+	// Empty expressions (which match everything), and those already applied, need no search
+	if (titleExpr.pattern().isEmpty()) runFilter_.setTitleExpression(QRegExp());
+	if (titleExpr.pattern().isEmpty() || (titleExpr == runFilter_.titleExpression()))
+	{
+		filterRunData();
+		updateDataTable();
+		return;
+	}
+
+	// Test titles of all current runs
+	QVector<int> titleIds, titleMatchCache;
+	titleIds.reserve(runData_.nItems());
+	for (RefListItem<RunData,Journal*>* ri = runData_.first(); ri != NULL; ri = ri->next) titleIds.append(ri->item->titleId());
+	titleSearch_ = startSearch(titleExpr, titleIds, titleMatchCache, "titleSearchFinished");
+	if (titleSearch_.isNull()) applyTitleMatches(titleExpr, titleMatchCache);
+	else ui.statusbar->showMessage("Searching...");
+}
+
+// Background title search has finished
+void JournalViewer::titleSearchFinished(int searchId, QRegExp expr, QVector<int> matches)
+{
+	// Ignore the results of cancelled (superseded) searches
+	if (searchId != titleSearch_.id()) return;
+	titleSearch_ = SearchHandle();
+
+	ui.statusbar->clearMessage();
+	applyTitleMatches(expr, matches);
+}
+
+// Background Find has finished
+void JournalViewer::findSearchFinished(int searchId, QRegExp expr, QVector<int> matches)
+{
+	// Ignore the results of cancelled (superseded) searches
+	if (searchId != findSearch_.id()) return;
+	findSearch_ = SearchHandle();
+
+	emit(findFinished(setFindMatches(expr, matches)));
+}
+
+/*
+ * Run Index
+ */
+
+// Return RunData for specified run of instrument (or NULL if it is not loaded)
+RunData* JournalViewer::findRun(Instrument* inst, int runNumber)
+{
+	// Journals being loaded in the background are not indexed until they have arrived
+	return runIndex_.find(inst->instrument(), runNumber);
+}
+
+// Select specified run of current instrument in the data table, changing journal if necessary
+bool JournalViewer::goToRun(int runNumber)
+{
+	if ((currentInstrument_ == NULL) || refreshing_) return false;
+
+	// Journals which are still loading are not yet indexed
+	if (nPendingJournalLoads_ > 0)
+	{
+		ui.statusbar->showMessage("Journals are still loading - try again when they have finished.", 3000);
+		return false;
+	}
+
+	RunData* rd = findRun(currentInstrument_, runNumber);
+	if (rd == NULL)
+	{
+		ui.statusbar->showMessage("Run " + QString::number(runNumber) + " is not in any loaded journal for instrument " + currentInstrument_->capitalisedName(), 3000);
+		return false;
+	}
+
+	// Switch to the journal containing the run, unless we are displaying it already (either directly or through 'All')
+	Journal* jrnl = rd->journalSource();
+	if ((currentJournal_ != jrnl) && ((currentJournal_ == NULL) || (currentJournal_->name() != "All")))
+	{
+		setJournal(jrnl);
+
+		// Selecting the journal is deferred if a background preload of the instrument is running
+		if (currentJournal_ != jrnl) return false;
+
+		// The journal may have been reloaded, so look the run up again
+		rd = runIndex_.find(currentInstrument_->instrument(), runNumber);
+		if (rd == NULL) return false;
+	}
+
+	// Make sure the run isn't hidden by the current filters
+	if (!rd->visible())
+	{
+		on_actionToolsResetFilters_triggered(false);
+		ui.statusbar->showMessage("Filters reset to show run " + QString::number(runNumber), 3000);
+	}
+
+	// Find and select its row
+	ui.DataTable->clearSelection();
+	int row = dataTableModel_.row(rd);
+	if (row == -1) return false;
+
+	ui.DataTable->selectRow(row);
+	ui.DataTable->scrollTo(dataTableModel_.index(row, 0), QAbstractItemView::PositionAtCenter);
+	return true;
+}
+
+/*
+ * Run Intervals
+ */
+
+// Return runs of all instruments overlapping the (inclusive) time range (seconds since epoch), in order of start time
+QVector<RunData*> JournalViewer::runsOverlapping(qint64 fromTime, qint64 toTime)
+{
+	// Journals being loaded in the background are not indexed until they have arrived
+	return intervalIndex_.overlapping(fromTime, toTime);
+}
+
+// Change to specified instrument and select run in the data table, changing journal if necessary
+bool JournalViewer::goToRun(Instrument* inst, int runNumber)
+{
+	setInstrument(inst);
+	if (currentInstrument_ != inst) return false;
+
+	return goToRun(runNumber);
+}
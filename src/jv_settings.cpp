@@ -51,6 +51,7 @@ void JournalViewer::setDefaultSettings()
 	journalAccessType_ = JournalViewer::NetOnlyAccess;
 	defaultInstrument_ = ISIS::nInstruments;
 	blockDataSource_ = RunData::LogBeforeNexusSource;
+	setBlockDataMemoryBudget(1024);
 	autoReload_ = false;
 	autoReloadFrequency_ = 5;
 	
@@ -91,6 +92,7 @@ void JournalViewer::storeSettings()
 	settings.setValue("AutoReload", autoReload_);
 	settings.setValue("AutoReloadFrequency", autoReloadFrequency_);
 	settings.setValue("BlockDataSource", blockDataSource_);
+	settings.setValue("BlockDataMemoryBudget", blockDataMemoryBudget_);
 	settings.setValue("ForceISOEncoding", forceISOEncoding_);
 
 	// Visible properties
@@ -118,6 +120,9 @@ void JournalViewer::storeSettings()
 		settings.setValue("ReportMargins"+QString::number(n), reportMargins_[n]);
 	}
 
+	// Session State
+	storeSession(settings);
+
 	settings.sync();
 }
 
@@ -147,6 +152,7 @@ void JournalViewer::retrieveSettings()
 	if (settings.contains("AutoReloadFrequency")) setAutoReloadFrequency(settings.value("AutoReloadFrequency").toInt());
 	if (settings.contains("AutoReload")) setAutoReload(settings.value("AutoReload").toBool());
 	if (settings.contains("BlockDataSource")) blockDataSource_ = (RunData::BlockDataSource) settings.value("BlockDataSource").toInt();
+	if (settings.contains("BlockDataMemoryBudget")) setBlockDataMemoryBudget(settings.value("BlockDataMemoryBudget").toInt());
 	if (settings.contains("ForceISOEncoding")) forceISOEncoding_ = settings.value("ForceISOEncoding").toBool();
 
 	// Visible properties
@@ -190,6 +196,47 @@ void JournalViewer::retrieveSettings()
 #endif
 }
 
+// Store current session state (instrument, journal, filters and sort order)
+void JournalViewer::storeSession(QSettings& settings)
+{
+	if (currentInstrument_ == NULL) return;
+
+	settings.setValue("Session/Instrument", currentInstrument_->capitalisedName());
+	settings.setValue("Session/Journal", currentJournal_ ? currentJournal_->name() : QString());
+
+	// Search and filters
+	settings.setValue("Session/SearchText", ui.SearchEdit->text());
+	settings.setValue("Session/SearchStyle", ui.SearchStyleCombo->currentIndex());
+	settings.setValue("Session/SearchCaseSensitive", ui.SearchCaseSensitiveCheck->isChecked());
+	settings.setValue("Session/UserFilter", ui.FilterUserCombo->currentText());
+	settings.setValue("Session/RBFilter", ui.FilterRBCombo->currentText());
+	settings.setValue("Session/DateType", ui.FilterDateTypeCombo->currentIndex());
+
+	// Sort column and order
+	settings.setValue("Session/SortProperty", RunProperty::property(dataTableModel_.sortProperty()));
+	settings.setValue("Session/SortOrder", (int) dataTableModel_.sortOrder());
+}
+
+// Retrieve previous session state, returning the instrument that was displayed
+ISIS::ISISInstrument JournalViewer::retrieveSession(QSettings& settings)
+{
+	startupJournal_ = settings.value("Session/Journal").toString();
+
+	// Search and filters - user / RB filters can only be restored once the journal is loaded and their combos populated
+	ui.SearchEdit->setText(settings.value("Session/SearchText").toString());
+	if (settings.contains("Session/SearchStyle")) ui.SearchStyleCombo->setCurrentIndex(settings.value("Session/SearchStyle").toInt());
+	ui.SearchCaseSensitiveCheck->setChecked(settings.value("Session/SearchCaseSensitive", false).toBool());
+	QRegExp titleExpr = searchExpression(ui.SearchEdit->text(), (JournalViewer::SearchStyle) ui.SearchStyleCombo->currentIndex(), ui.SearchCaseSensitiveCheck->isChecked());
+	if ((!titleExpr.pattern().isEmpty()) && titleExpr.isValid()) runFilter_.setTitleExpression(titleExpr);
+	if (settings.contains("Session/DateType")) ui.FilterDateTypeCombo->setCurrentIndex(settings.value("Session/DateType").toInt());
+
+	// Sort column and order
+	startupSortProperty_ = RunProperty::property(settings.value("Session/SortProperty").toString());
+	startupSortOrder_ = (Qt::SortOrder) settings.value("Session/SortOrder", (int) Qt::AscendingOrder).toInt();
+
+	return settings.contains("Session/Instrument") ? ISIS::instrument(settings.value("Session/Instrument").toString()) : ISIS::nInstruments;
+}
+
 // Return local directory for storing journal copies
 QDir JournalViewer::journalDirectory()
 {
@@ -290,6 +337,19 @@ RunData::BlockDataSource JournalViewer::blockDataSource()
 	return blockDataSource_;
 }
 
+// Set memory budget (MB) for loaded block data (zero for unlimited)
+void JournalViewer::setBlockDataMemoryBudget(int mb)
+{
+	blockDataMemoryBudget_ = (mb < 0 ? 0 : mb);
+	RunData::blockDataCache().setBudget(qint64(blockDataMemoryBudget_) * 1024 * 1024);
+}
+
+// Return memory budget (MB) for loaded block data
+int JournalViewer::blockDataMemoryBudget()
+{
+	return blockDataMemoryBudget_;
+}
+
 // Return header text colour
 QColor JournalViewer::headerTextColour()
 {
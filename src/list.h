@@ -25,6 +25,9 @@
 #include <stdlib.h>
 #include <stdio.h>
 
+// Forward Declarations
+template <class T> class List;
+
 // ListItem Class
 template <class T> class ListItem
 {
@@ -33,6 +36,12 @@ template <class T> class ListItem
 	ListItem<T>();
 	// List pointers
 	T *prev, *next;
+
+	private:
+	// Position of item in its List's item array (valid only while the array is up to date)
+	int listIndex_;
+	// List maintains the index
+	friend class List<T>;
 };
 
 // Constructor
@@ -40,6 +49,7 @@ template <class T> ListItem<T>::ListItem()
 {
 	prev = NULL;
 	next = NULL;
+	listIndex_ = -1;
 }
 
 // List Class
@@ -61,11 +71,18 @@ template <class T> class List
 	T *listHead_, *listTail_;
 	// Number of items in list
 	int nItems_;
-	// Static array of items
-	T **items_;
+	// Static array of items (maintained as items are appended, and regenerated after any other change)
+	mutable T **items_;
+	// Allocated size of item array
+	mutable int itemsSize_;
 	// Array regeneration flag
-	bool regenerate_;
+	mutable bool regenerate_;
 
+	private:
+	// Append new tail item to the item array (if it is up to date)
+	void appendToArray(T* item);
+	// Regenerate item array (if necessary)
+	void regenerateArray() const;
 
 	public:
 	// Returns the number of items in the list
@@ -148,8 +165,9 @@ template <class T> List<T>::List()
 	listHead_ = NULL;
 	listTail_ = NULL;
 	nItems_ = 0;
-	regenerate_ = 1;
+	regenerate_ = 0;
 	items_ = NULL;
+	itemsSize_ = 0;
 }
 
 // Destructor
@@ -191,7 +209,7 @@ template <class T> T* List<T>::add()
 	newitem->prev = listTail_;
 	listTail_ = newitem;
 	nItems_ ++;
-	regenerate_ = 1;
+	appendToArray(newitem);
 	return newitem;
 }
 
@@ -252,7 +270,7 @@ template <class T> void List<T>::own(T* olditem)
 	olditem->next = NULL;
 	listTail_ = olditem;
 	nItems_ ++;
-	regenerate_ = 1;
+	appendToArray(olditem);
 }
 
 // Disown the item, but do not delete it
@@ -301,7 +319,7 @@ template <class T> void List<T>::removeLast()
 	listTail_ = xitem->prev;
 	delete xitem;
 	--nItems_;
-	regenerate_ = 1;
+	// Item array remains valid, since only the last item has gone
 }
 
 // Return whether the item is owned by the list
@@ -377,27 +395,23 @@ template <class T> void List<T>::clear()
 	// Delete static items array if its there
 	if (items_ != NULL) delete[] items_;
 	items_ = NULL;
-	regenerate_ = 1;
+	itemsSize_ = 0;
+	// An empty array is up to date
+	regenerate_ = 0;
 }
 
 // Find index of supplied item
 template <class T> int List<T>::indexOf(T *item) const
 {
-	int result = 0;
-	for (T* i = listHead_; i != NULL; i = i->next)
-	{
-		if (item == i) break;
-		result ++;
-	}
-	if (result == nItems_)
-	{
-		printf("Internal Error: List::indexOf could not find supplied item.\n");
-		result = -1;
-	}
-	return result;
+	// Items know their own position once the item array is up to date
+	regenerateArray();
+	if ((item != NULL) && (item->listIndex_ >= 0) && (item->listIndex_ < nItems_) && (items_[item->listIndex_] == item)) return item->listIndex_;
+
+	printf("Internal Error: List::indexOf could not find supplied item.\n");
+	return -1;
 }
 
-// Return item at given position (slow)
+// Return item at given position
 template <class T> T *List<T>::item(int n) const
 {
 	if ((n < 0) || (n >= nItems_))
@@ -405,9 +419,8 @@ template <class T> T *List<T>::item(int n) const
 		printf("Internal Error: List array index %i is out of bounds in List<T>::item().\n", n);
 		return NULL;
 	}
-	int count = -1;
-	for (T* item = listHead_; item != NULL; item = item->next) if (++count == n) return item;
-	return NULL;
+	regenerateArray();
+	return items_[n];
 }
 
 // Create empty list
@@ -418,21 +431,52 @@ template <class T> void List<T>::createEmpty(int size)
 	regenerate_ = 1;
 }
 
-// Create (or just return) the item array
-template <class T> T **List<T>::array()
+// Append new tail item to the item array (if it is up to date)
+template <class T> void List<T>::appendToArray(T* item)
 {
-	if (regenerate_ == 0) return items_;
-	
-	// Delete old atom list (if there is one)
-	if (items_ != NULL) delete[] items_;
-	
-	// Create new list
-	items_ = new T*[nItems_];
-	
-	// Fill in pointers
+	if (regenerate_) return;
+
+	// Grow array geometrically, so that building a list item by item takes linear time
+	if (nItems_ > itemsSize_)
+	{
+		int newSize = (itemsSize_ < 16 ? 16 : itemsSize_*2);
+		T **newItems = new T*[newSize];
+		for (int n=0; n<nItems_-1; ++n) newItems[n] = items_[n];
+		if (items_ != NULL) delete[] items_;
+		items_ = newItems;
+		itemsSize_ = newSize;
+	}
+	items_[nItems_-1] = item;
+	item->listIndex_ = nItems_-1;
+}
+
+// Regenerate item array (if necessary)
+template <class T> void List<T>::regenerateArray() const
+{
+	if (regenerate_ == 0) return;
+
+	// Reallocate array if it is too small
+	if (nItems_ > itemsSize_)
+	{
+		if (items_ != NULL) delete[] items_;
+		itemsSize_ = nItems_;
+		items_ = new T*[itemsSize_];
+	}
+
+	// Fill in pointers and item positions
 	int count = 0;
-	for (T *i = listHead_; i != NULL; i = i->next) items_[count++] = i;
+	for (T *i = listHead_; i != NULL; i = i->next)
+	{
+		i->listIndex_ = count;
+		items_[count++] = i;
+	}
 	regenerate_ = 0;
+}
+
+// Create (or just return) the item array
+template <class T> T **List<T>::array()
+{
+	regenerateArray();
 	return items_;
 }
 
@@ -94,8 +94,11 @@ int main(int argc, char *argv[])
 					printf("\t-i <inst>\tChange to specified <instrument> ('CRISP', 'MUSR', 'SANS2D', 'SLS', 'TSC' etc.)\n");
 					printf("\t-j <cycle>\tLoad journal for specified cycle ('All', '12/2', '09/1', '13/3' etc.)\n");
 					printf("\t-l\t\tList available journals for current instrument\n");
+					printf("\t-m [file]\tWrite a JSON report of memory used by loaded journals, block data etc. (to stdout if no file is given)\n");
+					printf("\t-n <run>\tDisplay the specified run (or range of runs, e.g. '12345-12400') from the loaded journals\n");
 					printf("\t-r <regexp>\tPerform a regular expression search of the current run data, displaying matching entries\n");
 					printf("\t-s <text>\tPerform a plaintext search of the current run data, displaying matching entries\n");
+					printf("\t-t <time>\tDisplay runs of all instruments in progress at the specified time (e.g. '2016-03-14T09:26:53'), or overlapping a range '<from>,<to>', from the loaded journals\n");
 					printf("\t-w <wildcard>\tPerform a wildcard search of the current run data, displaying matching entries\n");
 					return 1;
 					break;
@@ -115,6 +118,17 @@ int main(int argc, char *argv[])
 					jv.showJournals();
 					return 0;
 					break;
+				case ('m'):
+					if (((n+1) == argc) || (argv[n+1][0] == '-'))
+					{
+						if (!jv.dumpMemoryReport(NULL)) return 1;
+					}
+					else if (!jv.dumpMemoryReport(argv[++n])) return 1;
+					break;
+				case ('n'):
+					if (((n+1) == argc) || (argv[n+1][0] == '-')) missingArg = true;
+					else if (!jv.showRuns(argv[++n])) return 1;
+					break;
 				case ('r'):
 					if (((n+1) == argc) || (argv[n+1][0] == '-')) missingArg = true;
 					else if (!jv.searchRuns(argv[++n], QRegExp::RegExp)) return 1;
@@ -123,6 +137,10 @@ int main(int argc, char *argv[])
 					if (((n+1) == argc) || (argv[n+1][0] == '-')) missingArg = true;
 					else if (!jv.searchRuns(argv[++n], QRegExp::FixedString)) return 1;
 					break;
+				case ('t'):
+					if (((n+1) == argc) || (argv[n+1][0] == '-')) missingArg = true;
+					else if (!jv.showRunsAtTime(argv[++n])) return 1;
+					break;
 				case ('w'):
 					if (((n+1) == argc) || (argv[n+1][0] == '-')) missingArg = true;
 					else if (!jv.searchRuns(argv[++n], QRegExp::WildcardUnix)) return 1;
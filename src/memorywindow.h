@@ -0,0 +1,68 @@
+/*
+	*** Memory Window
+	*** src/memorywindow.h
+	Copyright T. Youngs 2012-2016
+
+	This file is part of JournalViewer.
+
+	JournalViewer is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	JournalViewer is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with JournalViewer.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef JOURNALVIEWER_MEMORYWINDOW_H
+#define JOURNALVIEWER_MEMORYWINDOW_H
+
+#include "ui_memorywindow.h"
+
+// Forward Declarations
+class JournalViewer;
+class QTreeWidgetItem;
+
+class MemoryWindow : public QDialog
+{
+	// All Qt declarations must include this macro
+	Q_OBJECT
+
+
+	/*
+	// Window Functions
+	*/
+	public:
+	// Constructor / Destructor
+	MemoryWindow(JournalViewer& parent);
+	~MemoryWindow();
+	// Main form declaration
+	Ui::MemoryWindow ui;
+	// Parent JournalViewer window
+	JournalViewer& jvParent_;
+
+	private:
+	// Add item to tree, under specified parent (or at top level if NULL)
+	QTreeWidgetItem* addItem(QTreeWidgetItem* parent, QString name, int nRuns, qint64 bytes);
+
+	public:
+	// Refresh window
+	void refresh();
+
+
+	/*
+	// Widget Slots
+	*/
+	private slots:
+	// Refresh button
+	void on_RefreshButton_clicked(bool checked);
+	// Close button
+	void on_CloseButton_clicked(bool checked);
+};
+
+#endif
@@ -0,0 +1,129 @@
+/*
+	*** Memory Window Functions
+	*** src/memorywindow_funcs.cpp
+	Copyright T. Youngs 2012-2016
+
+	This file is part of JournalViewer.
+
+	JournalViewer is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	JournalViewer is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with JournalViewer.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "memorywindow.h"
+#include "jv.h"
+#include <QJsonArray>
+
+// Constructor
+MemoryWindow::MemoryWindow(JournalViewer& parent) : QDialog(&parent), jvParent_(parent)
+{
+	// Call the main creation function
+	ui.setupUi(this);
+	ui.MemoryTree->setHeaderLabels(QStringList() << "Item" << "Runs" << "Memory");
+}
+
+// Destructor
+MemoryWindow::~MemoryWindow()
+{
+}
+
+// Return size in bytes as human-readable text
+static QString bytesAsString(qint64 bytes)
+{
+	if (bytes < 1024) return QString::number(bytes) + " B";
+	else if (bytes < 1024*1024) return QString::number(bytes / 1024.0, 'f', 1) + " kB";
+	else if (bytes < 1024*1024*1024) return QString::number(bytes / (1024.0*1024.0), 'f', 1) + " MB";
+	return QString::number(bytes / (1024.0*1024.0*1024.0), 'f', 2) + " GB";
+}
+
+// Add item to tree, under specified parent (or at top level if NULL)
+QTreeWidgetItem* MemoryWindow::addItem(QTreeWidgetItem* parent, QString name, int nRuns, qint64 bytes)
+{
+	QTreeWidgetItem* item = (parent ? new QTreeWidgetItem(parent) : new QTreeWidgetItem(ui.MemoryTree));
+	item->setText(0, name);
+	if (nRuns >= 0) item->setText(1, QString::number(nRuns));
+	item->setText(2, bytesAsString(bytes));
+	item->setTextAlignment(1, Qt::AlignRight);
+	item->setTextAlignment(2, Qt::AlignRight);
+	return item;
+}
+
+// Refresh window
+void MemoryWindow::refresh()
+{
+	QJsonObject report = jvParent_.memoryReport();
+
+	ui.MemoryTree->clear();
+
+	// Journals, by instrument
+	QJsonArray instruments = report["instruments"].toArray();
+	qint64 journalBytes = 0;
+	int nRuns = 0;
+	for (int n=0; n<instruments.count(); ++n)
+	{
+		journalBytes += (qint64) instruments.at(n).toObject()["bytes"].toDouble();
+		nRuns += instruments.at(n).toObject()["runs"].toInt();
+	}
+	QTreeWidgetItem* journalsItem = addItem(NULL, "Journals", nRuns, journalBytes);
+	for (int n=0; n<instruments.count(); ++n)
+	{
+		QJsonObject instrument = instruments.at(n).toObject();
+		QTreeWidgetItem* instItem = addItem(journalsItem, instrument["name"].toString(), instrument["runs"].toInt(), (qint64) instrument["bytes"].toDouble());
+		QJsonArray journals = instrument["journals"].toArray();
+		for (int m=0; m<journals.count(); ++m)
+		{
+			QJsonObject journal = journals.at(m).toObject();
+			QTreeWidgetItem* journalItem = addItem(instItem, journal["name"].toString(), journal["runs"].toInt(), (qint64) journal["bytes"].toDouble());
+			addItem(journalItem, "Run Catalogue", -1, (qint64) journal["catalogueBytes"].toDouble());
+			if (journal["blockDataBytes"].toDouble() > 0) addItem(journalItem, "Block Data", -1, (qint64) journal["blockDataBytes"].toDouble());
+		}
+	}
+	journalsItem->setExpanded(true);
+
+	// Block data
+	QJsonObject blockData = report["blockData"].toObject();
+	QTreeWidgetItem* blockDataItem = addItem(NULL, "Block Data", blockData["runs"].toInt(), (qint64) blockData["bytes"].toDouble());
+	qint64 budget = (qint64) blockData["budgetBytes"].toDouble();
+	blockDataItem->setToolTip(0, "Budget: " + (budget == 0 ? QString("Unlimited") : bytesAsString(budget)) + ", " + QString::number(blockData["evictions"].toInt()) + " run(s) evicted so far");
+
+	// Other shared data
+	addItem(NULL, "Block Value Enumerations", -1, (qint64) report["enumerations"].toObject()["bytes"].toDouble());
+	addItem(NULL, "Shared Strings (" + QString::number(report["stringPool"].toObject()["strings"].toInt()) + ")", -1, (qint64) report["stringPool"].toObject()["bytes"].toDouble());
+	addItem(NULL, "Run Index", report["runIndex"].toObject()["runs"].toInt(), (qint64) report["runIndex"].toObject()["bytes"].toDouble());
+	addItem(NULL, "Run Time Index", report["intervalIndex"].toObject()["runs"].toInt(), (qint64) report["intervalIndex"].toObject()["bytes"].toDouble());
+	addItem(NULL, "Title Search Index", -1, (qint64) report["titleIndex"].toObject()["bytes"].toDouble());
+	addItem(NULL, "Run Filter", -1, (qint64) report["runFilter"].toObject()["bytes"].toDouble());
+	addItem(NULL, "Facet Index", -1, (qint64) report["facetIndex"].toObject()["bytes"].toDouble());
+	addItem(NULL, "Table Groups (" + QString::number(report["tableGrouping"].toObject()["groups"].toInt()) + ")", -1, (qint64) report["tableGrouping"].toObject()["bytes"].toDouble());
+	addItem(NULL, "Plot Windows (" + QString::number(report["plots"].toObject()["windows"].toInt()) + ")", -1, (qint64) report["plots"].toObject()["bytes"].toDouble());
+	addItem(NULL, "Largest Document", -1, (qint64) report["documents"].toObject()["largestBytes"].toDouble())->setToolTip(0, "Documents only exist while printing or exporting, so are not included in the total");
+
+	for (int n=0; n<3; ++n) ui.MemoryTree->resizeColumnToContents(n);
+
+	ui.TotalLabel->setText("Total: " + bytesAsString((qint64) report["totalBytes"].toDouble()));
+}
+
+/*
+// Widget Slots
+*/
+
+// Refresh button pressed
+void MemoryWindow::on_RefreshButton_clicked(bool checked)
+{
+	refresh();
+}
+
+// Close button pressed
+void MemoryWindow::on_CloseButton_clicked(bool checked)
+{
+	hide();
+}
@@ -62,13 +62,13 @@ void Messenger::print(QString text)
 // Print standard message
 void Messenger::print(const char* fmt, ...)
 {
-	static char text[1024];
+	char text[1024];
 
 	text[0] = '\0';
 
 	va_list arguments;
 	va_start(arguments,fmt);
-	vsprintf(text, fmt, arguments);
+	vsnprintf(text, 1024, fmt, arguments);
 	va_end(arguments);
 
 	if (toStdout_) printf("%s\n", qPrintable(text));
@@ -0,0 +1,155 @@
+/*
+	*** Node Pool
+	*** src/nodepool.h
+	Copyright T. Youngs 2012-2016
+
+	This file is part of JournalViewer.
+
+	JournalViewer is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	JournalViewer is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with JournalViewer.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef JOURNALVIEWER_NODEPOOL_H
+#define JOURNALVIEWER_NODEPOOL_H
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <atomic>
+#include <new>
+
+// Node Pool Class
+// Pool of fixed-size memory blocks, allocated from the system in chunks and recycled through a free list.
+// Chunks are never returned to the system, but blocks are reused by any object of the same size.
+template <size_t SIZE> class NodePool
+{
+	public:
+	// Constructor
+	NodePool<SIZE>();
+
+
+	/*
+	// Blocks
+	*/
+	private:
+	// Free block (overlaying the memory of an unused block)
+	struct FreeBlock
+	{
+		FreeBlock* next;
+	};
+	// Size of each block (large enough to hold a FreeBlock, and a multiple of the pointer size to keep blocks aligned)
+	static const size_t blockSize = (((SIZE < sizeof(FreeBlock)) ? sizeof(FreeBlock) : SIZE) + sizeof(void*) - 1) / sizeof(void*) * sizeof(void*);
+	// Number of blocks per chunk
+	static const int blocksPerChunk = 1024;
+	// Head of free list
+	FreeBlock* freeList_;
+	// Number of chunks allocated
+	int nChunks_;
+	// Lock protecting the pool (lists may be used from journal loader threads)
+	std::atomic_flag lock_;
+
+	private:
+	// Acquire lock
+	void lock();
+	// Release lock
+	void unlock();
+
+	public:
+	// Return new block
+	void* allocate();
+	// Return block to the pool
+	void release(void* block);
+	// Return number of chunks allocated
+	int nChunks() const;
+	// Return pool for blocks of this size
+	static NodePool<SIZE>& instance();
+};
+
+// Constructor
+template <size_t SIZE> NodePool<SIZE>::NodePool()
+{
+	freeList_ = NULL;
+	nChunks_ = 0;
+	lock_.clear();
+}
+
+// Acquire lock
+template <size_t SIZE> void NodePool<SIZE>::lock()
+{
+	while (lock_.test_and_set(std::memory_order_acquire));
+}
+
+// Release lock
+template <size_t SIZE> void NodePool<SIZE>::unlock()
+{
+	lock_.clear(std::memory_order_release);
+}
+
+// Return new block
+template <size_t SIZE> void* NodePool<SIZE>::allocate()
+{
+	lock();
+
+	// Allocate a new chunk if there are no free blocks left, threading its blocks onto the free list
+	if (freeList_ == NULL)
+	{
+		char* chunk = (char*) malloc(blockSize * blocksPerChunk);
+		if (chunk == NULL)
+		{
+			// Fall back to a single block from the system (which throws if there really is no memory left)
+			unlock();
+			printf("Internal Error: Failed to allocate chunk in NodePool<%i>::allocate().\n", (int) SIZE);
+			return ::operator new(blockSize);
+		}
+		for (int n=blocksPerChunk-1; n>=0; --n)
+		{
+			FreeBlock* block = (FreeBlock*) (chunk + n*blockSize);
+			block->next = freeList_;
+			freeList_ = block;
+		}
+		++nChunks_;
+	}
+
+	FreeBlock* block = freeList_;
+	freeList_ = block->next;
+
+	unlock();
+
+	return block;
+}
+
+// Return block to the pool
+template <size_t SIZE> void NodePool<SIZE>::release(void* block)
+{
+	if (block == NULL) return;
+
+	lock();
+	FreeBlock* freeBlock = (FreeBlock*) block;
+	freeBlock->next = freeList_;
+	freeList_ = freeBlock;
+	unlock();
+}
+
+// Return number of chunks allocated
+template <size_t SIZE> int NodePool<SIZE>::nChunks() const
+{
+	return nChunks_;
+}
+
+// Return pool for blocks of this size
+template <size_t SIZE> NodePool<SIZE>& NodePool<SIZE>::instance()
+{
+	static NodePool<SIZE> pool;
+	return pool;
+}
+
+#endif
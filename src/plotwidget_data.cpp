@@ -359,6 +359,15 @@ void PlotData::invalidatePainterPath()
 	lastYScale_ = 0.0;
 }
 
+// Return estimated memory used by data and painter paths (bytes)
+qint64 PlotData::memoryUsage() const
+{
+	qint64 bytes = sizeof(PlotData) - sizeof(Data2D) + data_.memoryUsage();
+	bytes += (linePath_.elementCount() + symbolPath_.elementCount()) * sizeof(QPainterPath::Element);
+	bytes += name_.capacity() * sizeof(QChar);
+	return bytes;
+}
+
 // Return whether this data is visible
 bool PlotData::visible()
 {
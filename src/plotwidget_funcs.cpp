@@ -695,6 +695,14 @@ const List<PlotData>& PlotWidget::dataSets()
 	return dataSets_;
 }
 
+// Return estimated memory used by datasets (bytes)
+qint64 PlotWidget::dataSetMemoryUsage() const
+{
+	qint64 bytes = 0;
+	for (PlotData* pd = dataSets_.first(); pd != NULL; pd = pd->next) bytes += pd->memoryUsage();
+	return bytes;
+}
+
 // Determine dataset limits
 void PlotWidget::determineDataSetLimits()
 {
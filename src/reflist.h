@@ -23,8 +23,11 @@
 #define JOURNALVIEWER_REFLIST_H
 
 #include "list.h"
+#include "nodepool.h"
+#include <assert.h>
 #include <stddef.h>
 #include <stdio.h>
+#include <unordered_map>
 
 // Linked List Reference Item Class
 template <class T, class D> class RefListItem
@@ -39,6 +42,12 @@ template <class T, class D> class RefListItem
 	T* item;
 	// Additional temporary info stored in structure
 	D data;
+
+	public:
+	// Allocate item from the pool shared by all items of the same size
+	static void* operator new(size_t size);
+	// Return item to the pool
+	static void operator delete(void* item);
 };
 
 // Constructor
@@ -49,6 +58,20 @@ template <class T, class D> RefListItem<T,D>::RefListItem()
 	prev = NULL;
 }
 
+// Allocate item from the pool shared by all items of the same size
+template <class T, class D> void* RefListItem<T,D>::operator new(size_t size)
+{
+	// Pool blocks only hold a RefListItem<T,D> - nothing may derive from it and be allocated here
+	assert(size == sizeof(RefListItem<T,D>));
+	return NodePool<sizeof(RefListItem<T,D>)>::instance().allocate();
+}
+
+// Return item to the pool
+template <class T, class D> void RefListItem<T,D>::operator delete(void* item)
+{
+	NodePool<sizeof(RefListItem<T,D>)>::instance().release(item);
+}
+
 // Linked List Reference Class
 template <class T, class D> class RefList
 {
@@ -70,12 +93,28 @@ template <class T, class D> class RefList
 	RefListItem<T,D>* listHead_, *listTail_;
 	// Number of items in list
 	int nItems_;
-	// Static array of items
+	// Static array of items (maintained as items are appended, and regenerated after any other change)
 	RefListItem<T,D>* *items_;
+	// Allocated size of item array
+	int itemsSize_;
 	// Array regeneration flag
 	bool regenerate_;
+	// Optional hash index of referenced items
+	std::unordered_multimap<T*, RefListItem<T,D>*>* index_;
+
+	private:
+	// Append new tail item to the item array (if it is up to date)
+	void appendToArray(RefListItem<T,D>* ri);
+	// Add item to hash index (if there is one)
+	void indexItem(RefListItem<T,D>* ri);
+	// Remove item from hash index (if there is one)
+	void unindexItem(RefListItem<T,D>* ri);
 
 	public:
+	// Set whether a hash index of referenced items is maintained (making contains() and addUnique() constant time)
+	void setIndexed(bool indexed);
+	// Return whether a hash index of referenced items is maintained
+	bool isIndexed() const;
 	// Returns the head of the atom list
 	RefListItem<T,D>* first() const;
 	// Returns the last item in the list
@@ -144,7 +183,9 @@ template <class T, class D> RefList<T,D>::RefList()
 	listHead_ = NULL;
 	listTail_ = NULL;
 	items_ = NULL;
-	regenerate_ = 1;
+	itemsSize_ = 0;
+	regenerate_ = 0;
+	index_ = NULL;
 	nItems_ = 0;
 }
 
@@ -154,7 +195,9 @@ template <class T, class D> RefList<T,D>::RefList(const List<T>& source, D start
 	listHead_ = NULL;
 	listTail_ = NULL;
 	items_ = NULL;
-	regenerate_ = 1;
+	itemsSize_ = 0;
+	regenerate_ = 0;
+	index_ = NULL;
 	nItems_ = 0;
 	createFromList(source.first(), startData);
 }
@@ -163,6 +206,7 @@ template <class T, class D> RefList<T,D>::RefList(const List<T>& source, D start
 template <class T, class D> RefList<T,D>::~RefList()
 {
 	clear();
+	if (index_ != NULL) delete index_;
 }
 
 // Copy Constructur
@@ -171,8 +215,11 @@ template <class T, class D> RefList<T,D>::RefList(const RefList<T,D> &source)
 	listHead_ = NULL;
 	listTail_ = NULL;
 	items_ = NULL;
-	regenerate_ = 1;
+	itemsSize_ = 0;
+	regenerate_ = 0;
+	index_ = NULL;
 	nItems_ = 0;
+	setIndexed(source.isIndexed());
 	for (RefListItem<T,D>* ri = source.first(); ri != NULL; ri = ri->next) add(ri->item, ri->data);
 }
 
@@ -181,6 +228,7 @@ template <class T, class D> void RefList<T,D>::operator=(const RefList<T,D> &sou
 {
 	// Clear any current data...
 	clear();
+	if (source.isIndexed()) setIndexed(true);
 	for (RefListItem<T,D>* ri = source.first(); ri != NULL; ri = ri->next) add(ri->item, ri->data);
 }
 
@@ -212,7 +260,8 @@ template <class T, class D> RefListItem<T,D>* RefList<T,D>::add(T* item)
 	listTail_ = newitem;
 	newitem->item = item;
 	nItems_ ++;
-	regenerate_ = 1;
+	appendToArray(newitem);
+	indexItem(newitem);
 	return newitem;
 }
 
@@ -227,7 +276,8 @@ template <class T, class D> RefListItem<T,D>* RefList<T,D>::add(T* item, D extra
 	newitem->item = item;
 	newitem->data = extradata;
 	nItems_ ++;
-	regenerate_ = 1;
+	appendToArray(newitem);
+	indexItem(newitem);
 	return newitem;
 }
 
@@ -243,6 +293,7 @@ template <class T, class D> RefListItem<T,D>* RefList<T,D>::addStart(T* item)
 	newitem->item = item;
 	nItems_ ++;
 	regenerate_ = 1;
+	indexItem(newitem);
 	return newitem;
 }
 
@@ -261,6 +312,7 @@ template <class T, class D> RefListItem<T,D>* RefList<T,D>::addAfter(RefListItem
 		newitem->item = item;
 		nItems_ ++;
 		regenerate_ = 1;
+		indexItem(newitem);
 		return newitem;
 	}
 }
@@ -280,6 +332,7 @@ template <class T, class D> RefListItem<T,D>* RefList<T,D>::addBefore(RefListIte
 		newitem->item = item;
 		nItems_ ++;
 		regenerate_ = 1;
+		indexItem(newitem);
 		return newitem;
 	}
 }
@@ -296,6 +349,7 @@ template <class T, class D> RefListItem<T,D>* RefList<T,D>::addStart(T* item, D
 	newitem->data = extradata;
 	nItems_ ++;
 	regenerate_ = 1;
+	indexItem(newitem);
 	return newitem;
 }
 
@@ -332,6 +386,7 @@ template <class T, class D> void RefList<T,D>::cut(RefListItem<T,D>* item)
 	else next->prev = prev;
 	item->next = NULL;
 	item->prev = NULL;
+	unindexItem(item);
 	regenerate_ = 1;
 }
 
@@ -349,7 +404,8 @@ template <class T, class D> void RefList<T,D>::own(RefListItem<T,D>* olditem)
 	olditem->next = NULL;
 	listTail_ = olditem;
 	nItems_ ++;
-	regenerate_ = 1;
+	appendToArray(olditem);
+	indexItem(olditem);
 }
 
 // Remove RefListItem from list
@@ -363,6 +419,7 @@ template <class T, class D> void RefList<T,D>::remove(RefListItem<T,D>* xitem)
 	// Delete a specific RefListItem from the list
 	xitem->prev == NULL ? listHead_ = xitem->next : xitem->prev->next = xitem->next;
 	xitem->next == NULL ? listTail_ = xitem->prev : xitem->next->prev = xitem->prev;
+	unindexItem(xitem);
 	delete xitem;
 	nItems_ --;
 	regenerate_ = 1;
@@ -417,13 +474,16 @@ template <class T, class D> RefListItem<T,D>* RefList<T,D>::operator[](int index
 // Item access operator
 template <class T, class D> RefListItem<T,D>* RefList<T,D>::item(int n) const
 {
-#ifdef CHECKS
 	if ((n < 0) || (n >= nItems_))
 	{
+#ifdef CHECKS
 		printf("REFLIST_OPERATOR[] - Array index (%i) out of bounds (%i items in RefList) >>>>\n", n, nItems_);
+#endif
 		return NULL;
 	}
-#endif
+
+	// Use the item array if it is up to date
+	if (!regenerate_) return items_[n];
 	int count = -1;
 	for (RefListItem<T,D>* r = listHead_; r != NULL; r = r->next) if (++count == n) return r;
 	return NULL;
@@ -432,6 +492,13 @@ template <class T, class D> RefListItem<T,D>* RefList<T,D>::item(int n) const
 // Search for item
 template <class T, class D> RefListItem<T,D>* RefList<T,D>::contains(T* xitem) const
 {
+	// Use the hash index if there is one
+	if (index_ != NULL)
+	{
+		typename std::unordered_multimap<T*, RefListItem<T,D>*>::const_iterator it = index_->find(xitem);
+		return (it == index_->end() ? NULL : it->second);
+	}
+
 	// Search references for specified item
 	RefListItem<T,D>* r;
 	for (r = listHead_; r != NULL; r = r->next) if (r->item == xitem) break;
@@ -450,7 +517,8 @@ template <class T, class D> RefListItem<T,D>* RefList<T,D>::containsData(D data)
 // Clear atoms from list
 template <class T, class D> void RefList<T,D>::clear()
 {
-	// Clear the list 
+	// Clear the list (and the hash index, so items need not be individually removed from it)
+	if (index_ != NULL) index_->clear();
 	RefListItem<T,D>* xitem = listHead_;
 	while (xitem != NULL)
 	{
@@ -463,7 +531,9 @@ template <class T, class D> void RefList<T,D>::clear()
 	// Delete static items array if its there
 	if (items_ != NULL) delete[] items_;
 	items_ = NULL;
-	regenerate_ = 1;
+	itemsSize_ = 0;
+	// An empty array is up to date
+	regenerate_ = 0;
 }
 
 // Prune items from list
@@ -545,10 +615,13 @@ template <class T, class D> void RefList<T,D>::swap(T* item1, T* item2)
 template <class T, class D> RefListItem<T,D>* *RefList<T,D>::array()
 {
 	if (regenerate_ == 0) return items_;
-	// Delete old atom list (if there is one)
-	if (items_ != NULL) delete[] items_;
-	// Create new list
-	items_ = new RefListItem<T,D>*[nItems_];
+	// Reallocate array if it is too small
+	if (nItems_ > itemsSize_)
+	{
+		if (items_ != NULL) delete[] items_;
+		itemsSize_ = nItems_;
+		items_ = new RefListItem<T,D>*[itemsSize_];
+	}
 	// Fill in pointers
 	int count = 0;
 	for (RefListItem<T,D>* ri = listHead_; ri != NULL; ri = ri->next) items_[count++] = ri;
@@ -556,4 +629,71 @@ template <class T, class D> RefListItem<T,D>* *RefList<T,D>::array()
 	return items_;
 }
 
+// Append new tail item to the item array (if it is up to date)
+template <class T, class D> void RefList<T,D>::appendToArray(RefListItem<T,D>* ri)
+{
+	if (regenerate_) return;
+
+	// Grow array geometrically, so that building a list item by item takes linear time
+	if (nItems_ > itemsSize_)
+	{
+		int newSize = (itemsSize_ < 16 ? 16 : itemsSize_*2);
+		RefListItem<T,D>* *newItems = new RefListItem<T,D>*[newSize];
+		for (int n=0; n<nItems_-1; ++n) newItems[n] = items_[n];
+		if (items_ != NULL) delete[] items_;
+		items_ = newItems;
+		itemsSize_ = newSize;
+	}
+	items_[nItems_-1] = ri;
+}
+
+/*
+// Hash Index
+*/
+
+// Add item to hash index (if there is one)
+template <class T, class D> void RefList<T,D>::indexItem(RefListItem<T,D>* ri)
+{
+	if (index_ != NULL) index_->insert(std::make_pair(ri->item, ri));
+}
+
+// Remove item from hash index (if there is one)
+template <class T, class D> void RefList<T,D>::unindexItem(RefListItem<T,D>* ri)
+{
+	if (index_ == NULL) return;
+
+	// The same item may be referenced more than once, so find the entry for this particular reference
+	typedef typename std::unordered_multimap<T*, RefListItem<T,D>*>::iterator IndexIterator;
+	std::pair<IndexIterator,IndexIterator> range = index_->equal_range(ri->item);
+	for (IndexIterator it = range.first; it != range.second; ++it) if (it->second == ri)
+	{
+		index_->erase(it);
+		break;
+	}
+}
+
+// Set whether a hash index of referenced items is maintained (making contains() and addUnique() constant time)
+template <class T, class D> void RefList<T,D>::setIndexed(bool indexed)
+{
+	if (indexed == (index_ != NULL)) return;
+
+	if (indexed)
+	{
+		index_ = new std::unordered_multimap<T*, RefListItem<T,D>*>;
+		index_->reserve(nItems_);
+		for (RefListItem<T,D>* ri = listHead_; ri != NULL; ri = ri->next) indexItem(ri);
+	}
+	else
+	{
+		delete index_;
+		index_ = NULL;
+	}
+}
+
+// Return whether a hash index of referenced items is maintained
+template <class T, class D> bool RefList<T,D>::isIndexed() const
+{
+	return (index_ != NULL);
+}
+
 #endif
@@ -27,6 +27,7 @@
 #include "instrument.h"
 #include "rundata.h"
 #include <QDialog>
+#include <QSet>
 #include <QTextDocument>
 
 // Forward Declarations
@@ -66,6 +67,8 @@ class ReportGenerator : public QDialog
 	QList<int> availableRB_;
 	// Reference to master RunData list
 	RefList<RunData,Journal*>& runData_;
+	// Keys of runs whose block data is pinned in the cache until the report's graphs have been created
+	QSet<quint64> pinnedRuns_;
 	// Array of available properties to show
 	bool availableProperties_[RunProperty::nProperties];
 	// List of displayed properties, in order
@@ -74,6 +77,8 @@ class ReportGenerator : public QDialog
 	ReportGenerator::Result result_;
 
 	private:
+	// Release pins on runs used in the report
+	void unpinRuns();
 	// Store settings
 	void storeSettings();
 	// Retrieve settings
@@ -78,6 +78,14 @@ ReportGenerator::ReportGenerator(JournalViewer* parent, const QList<int>& availa
 // Destructor
 ReportGenerator::~ReportGenerator()
 {
+	unpinRuns();
+}
+
+// Release pins on runs used in the report
+void ReportGenerator::unpinRuns()
+{
+	foreach(quint64 key, pinnedRuns_) RunData::blockDataCache().unpin(key);
+	pinnedRuns_.clear();
 }
 
 // Store settings
@@ -235,53 +243,14 @@ void ReportGenerator::retrieveInstrumentInformation()
 		// Loop over block values in selected RunData
 		int runNumber = atoi(qPrintable(ui.RunInformationCombo->currentText()));
 		if (runNumber == 0) return;
-		RunData* rd = NULL;
-		for (RefListItem<RunData,Journal*>* ri = runData_.first(); ri != NULL; ri = ri->next) if (ri->item->runNumber() == runNumber)
-		{
-			rd = ri->item;
-			break;
-		}
+		RunData* rd = parent_->findRun(instrument_, runNumber);
 		if (rd == NULL) return;
 
-		// Do we need to load rundata for this run?
-		if (rd->blockData() == NULL)
+		// Load block data for this run (if it isn't already loaded)
+		if (!rd->loadBlockData(parent_->blockDataSource()))
 		{
-			// Search for the nexus file for this run
-			QString nxsFile;
-#ifndef NOHDF
-			nxsFile = ISIS::locateFile(rd, "nxs", false, QDir());
-#endif
-			if (!nxsFile.isEmpty())
-			{
-				// Load the logfile
-				QByteArray data;
-#ifndef NOHDF
-				if (ISIS::parseNexusFile(rd, nxsFile)) msg.print("Successfully parsed Nexus file " + nxsFile);
-				else
-				{
-					QMessageBox::warning(this, "Couldn't access Nexus file", QString("Error reading Nexus file") + nxsFile);
-					return;
-				}
-#endif
-			}
-			else
-			{
-				msg.print("Nexus file not found for run %i - looking for logfile instead...", rd->runNumber());
-				// Search for the logfile for this run
-				QString logFile = ISIS::locateFile(rd, "log", false, QDir());
-				if (!logFile.isEmpty())
-				{
-					// Load the logfile
-					QByteArray data;
-					if (DataInterface::readFile(logFile, data) && ISIS::parseLogInformation(rd, data)) msg.print("Successfully parsed logfile " + logFile);
-					else
-					{
-						QMessageBox::warning(this, "Couldn't access logfile", QString("Error reading logfile ") + logFile);
-						return;
-					}
-				}
-				else msg.print("Logfile not found for run %i", rd->runNumber());
-			}
+			QMessageBox::warning(this, "Couldn't load run data", QString("Couldn't load block data for run ") + QString::number(runNumber) + ".\nCheck the path to the data directories in Settings.");
+			return;
 		}
 
 		// Loop over block values in runData, creating an entry in the Instrument group/block structure
@@ -423,6 +392,14 @@ bool ReportGenerator::createReport(Document& report)
 			QApplication::processEvents();
 			if (progress.wasCanceled()) break;
 
+			// Pin the run so that its data survives until the graphs are created
+			quint64 key = BlockDataCache::runKey(rd);
+			if (!pinnedRuns_.contains(key))
+			{
+				pinnedRuns_.insert(key);
+				RunData::blockDataCache().pin(key);
+			}
+
 			if (rd->loadBlockData(RunData::LogBeforeNexusSource)) ++nLoaded;
 			
 			++n;
@@ -431,12 +408,17 @@ bool ReportGenerator::createReport(Document& report)
 		progress.setValue(nRuns_);
 
 		// Was the progress dialog cancelled
-		if (n != nRuns_) return false;
+		if (n != nRuns_)
+		{
+			unpinRuns();
+			return false;
+		}
 
 		// Did we load all available data?
 		if (nLoaded != nRuns_)
 		{
 			QMessageBox::StandardButton button = QMessageBox::warning(this, "Error loading data", QString("Error loading logfiles for ") + QString::number(nRuns_-nLoaded) + " of the " + QString::number(nRuns_) + " files needed for this report.\nCheck the data directory locations defined in Settings.");
+			unpinRuns();
 			return false;
 		}
 
@@ -601,6 +583,9 @@ bool ReportGenerator::createReport(Document& report)
 		report.endRow();
 	}
 
+	// The graphs hold their own copies of the block data, so the runs may now be evicted
+	unpinRuns();
+
 	// Reset font here, just in case a graph changed it
 	report.setFont(parent_->documentFont());
 
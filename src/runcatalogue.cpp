@@ -0,0 +1,491 @@
+/*
+	*** Run Catalogue
+	*** src/runcatalogue.cpp
+	Copyright T. Youngs 2012-2016
+
+	This file is part of JournalViewer.
+
+	JournalViewer is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	JournalViewer is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with JournalViewer.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "runcatalogue.h"
+#include "isis.h"
+#include "rundata.h"
+
+// Constructor
+RunCatalogue::RunCatalogue()
+{
+	clear();
+}
+
+/*
+ * Columns
+ */
+
+// Clear all rows
+void RunCatalogue::clear()
+{
+	runNumber_.clear();
+	rbNumber_.clear();
+	duration_.clear();
+	cycle_.clear();
+	startEpoch_.clear();
+	endEpoch_.clear();
+	protonCharge_.clear();
+	totalMEvents_.clear();
+	name_.clear();
+	title_.clear();
+	user_.clear();
+	clearFormatted();
+}
+
+// Reserve space for specified number of rows
+void RunCatalogue::reserve(int nRows)
+{
+	runNumber_.reserve(nRows);
+	rbNumber_.reserve(nRows);
+	duration_.reserve(nRows);
+	cycle_.reserve(nRows);
+	startEpoch_.reserve(nRows);
+	endEpoch_.reserve(nRows);
+	protonCharge_.reserve(nRows);
+	totalMEvents_.reserve(nRows);
+	name_.reserve(nRows);
+	title_.reserve(nRows);
+	user_.reserve(nRows);
+}
+
+// Add new row with default values, returning its index
+int RunCatalogue::addRow()
+{
+	runNumber_.append(-1);
+	rbNumber_.append(-1);
+	duration_.append(-1);
+	cycle_.append(-1);
+	startEpoch_.append(ISIS::invalidTime);
+	endEpoch_.append(ISIS::invalidTime);
+	protonCharge_.append(0.0);
+	totalMEvents_.append(0.0);
+	name_.append(1);
+	title_.append(0);
+	user_.append(0);
+
+	return runNumber_.size()-1;
+}
+
+// Return number of rows
+int RunCatalogue::nRows() const
+{
+	return runNumber_.size();
+}
+
+// Copy row from another catalogue into specified row
+void RunCatalogue::copyRow(int row, const RunCatalogue& source, int sourceRow)
+{
+	runNumber_[row] = source.runNumber_.at(sourceRow);
+	rbNumber_[row] = source.rbNumber_.at(sourceRow);
+	duration_[row] = source.duration_.at(sourceRow);
+	cycle_[row] = source.cycle_.at(sourceRow);
+	startEpoch_[row] = source.startEpoch_.at(sourceRow);
+	endEpoch_[row] = source.endEpoch_.at(sourceRow);
+	protonCharge_[row] = source.protonCharge_.at(sourceRow);
+	totalMEvents_[row] = source.totalMEvents_.at(sourceRow);
+	name_[row] = source.name_.at(sourceRow);
+	title_[row] = source.title_.at(sourceRow);
+	user_[row] = source.user_.at(sourceRow);
+
+	invalidate(row);
+}
+
+// Update row from that in another catalogue, returning whether anything changed
+bool RunCatalogue::updateRow(int row, const RunCatalogue& source, int sourceRow)
+{
+	bool changed = (runNumber_.at(row) != source.runNumber_.at(sourceRow)) || (rbNumber_.at(row) != source.rbNumber_.at(sourceRow));
+	changed = changed || (duration_.at(row) != source.duration_.at(sourceRow)) || (cycle_.at(row) != source.cycle_.at(sourceRow));
+	changed = changed || (startEpoch_.at(row) != source.startEpoch_.at(sourceRow)) || (endEpoch_.at(row) != source.endEpoch_.at(sourceRow));
+	changed = changed || (protonCharge_.at(row) != source.protonCharge_.at(sourceRow)) || (totalMEvents_.at(row) != source.totalMEvents_.at(sourceRow));
+	changed = changed || (name_.at(row) != source.name_.at(sourceRow)) || (title_.at(row) != source.title_.at(sourceRow)) || (user_.at(row) != source.user_.at(sourceRow));
+
+	if (changed) copyRow(row, source, sourceRow);
+
+	return changed;
+}
+
+// Return estimated memory used by the catalogue, excluding the shared string pool (bytes)
+qint64 RunCatalogue::memoryUsage() const
+{
+	qint64 bytes = sizeof(RunCatalogue);
+
+	// Columns
+	bytes += (runNumber_.capacity() + rbNumber_.capacity() + duration_.capacity() + cycle_.capacity()) * sizeof(int);
+	bytes += (startEpoch_.capacity() + endEpoch_.capacity()) * sizeof(qint64);
+	bytes += (protonCharge_.capacity() + totalMEvents_.capacity()) * sizeof(double);
+	bytes += (name_.capacity() + title_.capacity() + user_.capacity()) * sizeof(int);
+
+	// Formatted text
+	for (int n=0; n<nFormattedColumns; ++n)
+	{
+		bytes += formatted_[n].capacity() * sizeof(QString);
+		for (int row=0; row<formatted_[n].size(); ++row) if (!formatted_[n].at(row).isNull()) bytes += sizeof(QArrayData) + (formatted_[n].at(row).capacity()+1) * sizeof(QChar);
+	}
+
+	return bytes;
+}
+
+/*
+ * Row Access
+ */
+
+// Set run number
+void RunCatalogue::setRunNumber(int row, int runNumber)
+{
+	runNumber_[row] = runNumber;
+	invalidate(RunNumberText, row);
+}
+
+// Return run number
+int RunCatalogue::runNumber(int row) const
+{
+	return runNumber_.at(row);
+}
+
+// Set RB number
+void RunCatalogue::setRBNumber(int row, int rbNumber)
+{
+	rbNumber_[row] = rbNumber;
+	invalidate(RBNumberText, row);
+}
+
+// Return RB number
+int RunCatalogue::rbNumber(int row) const
+{
+	return rbNumber_.at(row);
+}
+
+// Set duration (seconds)
+void RunCatalogue::setDuration(int row, int duration)
+{
+	duration_[row] = duration;
+	invalidate(DurationText, row);
+}
+
+// Return duration (seconds)
+int RunCatalogue::duration(int row) const
+{
+	return duration_.at(row);
+}
+
+// Set cycle index
+void RunCatalogue::setCycle(int row, int cycle)
+{
+	cycle_[row] = cycle;
+	invalidate(CycleText, row);
+}
+
+// Return cycle index
+int RunCatalogue::cycle(int row) const
+{
+	return cycle_.at(row);
+}
+
+// Set start time (seconds since epoch)
+void RunCatalogue::setStartEpoch(int row, qint64 seconds)
+{
+	startEpoch_[row] = seconds;
+	invalidate(StartDateText, row);
+	invalidate(StartTimeText, row);
+	invalidate(StartDateTimeText, row);
+}
+
+// Return start time (seconds since epoch)
+qint64 RunCatalogue::startEpoch(int row) const
+{
+	return startEpoch_.at(row);
+}
+
+// Set end time (seconds since epoch)
+void RunCatalogue::setEndEpoch(int row, qint64 seconds)
+{
+	endEpoch_[row] = seconds;
+	invalidate(EndDateText, row);
+	invalidate(EndTimeText, row);
+	invalidate(EndDateTimeText, row);
+}
+
+// Return end time (seconds since epoch)
+qint64 RunCatalogue::endEpoch(int row) const
+{
+	return endEpoch_.at(row);
+}
+
+// Set proton charge
+void RunCatalogue::setProtonCharge(int row, double protonCharge)
+{
+	protonCharge_[row] = protonCharge;
+	invalidate(ProtonChargeText, row);
+}
+
+// Return proton charge
+double RunCatalogue::protonCharge(int row) const
+{
+	return protonCharge_.at(row);
+}
+
+// Set total MEvents
+void RunCatalogue::setTotalMEvents(int row, double totalMEvents)
+{
+	totalMEvents_[row] = totalMEvents;
+	invalidate(TotalMEventsText, row);
+}
+
+// Return total MEvents
+double RunCatalogue::totalMEvents(int row) const
+{
+	return totalMEvents_.at(row);
+}
+
+// Set name
+void RunCatalogue::setName(int row, const QString& name)
+{
+	name_[row] = stringId(name);
+}
+
+// Set name (by string pool id)
+void RunCatalogue::setNameId(int row, int id)
+{
+	name_[row] = id;
+}
+
+// Return name
+QString RunCatalogue::name(int row) const
+{
+	return stringPool().string(name_.at(row));
+}
+
+// Return string pool id of name
+int RunCatalogue::nameId(int row) const
+{
+	return name_.at(row);
+}
+
+// Set title
+void RunCatalogue::setTitle(int row, const QString& title)
+{
+	title_[row] = stringId(title);
+}
+
+// Set title (by string pool id)
+void RunCatalogue::setTitleId(int row, int id)
+{
+	title_[row] = id;
+}
+
+// Return title
+QString RunCatalogue::title(int row) const
+{
+	return stringPool().string(title_.at(row));
+}
+
+// Return string pool id of title
+int RunCatalogue::titleId(int row) const
+{
+	return title_.at(row);
+}
+
+// Set user
+void RunCatalogue::setUser(int row, const QString& user)
+{
+	user_[row] = stringId(user);
+}
+
+// Set user (by string pool id)
+void RunCatalogue::setUserId(int row, int id)
+{
+	user_[row] = id;
+}
+
+// Return user
+QString RunCatalogue::user(int row) const
+{
+	return stringPool().string(user_.at(row));
+}
+
+// Return string pool id of user
+int RunCatalogue::userId(int row) const
+{
+	return user_.at(row);
+}
+
+/*
+ * Column Access (for scanning over all rows)
+ */
+
+// Return run number column
+const int* RunCatalogue::runNumbers() const
+{
+	return runNumber_.constData();
+}
+
+// Return RB number column
+const int* RunCatalogue::rbNumbers() const
+{
+	return rbNumber_.constData();
+}
+
+// Return start time column
+const qint64* RunCatalogue::startEpochs() const
+{
+	return startEpoch_.constData();
+}
+
+// Return end time column
+const qint64* RunCatalogue::endEpochs() const
+{
+	return endEpoch_.constData();
+}
+
+// Return title id column
+const int* RunCatalogue::titleIds() const
+{
+	return title_.constData();
+}
+
+// Return user id column
+const int* RunCatalogue::userIds() const
+{
+	return user_.constData();
+}
+
+// Return cycle index column
+const int* RunCatalogue::cycles() const
+{
+	return cycle_.constData();
+}
+
+// Return proton charge column
+const double* RunCatalogue::protonCharges() const
+{
+	return protonCharge_.constData();
+}
+
+/*
+ * Formatted Text Cache
+ */
+
+// Invalidate formatted text for specified column and row
+void RunCatalogue::invalidate(FormattedColumn column, int row)
+{
+	if (row < formatted_[column].size()) formatted_[column][row] = QString();
+}
+
+// Invalidate all formatted text for specified row
+void RunCatalogue::invalidate(int row)
+{
+	for (int n=0; n<nFormattedColumns; ++n) invalidate((FormattedColumn) n, row);
+}
+
+// Return formatted text for specified column and row, formatting and caching it if necessary (GUI thread only)
+const QString& RunCatalogue::formatted(FormattedColumn column, int row) const
+{
+	// Rows may have been added since the column was last used
+	QVector<QString>& texts = formatted_[column];
+	if (texts.size() < runNumber_.size()) texts.resize(runNumber_.size());
+
+	QString& text = texts[row];
+	if (!text.isNull()) return text;
+
+	switch (column)
+	{
+		case (CycleText):
+			text = ISIS::cycleText(cycle_.at(row));
+			break;
+		case (DurationText):
+			text = RunData::durationAsString(duration_.at(row));
+			break;
+		case (EndDateText):
+			text = ISIS::dateTime(endEpoch_.at(row)).date().toString();
+			break;
+		case (EndTimeText):
+			text = ISIS::dateTime(endEpoch_.at(row)).time().toString();
+			break;
+		case (EndDateTimeText):
+			text = ISIS::dateTime(endEpoch_.at(row)).toString();
+			break;
+		case (ProtonChargeText):
+			text = QString::number(protonCharge_.at(row), 'g', 9);
+			break;
+		case (RBNumberText):
+			text = QString::number(rbNumber_.at(row));
+			break;
+		case (RunNumberText):
+			text = QString::number(runNumber_.at(row));
+			break;
+		case (StartDateText):
+			text = ISIS::dateTime(startEpoch_.at(row)).date().toString();
+			break;
+		case (StartTimeText):
+			text = ISIS::dateTime(startEpoch_.at(row)).time().toString();
+			break;
+		case (StartDateTimeText):
+			text = ISIS::dateTime(startEpoch_.at(row)).toString();
+			break;
+		case (TotalMEventsText):
+			text = QString::number(totalMEvents_.at(row));
+			break;
+		default:
+			printf("Internal Error: Formatted column %i not accounted for in RunCatalogue::formatted().\n", column);
+			break;
+	}
+
+	// Invalid dates format to null strings, so store an empty (non-null) string to mark them as done
+	if (text.isNull()) text = QString("");
+
+	return text;
+}
+
+// Clear all formatted text
+void RunCatalogue::clearFormatted()
+{
+	for (int n=0; n<nFormattedColumns; ++n) formatted_[n].clear();
+}
+
+/*
+ * String Pool
+ */
+
+// Return pool of strings shared by all catalogues
+StringPool& RunCatalogue::stringPool()
+{
+	// Default strings for new rows always have ids 0 (empty) and 1 (default name)
+	static StringPool pool(QStringList() << "" << "Unnamed Run");
+	return pool;
+}
+
+// Return id of specified string, adding it to the pool if necessary
+int RunCatalogue::stringId(const QString& s)
+{
+	return stringPool().id(s);
+}
+
+// Return string with specified id
+QString RunCatalogue::string(int id)
+{
+	return stringPool().string(id);
+}
+
+// Return number of strings in the pool
+int RunCatalogue::nStrings()
+{
+	return stringPool().nStrings();
+}
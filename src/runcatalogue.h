@@ -0,0 +1,185 @@
+/*
+	*** Run Catalogue
+	*** src/runcatalogue.h
+	Copyright T. Youngs 2012-2016
+
+	This file is part of JournalViewer.
+
+	JournalViewer is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	JournalViewer is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with JournalViewer.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef JOURNALVIEWER_RUNCATALOGUE_H
+#define JOURNALVIEWER_RUNCATALOGUE_H
+
+#include <QString>
+#include <QVector>
+#include "stringpool.h"
+
+/*
+ * Column (struct-of-arrays) storage for the properties of a set of runs, with strings held once in a pool shared by all catalogues and referenced by id.
+ * RunData objects are views onto a single row.
+ */
+class RunCatalogue
+{
+	public:
+	// Constructor
+	RunCatalogue();
+
+
+	/*
+	 * Columns
+	 */
+	private:
+	// Run numbers
+	QVector<int> runNumber_;
+	// RB numbers
+	QVector<int> rbNumber_;
+	// Durations (seconds)
+	QVector<int> duration_;
+	// Cycle indices
+	QVector<int> cycle_;
+	// Start times (seconds since epoch)
+	QVector<qint64> startEpoch_;
+	// End times (seconds since epoch)
+	QVector<qint64> endEpoch_;
+	// Proton charges (uAmps)
+	QVector<double> protonCharge_;
+	// Total MEvents
+	QVector<double> totalMEvents_;
+	// String ids of names, titles and users
+	QVector<int> name_, title_, user_;
+
+	public:
+	// Clear all rows
+	void clear();
+	// Reserve space for specified number of rows
+	void reserve(int nRows);
+	// Add new row with default values, returning its index
+	int addRow();
+	// Return number of rows
+	int nRows() const;
+	// Copy row from another catalogue into specified row
+	void copyRow(int row, const RunCatalogue& source, int sourceRow);
+	// Update row from that in another catalogue, returning whether anything changed
+	bool updateRow(int row, const RunCatalogue& source, int sourceRow);
+	// Return estimated memory used by the catalogue (bytes)
+	qint64 memoryUsage() const;
+
+
+	/*
+	 * Row Access
+	 */
+	public:
+	// Set / return run number
+	void setRunNumber(int row, int runNumber);
+	int runNumber(int row) const;
+	// Set / return RB number
+	void setRBNumber(int row, int rbNumber);
+	int rbNumber(int row) const;
+	// Set / return duration (seconds)
+	void setDuration(int row, int duration);
+	int duration(int row) const;
+	// Set / return cycle index
+	void setCycle(int row, int cycle);
+	int cycle(int row) const;
+	// Set / return start time (seconds since epoch)
+	void setStartEpoch(int row, qint64 seconds);
+	qint64 startEpoch(int row) const;
+	// Set / return end time (seconds since epoch)
+	void setEndEpoch(int row, qint64 seconds);
+	qint64 endEpoch(int row) const;
+	// Set / return proton charge
+	void setProtonCharge(int row, double protonCharge);
+	double protonCharge(int row) const;
+	// Set / return total MEvents
+	void setTotalMEvents(int row, double totalMEvents);
+	double totalMEvents(int row) const;
+	// Set / return name (or its string id)
+	void setName(int row, const QString& name);
+	void setNameId(int row, int id);
+	QString name(int row) const;
+	int nameId(int row) const;
+	// Set / return title (or its string id)
+	void setTitle(int row, const QString& title);
+	void setTitleId(int row, int id);
+	QString title(int row) const;
+	int titleId(int row) const;
+	// Set / return user (or its string id)
+	void setUser(int row, const QString& user);
+	void setUserId(int row, int id);
+	QString user(int row) const;
+	int userId(int row) const;
+
+
+	/*
+	 * Column Access (for scanning over all rows)
+	 */
+	public:
+	// Return run number column
+	const int* runNumbers() const;
+	// Return RB number column
+	const int* rbNumbers() const;
+	// Return start time column
+	const qint64* startEpochs() const;
+	// Return end time column
+	const qint64* endEpochs() const;
+	// Return title id column
+	const int* titleIds() const;
+	// Return user id column
+	const int* userIds() const;
+	// Return cycle index column
+	const int* cycles() const;
+	// Return proton charge column
+	const double* protonCharges() const;
+
+
+	/*
+	 * Formatted Text Cache
+	 */
+	public:
+	// Formatted columns
+	enum FormattedColumn { CycleText, DurationText, EndDateText, EndTimeText, EndDateTimeText, ProtonChargeText, RBNumberText, RunNumberText, StartDateText, StartTimeText, StartDateTimeText, TotalMEventsText, nFormattedColumns };
+
+	private:
+	// Formatted text, created on demand (an empty column has not been requested yet, and a null string has not been formatted yet)
+	mutable QVector<QString> formatted_[nFormattedColumns];
+
+	private:
+	// Invalidate formatted text for specified column and row
+	void invalidate(FormattedColumn column, int row);
+	// Invalidate all formatted text for specified row
+	void invalidate(int row);
+
+	public:
+	// Return formatted text for specified column and row, formatting and caching it if necessary (GUI thread only)
+	const QString& formatted(FormattedColumn column, int row) const;
+	// Clear all formatted text
+	void clearFormatted();
+
+
+	/*
+	 * String Pool
+	 */
+	public:
+	// Return pool of strings shared by all catalogues
+	static StringPool& stringPool();
+	// Return id of specified string, adding it to the pool if necessary
+	static int stringId(const QString& s);
+	// Return string with specified id
+	static QString string(int id);
+	// Return number of strings in the pool
+	static int nStrings();
+};
+
+#endif
@@ -132,23 +132,51 @@ RunProperty::Property RunProperty::type()
  */
 
 // Constructor
-RunData::RunData(): ListItem<RunData>()
+RunData::RunData(RunCatalogue* catalogue): ListItem<RunData>()
 {
-	name_ = "Unnamed Run";
 	journalSource_ = NULL;
 	instrument_ = NULL;
-	runNumber_ = -1;
-	rbNumber_ = -1;
-	duration_ = -1;
-	title_ = "";
-	user_ = "";
 	visible_ = true;
 	group_ = -1;
+
+	// If no catalogue was given, create a private one
+	ownCatalogue_ = (catalogue == NULL);
+	catalogue_ = ownCatalogue_ ? new RunCatalogue : catalogue;
+	row_ = catalogue_->addRow();
 }
 
 // Destructor
 RunData::~RunData()
 {
+	blockDataCache().remove(this);
+	if (ownCatalogue_) delete catalogue_;
+}
+
+// Move property values to a new row in the specified catalogue
+void RunData::moveToCatalogue(RunCatalogue* catalogue)
+{
+	if (catalogue == catalogue_) return;
+
+	int newRow = catalogue->addRow();
+	catalogue->copyRow(newRow, *catalogue_, row_);
+
+	// The row in the old catalogue is simply abandoned, unless the catalogue is our own
+	if (ownCatalogue_) delete catalogue_;
+	ownCatalogue_ = false;
+	catalogue_ = catalogue;
+	row_ = newRow;
+}
+
+// Return catalogue containing property values
+RunCatalogue* RunData::catalogue()
+{
+	return catalogue_;
+}
+
+// Return row in catalogue
+int RunData::row()
+{
+	return row_;
 }
 
 // Set instrument
@@ -178,181 +206,219 @@ Journal* RunData::journalSource()
 // Set name
 void RunData::setName(QString name)
 {
-	name_ = name;
+	catalogue_->setName(row_, name);
 }
 
 // Return name
 QString RunData::name()
 {
-	return name_;
+	return catalogue_->name(row_);
 }
 
 // Set run number
 void RunData::setRunNumber(int rno)
 {
-	runNumber_ = rno;
+	catalogue_->setRunNumber(row_, rno);
 }
 
 // Return run number
 int RunData::runNumber()
 {
-	return runNumber_;
+	return catalogue_->runNumber(row_);
 }
 
 // Set title
 void RunData::setTitle(QString title)
 {
-	title_ = title;
+	catalogue_->setTitle(row_, title);
 }
 
 // Return title
 QString RunData::title()
 {
-	return title_;
+	return catalogue_->title(row_);
+}
+
+// Return title string id (equal titles have equal ids)
+int RunData::titleId()
+{
+	return catalogue_->titleId(row_);
 }
 
 // Set RB number
 void RunData::setRBNumber(int rbno)
 {
-	rbNumber_ = rbno;
+	catalogue_->setRBNumber(row_, rbno);
 }
 
 // Return RB number
 int RunData::rbNumber()
 {
-	return rbNumber_;
+	return catalogue_->rbNumber(row_);
 }
 
 // Set user
 void RunData::setUser(QString user)
 {
-	user_ = user;
+	catalogue_->setUser(row_, user);
 }
 
 // Return user
 QString RunData::user()
 {
-	return user_;
+	return catalogue_->user(row_);
+}
+
+// Return user string id (equal users have equal ids)
+int RunData::userId()
+{
+	return catalogue_->userId(row_);
 }
 
 // Set proton charge
 void RunData::setProtonCharge(double pc)
 {
-	protonCharge_ = pc;
+	catalogue_->setProtonCharge(row_, pc);
 }
 
 // Return proton charge
 double RunData::protonCharge()
 {
-	return protonCharge_;
+	return catalogue_->protonCharge(row_);
 }
 
 // Set duration (seconds)
 void RunData::setDuration(int duration)
 {
-	duration_ = duration;
-	durationString_ = "";
-	int hours = duration_/3600;
-	int minutes = (duration_-hours*3600)/60;
-	int seconds = duration_ - hours*3600 - minutes*60;
-	int days = hours / 24;
-	hours -= days*24;
-	if (days > 0) durationString_.sprintf("%id %ih %im %is", days, hours, minutes, seconds);
-	else if (hours > 0) durationString_.sprintf("%ih %im %is", hours, minutes, seconds);
-	else if (minutes > 0) durationString_.sprintf("%im %is", minutes, seconds);
-	else durationString_.sprintf("%is", seconds);
+	catalogue_->setDuration(row_, duration);
 }
 
 // Return duration (seconds)
 int RunData::duration()
 {
-	return duration_;
+	return catalogue_->duration(row_);
 }
 
 // Set start time and date
 void RunData::setStartDateTime(QString s)
 {
 	// Take NXentry style date string
-	startDateTime_ = QDateTime::fromString(s, "yyyy-MM-ddTHH:mm:ss");
+	catalogue_->setStartEpoch(row_, ISIS::epochSeconds(s));
+}
+
+// Set start time and date
+void RunData::setStartDateTime(QDateTime dateTime)
+{
+	catalogue_->setStartEpoch(row_, ISIS::epochSeconds(dateTime));
+}
+
+// Set start time and date (seconds since epoch)
+void RunData::setStartEpoch(qint64 seconds)
+{
+	catalogue_->setStartEpoch(row_, seconds);
+}
+
+// Return start time and date (seconds since epoch)
+qint64 RunData::startEpoch()
+{
+	return catalogue_->startEpoch(row_);
 }
 
 // Return start time and date string
 QString RunData::startDateTimeString()
 {
-	return startDateTime_.toString();
+	return catalogue_->formatted(RunCatalogue::StartDateTimeText, row_);
 }
 
 // Return start time and date string
 QDateTime RunData::startDateTime()
 {
-	return startDateTime_;
+	return ISIS::dateTime(catalogue_->startEpoch(row_));
 }
 
 // Return start time
 QTime RunData::startTime()
 {
-	return startDateTime_.time();
+	return startDateTime().time();
 }
 
 // Return start date
 QDate RunData::startDate()
 {
-	return startDateTime_.date();
+	return startDateTime().date();
 }
 
 // Set end time and date
 void RunData::setEndDateTime(QString s)
 {
 	// Take NXentry style date string
-	endDateTime_ = QDateTime::fromString(s, "yyyy-MM-ddTHH:mm:ss");
+	catalogue_->setEndEpoch(row_, ISIS::epochSeconds(s));
+}
+
+// Set end time and date
+void RunData::setEndDateTime(QDateTime dateTime)
+{
+	catalogue_->setEndEpoch(row_, ISIS::epochSeconds(dateTime));
+}
+
+// Set end time and date (seconds since epoch)
+void RunData::setEndEpoch(qint64 seconds)
+{
+	catalogue_->setEndEpoch(row_, seconds);
+}
+
+// Return end time and date (seconds since epoch)
+qint64 RunData::endEpoch()
+{
+	return catalogue_->endEpoch(row_);
 }
 
 // Return end time and date string
 QString RunData::endDateTimeString()
 {
-	return endDateTime_.toString();
+	return catalogue_->formatted(RunCatalogue::EndDateTimeText, row_);
 }
 
 // Return end time and date string
 QDateTime RunData::endDateTime()
 {
-	return endDateTime_;
+	return ISIS::dateTime(catalogue_->endEpoch(row_));
 }
 
 // Return end time
 QTime RunData::endTime()
 {
-	return endDateTime_.time();
+	return endDateTime().time();
 }
 
 // Return end date
 QDate RunData::endDate()
 {
-	return endDateTime_.date();
+	return endDateTime().date();
 }
 
 // Set cycle
 void RunData::setCycle(int index)
 {
-	cycle_ = index;
+	catalogue_->setCycle(row_, index);
 }
 
 // Return cycle
 int RunData::cycle()
 {
-	return cycle_;
+	return catalogue_->cycle(row_);
 }
 
 // Set total mevents
 void RunData::setTotalMEvents(double tmev)
 {
-	totalMEvents_ = tmev;
+	catalogue_->setTotalMEvents(row_, tmev);
 }
 
 // Return total mevents
 double RunData::totalMEvents()
 {
-	return totalMEvents_;
+	return catalogue_->totalMEvents(row_);
 }
 
 // Set internal Group number
@@ -367,72 +433,94 @@ int RunData::group()
 	return group_;
 }
 
+// Update properties from those of the supplied RunData, returning whether any changed
+bool RunData::updateFrom(const RunData& source)
+{
+	bool changed = catalogue_->updateRow(row_, *source.catalogue_, source.row_);
+	if (instrument_ != source.instrument_)
+	{
+		instrument_ = source.instrument_;
+		changed = true;
+	}
+
+	return changed;
+}
+
 // Return duration as formatted string
 QString RunData::durationAsString()
 {
-	return durationString_;
+	return catalogue_->formatted(RunCatalogue::DurationText, row_);
 }
 
 // Return specified duration as a formatted string
 QString RunData::durationAsString(int nSeconds)
 {
-	RunData temp;
-	temp.setDuration(nSeconds);
-	return temp.durationAsString();
+	QString result;
+	int hours = nSeconds/3600;
+	int minutes = (nSeconds-hours*3600)/60;
+	int seconds = nSeconds - hours*3600 - minutes*60;
+	int days = hours / 24;
+	hours -= days*24;
+	if (days > 0) result.sprintf("%id %ih %im %is", days, hours, minutes, seconds);
+	else if (hours > 0) result.sprintf("%ih %im %is", hours, minutes, seconds);
+	else if (minutes > 0) result.sprintf("%im %is", minutes, seconds);
+	else result.sprintf("%is", seconds);
+	return result;
 }
 
 // Return specified property as a string
 QString RunData::propertyAsString(RunProperty::Property prop)
 {
+	// Formatted values are cached in the catalogue, so only need to be created once
 	switch (prop)
 	{
 		case (RunProperty::Cycle):
-			return ISIS::cycleText(cycle_);
+			return catalogue_->formatted(RunCatalogue::CycleText, row_);
 			break;
 		case (RunProperty::Duration):
-			return durationString_;
+			return catalogue_->formatted(RunCatalogue::DurationText, row_);
 			break;
 		case (RunProperty::EndDate):
-			return endDateTime_.date().toString();
+			return catalogue_->formatted(RunCatalogue::EndDateText, row_);
 			break;
 		case (RunProperty::EndTime):
-			return endDateTime_.time().toString();
+			return catalogue_->formatted(RunCatalogue::EndTimeText, row_);
 			break;
 		case (RunProperty::EndTimeAndDate):
-			return endDateTime_.toString();
+			return catalogue_->formatted(RunCatalogue::EndDateTimeText, row_);
 			break;
 		case (RunProperty::RBNumber):
-			return QString::number(rbNumber_);
+			return catalogue_->formatted(RunCatalogue::RBNumberText, row_);
 			break;
 		case (RunProperty::RunNumber):
-			return QString::number(runNumber_);
+			return catalogue_->formatted(RunCatalogue::RunNumberText, row_);
 			break;
 		case (RunProperty::GroupNumber):
 			return QString::number(group_);
 			break;
 		case (RunProperty::Name):
-			return name_;
+			return name();
 			break;
 		case (RunProperty::ProtonCharge):
-			return QString::number(protonCharge_, 'g', 9);
+			return catalogue_->formatted(RunCatalogue::ProtonChargeText, row_);
 			break;
 		case (RunProperty::StartDate):
-			return startDateTime_.date().toString();
+			return catalogue_->formatted(RunCatalogue::StartDateText, row_);
 			break;
 		case (RunProperty::StartTime):
-			return startDateTime_.time().toString();
+			return catalogue_->formatted(RunCatalogue::StartTimeText, row_);
 			break;
 		case (RunProperty::StartTimeAndDate):
-			return startDateTime_.toString();
+			return catalogue_->formatted(RunCatalogue::StartDateTimeText, row_);
 			break;
 		case (RunProperty::Title):
-			return title_;
+			return title();
 			break;
 		case (RunProperty::TotalMEvents):
-			return QString::number(totalMEvents_);
+			return catalogue_->formatted(RunCatalogue::TotalMEventsText, row_);
 			break;
 		case (RunProperty::User):
-			return user_;
+			return user();
 			break;
 		default:
 			printf("Error - case %i (%s) not accounted for in propertyAsString.\n", prop, qPrintable(RunProperty::property(prop)));
@@ -477,19 +565,47 @@ EnumeratedValue* RunData::enumeratedBlockValue(QString block, QString value)
 	return en->value(value);
 }
 
+// Return estimated memory used by all block value enumerations (bytes)
+qint64 RunData::enumerationMemoryUsage()
+{
+	qint64 bytes = 0;
+	for (Enumeration* en = blockEnumerations_.first(); en != NULL; en = en->next) bytes += en->memoryUsage();
+	return bytes;
+}
+
 /*
  * Nexus/Logfile Block Information
  */
 
-// Load block data for this run
+// Return cache tracking loaded block data for all runs
+BlockDataCache& RunData::blockDataCache()
+{
+	static BlockDataCache cache;
+	return cache;
+}
+
+// Load block data for this run (unless already loaded)
 bool RunData::loadBlockData(RunData::BlockDataSource source, bool forceReload)
 {
-	// Has the RunData already had its data loaded?
-	if ((!forceReload) && (blockData_.nItems() != 0)) return true;
+	// Has the RunData already had its data loaded? If so, just mark it as recently used
+	if ((!forceReload) && (blockData_.nItems() != 0))
+	{
+		blockDataCache().touch(this);
+		return true;
+	}
 
 	// Clear old data (if it exists)
 	clearBlockData();
 
+	// Read new data, and register it with the cache (which may evict other runs to make room)
+	if (!readBlockData(source)) return false;
+	blockDataCache().touch(this);
+	return true;
+}
+
+// Read block data for this run from the preferred source(s)
+bool RunData::readBlockData(RunData::BlockDataSource source)
+{
 	int sourceOrder[2];
 	if (source == RunData::LogBeforeNexusSource)
 	{
@@ -518,7 +634,7 @@ bool RunData::loadBlockData(RunData::BlockDataSource source, bool forceReload)
 
 		if (sourceOrder[n] == RunData::LogOnlySource)
 		{
-			msg.print("Looking for log file for run %i...", runNumber_);
+			msg.print("Looking for log file for run %i...", runNumber());
 
 			// Search for the logfile for this run
 			QString logFile = ISIS::locateFile(this, "log", journalSource_->local(), journalSource_->localDirectory());
@@ -537,24 +653,24 @@ bool RunData::loadBlockData(RunData::BlockDataSource source, bool forceReload)
 					return false;
 				}
 			}
-			else msg.print("Logfile not found for run %i", runNumber_);
+			else msg.print("Logfile not found for run %i", runNumber());
 		}
 		else if (sourceOrder[n] == RunData::NexusOnlySource)
 		{
 #ifdef NOHDF
 			if (source == RunData::NexusOnlySource)
 			{
-				msg.print("Warning: Nexus file specifically requested in RunData::loadBlockData(), but no HDF file support has been built in (run number %i).", runNumber_);
+				msg.print("Warning: Nexus file specifically requested in RunData::loadBlockData(), but no HDF file support has been built in (run number %i).", runNumber());
 				return false;
 			}
-			return false;
+			continue;
 #else
 			// If it is a muon instrument, search for nxs_v2 (which is the HDF5 version) rather than nxs (which is HDF4)
 			QString nxsFile;
 			if (instrument_ && (instrument_->location() == ISIS::Muon)) nxsFile = ISIS::locateFile(this, "nxs_v2", journalSource_->local(), journalSource_->localDirectory());
 			else nxsFile = ISIS::locateFile(this, "nxs", journalSource_->local(), journalSource_->localDirectory());
 
-			if (nxsFile.isEmpty()) msg.print("Nexus file not found for run %i", runNumber_);
+			if (nxsFile.isEmpty()) msg.print("Nexus file not found for run %i", runNumber());
 			else if (ISIS::parseNexusFile(this, nxsFile))
 			{
 				msg.print("Successfully parsed Nexus file " + nxsFile);
@@ -573,14 +689,14 @@ bool RunData::loadBlockData(RunData::BlockDataSource source, bool forceReload)
 }
 
 // Add Block Data
-Data2D* RunData::addBlockData(QString blockName, QString groupName, QDateTime timeOrigin, QDateTime timeEnd)
+Data2D* RunData::addBlockData(QString blockName, QString groupName, qint64 timeOrigin, qint64 timeEnd)
 {
 	// Search for existing data with this blockName
 	for (Data2D* bd = blockData_.first(); bd != NULL; bd = bd->next)
 	{
 		if (bd->name() == blockName)
 		{
-			msg.print("Warning - Tried to add block data '%s' to run number %i but it already exists.\n", qPrintable(blockName), runNumber_);
+			msg.print("Warning - Tried to add block data '%s' to run number %i but it already exists.\n", qPrintable(blockName), runNumber());
 			return bd;
 		}
 	}
@@ -592,7 +708,7 @@ Data2D* RunData::addBlockData(QString blockName, QString groupName, QDateTime ti
 }
 
 // Add block data value
-void RunData::addBlockDataValue(QString blockName, QDateTime dateTime, double value, QString groupName)
+void RunData::addBlockDataValue(QString blockName, qint64 epochSeconds, double value, QString groupName)
 {
 	// Search for existing block with this name....
 	Data2D* data;
@@ -602,15 +718,15 @@ void RunData::addBlockDataValue(QString blockName, QDateTime dateTime, double va
 	{
 		data = blockData_.add();
 		data->setName(blockName);
-		data->setRunTimeSpan(startDateTime_, endDateTime_);
+		data->setRunTimeSpan(startEpoch(), endEpoch());
 		data->setGroupName(groupName);
 	}
 
-	data->addRelativePoint(dateTime, value);
+	data->addRelativePoint(epochSeconds, value);
 }
 
 // Add block data value (enumerated string)
-void RunData::addBlockDataValue(QString blockName, QDateTime dateTime, QString value, QString groupName)
+void RunData::addBlockDataValue(QString blockName, qint64 epochSeconds, QString value, QString groupName)
 {
 	// Search for existing block with this name....
 	Data2D* data;
@@ -620,14 +736,14 @@ void RunData::addBlockDataValue(QString blockName, QDateTime dateTime, QString v
 	{
 		data = blockData_.add();
 		data->setName(blockName);
-		data->setRunTimeSpan(startDateTime_, endDateTime_);
+		data->setRunTimeSpan(startEpoch(), endEpoch());
 		data->setGroupName(groupName);
 	}
 	
 	// Find/create enumerated value
 	EnumeratedValue* ev = enumeratedBlockValue(blockName, value);
 
-	data->addRelativePoint(dateTime, ev);
+	data->addRelativePoint(epochSeconds, ev);
 }
 
 // Return list of blockData_
@@ -679,9 +795,25 @@ SingleValue* RunData::singleValues()
 	return singleValues_.first();
 }
 
-// Clear all block data
-void RunData::clearBlockData()
+// Discard block data without notifying the cache (called by the cache on eviction)
+void RunData::discardBlockData()
 {
 	blockData_.clear();
 	singleValues_.clear();
 }
+
+// Clear all block data
+void RunData::clearBlockData()
+{
+	blockDataCache().release(this);
+	discardBlockData();
+}
+
+// Return estimated memory used by block data and single values (bytes)
+qint64 RunData::blockDataMemoryUsage() const
+{
+	qint64 bytes = 0;
+	for (Data2D* bd = blockData_.first(); bd != NULL; bd = bd->next) bytes += bd->memoryUsage();
+	for (SingleValue* sv = singleValues_.first(); sv != NULL; sv = sv->next) bytes += sizeof(SingleValue) + (sv->groupName().capacity() + sv->blockName().capacity() + sv->value().capacity()) * sizeof(QChar);
+	return bytes;
+}
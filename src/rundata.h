@@ -29,6 +29,8 @@
 // #include "instrument.h"
 #include "enumeration.h"
 #include "isis.h"
+#include "runcatalogue.h"
+#include "blockdatacache.h"
 
 // Forward Declarations
 class Journal;
@@ -93,12 +95,12 @@ class RunProperty : public ListItem<RunProperty>
 	Property type();
 };
 
-// RunData Storage
+// RunData Storage (view onto a row of a RunCatalogue)
 class RunData : public ListItem<RunData>
 {
 	public:
 	// Constructor / Destructor
-	RunData();
+	RunData(RunCatalogue* catalogue = NULL);
 	~RunData();
 
 
@@ -110,34 +112,22 @@ class RunData : public ListItem<RunData>
 	Instrument* instrument_;
 	// Journal source
 	Journal* journalSource_;
-	// Name
-	QString name_;
-	// Run run number
-	int runNumber_;
-	// Title
-	QString title_;
-	// RB number
-	int rbNumber_;
-	// User
-	QString user_;
-	// Proton Charge (uAmps)
-	double protonCharge_;
-	// Duration (seconds)
-	int duration_;
-	// Duration string (h/m/s)
-	QString durationString_;
-	// Start time / date
-	QDateTime startDateTime_;
-	// End time / date
-	QDateTime endDateTime_;
-	// Cycle index
-	int cycle_;
-	// Total MEvents received
-	double totalMEvents_;
+	// Catalogue containing property values
+	RunCatalogue* catalogue_;
+	// Whether the catalogue is private to this RunData
+	bool ownCatalogue_;
+	// Row in catalogue
+	int row_;
 	// Internal Group number
 	int group_;
 
 	public:
+	// Move property values to a new row in the specified catalogue
+	void moveToCatalogue(RunCatalogue* catalogue);
+	// Return catalogue containing property values
+	RunCatalogue* catalogue();
+	// Return row in catalogue
+	int row();
 	// Set instrument
 	void setInstrument(Instrument* inst);
 	// Return instrument
@@ -158,6 +148,8 @@ class RunData : public ListItem<RunData>
 	void setTitle(QString title);
 	// Return title
 	QString title();
+	// Return title string id (equal titles have equal ids)
+	int titleId();
 	// RB number
 	void setRBNumber(int rbno);
 	// Return RB number
@@ -166,6 +158,8 @@ class RunData : public ListItem<RunData>
 	void setUser(QString user);
 	// Return user
 	QString user();
+	// Return user string id (equal users have equal ids)
+	int userId();
 	// Set proton charge
 	void setProtonCharge(double pc);
 	// Return proton charge
@@ -180,6 +174,12 @@ class RunData : public ListItem<RunData>
 	static QString durationAsString(int nSeconds);
 	// Set start time and date
 	void setStartDateTime(QString s);
+	// Set start time and date
+	void setStartDateTime(QDateTime dateTime);
+	// Set start time and date (seconds since epoch)
+	void setStartEpoch(qint64 seconds);
+	// Return start time and date (seconds since epoch)
+	qint64 startEpoch();
 	// Return start time and date string
 	QString startDateTimeString();
 	// Return start time and date
@@ -190,6 +190,12 @@ class RunData : public ListItem<RunData>
 	QDate startDate();
 	// Set end time and date
 	void setEndDateTime(QString s);
+	// Set end time and date
+	void setEndDateTime(QDateTime dateTime);
+	// Set end time and date (seconds since epoch)
+	void setEndEpoch(qint64 seconds);
+	// Return end time and date (seconds since epoch)
+	qint64 endEpoch();
 	// Return end time and date string
 	QString endDateTimeString();
 	// Return end time and date
@@ -212,6 +218,8 @@ class RunData : public ListItem<RunData>
 	void setGroup(int group);
 	// Return internal Group number
 	int group();
+	// Update properties from those of the supplied RunData, returning whether any changed
+	bool updateFrom(const RunData& source);
 
 
 	/*
@@ -238,6 +246,8 @@ class RunData : public ListItem<RunData>
 	public:
 	// Add/retrieve enumeration from list
 	static EnumeratedValue* enumeratedBlockValue(QString block, QString value);
+	// Return estimated memory used by all block value enumerations (bytes)
+	static qint64 enumerationMemoryUsage();
 
 
 	/*
@@ -253,15 +263,25 @@ class RunData : public ListItem<RunData>
 	// List of extracted single-values from logfile
 	List<SingleValue> singleValues_;
 
+	private:
+	// Read block data for this run from the preferred source(s)
+	bool readBlockData(RunData::BlockDataSource source);
+	// Discard block data without notifying the cache (called by the cache on eviction)
+	void discardBlockData();
+	// BlockDataCache evicts data through discardBlockData()
+	friend class BlockDataCache;
+
 	public:
-	// Load block data for this run
+	// Return cache tracking loaded block data for all runs
+	static BlockDataCache& blockDataCache();
+	// Load block data for this run (unless already loaded)
 	bool loadBlockData(RunData::BlockDataSource source, bool forceReload = false);
 	// Add Block Data
-	Data2D* addBlockData(QString blockName, QString groupName, QDateTime timeOrigin, QDateTime timeEnd);
+	Data2D* addBlockData(QString blockName, QString groupName, qint64 timeOrigin, qint64 timeEnd);
 	// Add block data value
-	void addBlockDataValue(QString blockName, QDateTime dateTime, double value, QString groupName = "No Group");
+	void addBlockDataValue(QString blockName, qint64 epochSeconds, double value, QString groupName = "No Group");
 	// Add block data value (enumerated text value
-	void addBlockDataValue(QString blockName, QDateTime dateTime, QString value, QString groupName = "No Group");
+	void addBlockDataValue(QString blockName, qint64 epochSeconds, QString value, QString groupName = "No Group");
 	// Return list of blockData_
 	Data2D* blockData();
 	// Return reference to nth blockData
@@ -276,6 +296,8 @@ class RunData : public ListItem<RunData>
 	SingleValue* singleValues();
 	// Clear all block data
 	void clearBlockData();
+	// Return estimated memory used by block data and single values (bytes)
+	qint64 blockDataMemoryUsage() const;
 };
 
 #endif
@@ -23,6 +23,8 @@
 #define JOURNALVIEWER_RUNDATAWINDOW_H
 
 #include "ui_rundatawindow.h"
+#include "reflist.h"
+#include <QSet>
 
 // Forward Declarations
 class RunData;
@@ -46,6 +48,8 @@ class RunDataWindow : public QDialog
 	private:
 	// Whether window is currently refreshing
 	bool refreshing_;
+	// Keys of runs whose block data is pinned in the cache while the window is open
+	QSet<quint64> pinnedRuns_;
 
 	private:
 	// Update analysis tree
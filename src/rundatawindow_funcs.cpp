@@ -33,6 +33,7 @@ RunDataWindow::RunDataWindow(QWidget* parent, QFont& font) : QDialog(parent)
 {
 	// Call the main creation function
 	ui.setupUi(this);
+	setAttribute(Qt::WA_DeleteOnClose);
 	ui.PlotArea->setCoordinatesLabel(ui.CoordinatesLabel);
 	ui.PlotArea->setFont(font);
 	ui.AbsoluteTimeCheck->setChecked(ui.PlotArea->absoluteTime());
@@ -49,6 +50,8 @@ RunDataWindow::RunDataWindow(QWidget* parent, QFont& font) : QDialog(parent)
 // Destructor
 RunDataWindow::~RunDataWindow()
 {
+	// Release pins on displayed runs so that their block data may be evicted
+	foreach(quint64 key, pinnedRuns_) RunData::blockDataCache().unpin(key);
 }
 
 // Update analysis tab
@@ -189,6 +192,14 @@ void RunDataWindow::addRunData(RunData* rd)
 
 	QString name = QString::number(rd->runNumber());
 
+	// Pin block data for as long as the window is open
+	quint64 key = BlockDataCache::runKey(rd);
+	if (!pinnedRuns_.contains(key))
+	{
+		pinnedRuns_.insert(key);
+		RunData::blockDataCache().pin(key);
+	}
+
 	// Add item to RunList
 	QListWidgetItem* item = new QListWidgetItem(name);
 	item->setFlags(Qt::ItemIsEnabled | Qt::ItemIsUserCheckable);
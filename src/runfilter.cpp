@@ -0,0 +1,360 @@
+/*
+	*** Run Filter
+	*** src/runfilter.cpp
+	Copyright T. Youngs 2012-2016
+
+	This file is part of JournalViewer.
+
+	JournalViewer is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	JournalViewer is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with JournalViewer.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "runfilter.h"
+#include "journal.h"
+#include "instrument.h"
+#include "runcatalogue.h"
+#include "stringmatcher.h"
+#include <algorithm>
+
+// Fill order with rows sorted in ascending order of the supplied column values
+template <class T> static void sortColumn(const T* values, int nRows, QVector<int>& order)
+{
+	order.resize(nRows);
+	for (int n=0; n<nRows; ++n) order[n] = n;
+
+	// Columns are usually (almost) in order already
+	if (std::is_sorted(values, values+nRows)) return;
+	std::stable_sort(order.begin(), order.end(), [values](int a, int b) { return values[a] < values[b]; });
+}
+
+// Return position in order of the first row whose value is not less than that specified
+template <class T> static int lowerBound(const T* values, const QVector<int>& order, T value)
+{
+	return std::lower_bound(order.constBegin(), order.constEnd(), value, [values](int row, T v) { return values[row] < v; }) - order.constBegin();
+}
+
+// Return position in order of the first row whose value is greater than that specified
+template <class T> static int upperBound(const T* values, const QVector<int>& order, T value)
+{
+	return std::upper_bound(order.constBegin(), order.constEnd(), value, [values](T v, int row) { return v < values[row]; }) - order.constBegin();
+}
+
+// Constructor
+RunFilter::RunFilter()
+{
+	fromTime_ = 0;
+	toTime_ = 0;
+	dateOnRunning_ = true;
+	fromRunNumber_ = 0;
+	toRunNumber_ = 0;
+	for (int n=0; n<nCriteria; ++n)
+	{
+		generation_[n] = 0;
+		resetGeneration_[n] = 0;
+	}
+}
+
+/*
+ * Criteria
+ */
+
+// Register change to specified criterion
+void RunFilter::changed(RunFilter::Criterion criterion, bool narrowed)
+{
+	++generation_[criterion];
+	if (!narrowed) resetGeneration_[criterion] = generation_[criterion];
+}
+
+// Return whether criterion is active (i.e. may exclude runs)
+bool RunFilter::isActive(RunFilter::Criterion criterion) const
+{
+	switch (criterion)
+	{
+		case (RunFilter::TitleCriterion):
+			return !titleExpr_.pattern().isEmpty();
+		case (RunFilter::UserCriterion):
+			return !user_.isEmpty();
+		case (RunFilter::RBCriterion):
+			return !rbNumber_.isEmpty();
+		default:
+			return true;
+	}
+}
+
+// Set title search expression (an empty pattern matches all titles), returning whether it changed
+bool RunFilter::setTitleExpression(const QRegExp& expr)
+{
+	if (expr == titleExpr_) return false;
+
+	// Anything narrows a match-all search, and a fixed string containing the previous one can only match a subset of its titles
+	bool narrowed = false;
+	if (titleExpr_.pattern().isEmpty()) narrowed = true;
+	else if (expr.pattern().isEmpty()) narrowed = false;
+	else if ((expr.patternSyntax() == QRegExp::FixedString) && (titleExpr_.patternSyntax() == QRegExp::FixedString) && (expr.caseSensitivity() == titleExpr_.caseSensitivity()))
+	{
+		narrowed = expr.pattern().contains(titleExpr_.pattern(), expr.caseSensitivity());
+	}
+
+	titleExpr_ = expr;
+	titleMatches_.clear();
+	changed(RunFilter::TitleCriterion, narrowed);
+
+	return true;
+}
+
+// Return title search expression
+const QRegExp& RunFilter::titleExpression() const
+{
+	return titleExpr_;
+}
+
+// Return title match cache, which may be initialised after the title expression changes
+QVector<int>& RunFilter::titleMatches()
+{
+	return titleMatches_;
+}
+
+// Set user to match (empty to match all users), returning whether it changed
+bool RunFilter::setUser(const QString& user)
+{
+	if (user == user_) return false;
+
+	bool narrowed = user_.isEmpty();
+	user_ = user;
+	userMatches_.clear();
+	changed(RunFilter::UserCriterion, narrowed);
+
+	return true;
+}
+
+// Set RB number to match (empty to match all RB numbers), returning whether it changed
+bool RunFilter::setRBNumber(const QString& rbNumber)
+{
+	if (rbNumber == rbNumber_) return false;
+
+	bool narrowed = rbNumber_.isEmpty();
+	rbNumber_ = rbNumber;
+	rbMatches_.clear();
+	changed(RunFilter::RBCriterion, narrowed);
+
+	return true;
+}
+
+// Set time range (seconds since epoch), returning whether it changed
+bool RunFilter::setDateRange(qint64 fromTime, qint64 toTime, bool onRunning)
+{
+	if ((fromTime == fromTime_) && (toTime == toTime_) && (onRunning == dateOnRunning_)) return false;
+
+	bool narrowed = (onRunning == dateOnRunning_) && (fromTime >= fromTime_) && (toTime <= toTime_);
+	fromTime_ = fromTime;
+	toTime_ = toTime;
+	dateOnRunning_ = onRunning;
+	changed(RunFilter::DateCriterion, narrowed);
+
+	return true;
+}
+
+// Set run number range, returning whether it changed
+bool RunFilter::setRunNumberRange(int fromRunNumber, int toRunNumber)
+{
+	if ((fromRunNumber == fromRunNumber_) && (toRunNumber == toRunNumber_)) return false;
+
+	bool narrowed = (fromRunNumber >= fromRunNumber_) && (toRunNumber <= toRunNumber_);
+	fromRunNumber_ = fromRunNumber;
+	toRunNumber_ = toRunNumber;
+	changed(RunFilter::RunNumberCriterion, narrowed);
+
+	return true;
+}
+
+/*
+ * Bitsets
+ */
+
+// Sort rows of the catalogue by run number, start time and end time
+void RunFilter::sortRows(RunFilter::JournalBits& journalBits, const RunCatalogue* catalogue)
+{
+	int nRows = catalogue->nRows();
+	sortColumn(catalogue->runNumbers(), nRows, journalBits.runNumberOrder);
+	sortColumn(catalogue->startEpochs(), nRows, journalBits.startOrder);
+	sortColumn(catalogue->endEpochs(), nRows, journalBits.endOrder);
+}
+
+// Update bitset of criterion over catalogue, re-testing only runs currently passing the criterion if requested
+void RunFilter::updateBits(RunFilter::Criterion criterion, RunFilter::JournalBits& journalBits, const RunCatalogue* catalogue, bool narrowOnly)
+{
+	QBitArray& bits = journalBits.bits[criterion];
+	int nRows = catalogue->nRows();
+	if (!narrowOnly) bits.fill(true, nRows);
+	if (!isActive(criterion)) return;
+
+	int row, n;
+	switch (criterion)
+	{
+		case (RunFilter::TitleCriterion):
+		case (RunFilter::UserCriterion):
+		{
+			// Test the distinct strings of the runs to check in parallel, then clear bits of those which don't match
+			const int* stringIds = (criterion == RunFilter::TitleCriterion ? catalogue->titleIds() : catalogue->userIds());
+			QVector<int>& matches = (criterion == RunFilter::TitleCriterion ? titleMatches_ : userMatches_);
+			QVector<int> ids;
+			ids.reserve(narrowOnly ? bits.count(true) : nRows);
+			for (row = 0; row < nRows; ++row) if (bits.testBit(row)) ids.append(stringIds[row]);
+			if (criterion == RunFilter::TitleCriterion) StringMatcher::match(titleExpr_, ids.constData(), ids.count(), matches);
+			else StringMatcher::match(QRegExp(user_, Qt::CaseInsensitive, QRegExp::FixedString), ids.constData(), ids.count(), matches);
+
+			for (row = 0; row < nRows; ++row) if (bits.testBit(row) && (!matches.at(stringIds[row]))) bits.clearBit(row);
+			break;
+		}
+		case (RunFilter::RBCriterion):
+		{
+			QRegExp rbExpr(rbNumber_, Qt::CaseInsensitive, QRegExp::FixedString);
+			const int* rbNumbers = catalogue->rbNumbers();
+			for (row = 0; row < nRows; ++row)
+			{
+				if (!bits.testBit(row)) continue;
+
+				QHash<int,bool>::iterator it = rbMatches_.find(rbNumbers[row]);
+				if (it == rbMatches_.end()) it = rbMatches_.insert(rbNumbers[row], rbExpr.indexIn(QString::number(rbNumbers[row])) != -1);
+				if (!it.value()) bits.clearBit(row);
+			}
+			break;
+		}
+		case (RunFilter::DateCriterion):
+		{
+			// Ranges are found from the sorted rows rather than by testing every run, so narrowing doesn't help here
+			const qint64* startEpochs = catalogue->startEpochs();
+			const qint64* endEpochs = catalogue->endEpochs();
+			bits.fill(false, nRows);
+			if (dateOnRunning_)
+			{
+				// Runs ending after the start of the range, and starting before its end - take whichever span is smaller and test the other condition
+				int firstEnd = lowerBound(endEpochs, journalBits.endOrder, fromTime_);
+				int lastStart = upperBound(startEpochs, journalBits.startOrder, toTime_);
+				if ((nRows - firstEnd) < lastStart)
+				{
+					for (n = firstEnd; n < nRows; ++n)
+					{
+						row = journalBits.endOrder.at(n);
+						if (startEpochs[row] <= toTime_) bits.setBit(row);
+					}
+				}
+				else
+				{
+					for (n = 0; n < lastStart; ++n)
+					{
+						row = journalBits.startOrder.at(n);
+						if (endEpochs[row] >= fromTime_) bits.setBit(row);
+					}
+				}
+			}
+			else
+			{
+				// Runs starting within the range (which should also end after its start)
+				int firstStart = lowerBound(startEpochs, journalBits.startOrder, fromTime_);
+				int lastStart = upperBound(startEpochs, journalBits.startOrder, toTime_);
+				for (n = firstStart; n < lastStart; ++n)
+				{
+					row = journalBits.startOrder.at(n);
+					if (endEpochs[row] >= fromTime_) bits.setBit(row);
+				}
+			}
+			break;
+		}
+		case (RunFilter::RunNumberCriterion):
+		{
+			// Runs within the range form a contiguous span of the sorted rows
+			const int* runNumbers = catalogue->runNumbers();
+			bits.fill(false, nRows);
+			int firstRun = lowerBound(runNumbers, journalBits.runNumberOrder, fromRunNumber_);
+			int lastRun = upperBound(runNumbers, journalBits.runNumberOrder, toRunNumber_);
+			for (n = firstRun; n < lastRun; ++n) bits.setBit(journalBits.runNumberOrder.at(n));
+			break;
+		}
+		default:
+			printf("Internal Error: Unrecognised criterion in RunFilter::updateBits().\n");
+			break;
+	}
+}
+
+// Clear all cached bitsets
+void RunFilter::clear()
+{
+	journals_.clear();
+}
+
+// Remove cached bitsets of specified journal
+void RunFilter::removeJournal(Journal* jrnl)
+{
+	journals_.remove(jrnl);
+}
+
+// Remove cached bitsets of all journals of specified instrument
+void RunFilter::removeInstrument(Instrument* inst)
+{
+	for (Journal* jrnl = inst->journals(); jrnl != NULL; jrnl = jrnl->next) removeJournal(jrnl);
+}
+
+// Return visibility of each row of the journal's catalogue (ignoring the excluded criterion, if any), updating any bitsets which are out of date
+QBitArray RunFilter::visibility(Journal* jrnl, RunFilter::Criterion excluded)
+{
+	const RunCatalogue* catalogue = jrnl->catalogue();
+	int nRows = catalogue->nRows();
+
+	// Get bitsets for this journal, recalculating everything if its catalogue has changed size
+	QHash<Journal*,JournalBits>::iterator it = journals_.find(jrnl);
+	if (it == journals_.end())
+	{
+		it = journals_.insert(jrnl, JournalBits());
+		it.value().nRows = -1;
+	}
+	JournalBits& journalBits = it.value();
+	if (journalBits.nRows != nRows)
+	{
+		journalBits.nRows = nRows;
+		for (int n=0; n<nCriteria; ++n) journalBits.generation[n] = -1;
+		sortRows(journalBits, catalogue);
+	}
+
+	// Bring each criterion up to date, and combine those which are active
+	QBitArray visible(nRows, true);
+	for (int n=0; n<nCriteria; ++n)
+	{
+		RunFilter::Criterion criterion = (RunFilter::Criterion) n;
+		if (journalBits.generation[n] != generation_[n])
+		{
+			// If the criterion has only narrowed since the bitset was calculated, only its passing runs need to be re-tested
+			bool narrowOnly = (journalBits.generation[n] != -1) && (journalBits.generation[n] >= resetGeneration_[n]);
+			updateBits(criterion, journalBits, catalogue, narrowOnly);
+			journalBits.generation[n] = generation_[n];
+		}
+		if ((criterion != excluded) && isActive(criterion)) visible &= journalBits.bits[n];
+	}
+
+	return visible;
+}
+
+// Return estimated memory used by the filter (bytes)
+qint64 RunFilter::memoryUsage() const
+{
+	qint64 bytes = sizeof(RunFilter);
+	bytes += (titleMatches_.capacity() + userMatches_.capacity()) * sizeof(int);
+	bytes += rbMatches_.capacity() * sizeof(void*) + rbMatches_.size() * (sizeof(int) + sizeof(bool) + 2*sizeof(void*));
+	bytes += journals_.capacity() * sizeof(void*) + journals_.size() * (sizeof(Journal*) + sizeof(JournalBits) + 2*sizeof(void*));
+	for (QHash<Journal*,JournalBits>::const_iterator it = journals_.constBegin(); it != journals_.constEnd(); ++it)
+	{
+		for (int n=0; n<nCriteria; ++n) bytes += (it.value().bits[n].size()+7) / 8;
+		bytes += (it.value().runNumberOrder.capacity() + it.value().startOrder.capacity() + it.value().endOrder.capacity()) * sizeof(int);
+	}
+	return bytes;
+}
@@ -0,0 +1,134 @@
+/*
+	*** Run Filter
+	*** src/runfilter.h
+	Copyright T. Youngs 2012-2016
+
+	This file is part of JournalViewer.
+
+	JournalViewer is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	JournalViewer is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with JournalViewer.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef JOURNALVIEWER_RUNFILTER_H
+#define JOURNALVIEWER_RUNFILTER_H
+
+#include <QString>
+#include <QRegExp>
+#include <QBitArray>
+#include <QVector>
+#include <QHash>
+
+// Forward Declarations
+class Instrument;
+class Journal;
+class RunCatalogue;
+
+/*
+ * Filter over the runs of loaded journals, composed of one cached bitset per criterion and journal.
+ * A criterion's bitset is only recalculated when that criterion changes, and if the change can only narrow the criterion (e.g. a longer
+ * fixed search string) only those runs it currently passes are re-tested. Date and run number ranges are found by binary search of the rows
+ * sorted on the relevant column. Journals must be removed from the filter whenever their runs change.
+ */
+class RunFilter
+{
+	public:
+	// Constructor
+	RunFilter();
+	// Filter criteria
+	enum Criterion { TitleCriterion, UserCriterion, RBCriterion, DateCriterion, RunNumberCriterion, nCriteria };
+
+
+	/*
+	 * Criteria
+	 */
+	private:
+	// Title search expression (empty to match all titles)
+	QRegExp titleExpr_;
+	// User and RB number to match (empty to match all)
+	QString user_, rbNumber_;
+	// Time range (seconds since epoch), and whether runs must only be running within it (rather than starting within it)
+	qint64 fromTime_, toTime_;
+	bool dateOnRunning_;
+	// Run number range
+	int fromRunNumber_, toRunNumber_;
+	// Generation of each criterion, incremented whenever it changes
+	int generation_[nCriteria];
+	// Generation of each criterion at which it last changed in a way that wasn't a narrowing
+	int resetGeneration_[nCriteria];
+	// Cached title (-1 = not yet tested, 0 = no match, 1 = match) and user matches, by string id
+	QVector<int> titleMatches_, userMatches_;
+	// Cached RB number matches
+	QHash<int,bool> rbMatches_;
+
+	private:
+	// Register change to specified criterion
+	void changed(Criterion criterion, bool narrowed);
+	// Return whether criterion is active (i.e. may exclude runs)
+	bool isActive(Criterion criterion) const;
+
+	public:
+	// Set title search expression (an empty pattern matches all titles), returning whether it changed
+	bool setTitleExpression(const QRegExp& expr);
+	// Return title search expression
+	const QRegExp& titleExpression() const;
+	// Return title match cache, which may be initialised after the title expression changes
+	QVector<int>& titleMatches();
+	// Set user to match (empty to match all users), returning whether it changed
+	bool setUser(const QString& user);
+	// Set RB number to match (empty to match all RB numbers), returning whether it changed
+	bool setRBNumber(const QString& rbNumber);
+	// Set time range (seconds since epoch), returning whether it changed
+	bool setDateRange(qint64 fromTime, qint64 toTime, bool onRunning);
+	// Set run number range, returning whether it changed
+	bool setRunNumberRange(int fromRunNumber, int toRunNumber);
+
+
+	/*
+	 * Bitsets
+	 */
+	private:
+	// Cached bitsets for a journal
+	struct JournalBits
+	{
+		// Number of rows in the journal's catalogue when the bitsets were calculated
+		int nRows;
+		// Bitset for each criterion
+		QBitArray bits[nCriteria];
+		// Generation of each criterion that the bitset corresponds to (-1 if never calculated)
+		int generation[nCriteria];
+		// Rows of the catalogue in ascending order of run number, start time and end time
+		QVector<int> runNumberOrder, startOrder, endOrder;
+	};
+	// Bitsets of each journal
+	QHash<Journal*,JournalBits> journals_;
+
+	private:
+	// Sort rows of the catalogue by run number, start time and end time
+	static void sortRows(JournalBits& journalBits, const RunCatalogue* catalogue);
+	// Update bitset of criterion over catalogue, re-testing only runs currently passing the criterion if requested
+	void updateBits(Criterion criterion, JournalBits& journalBits, const RunCatalogue* catalogue, bool narrowOnly);
+
+	public:
+	// Clear all cached bitsets
+	void clear();
+	// Remove cached bitsets of specified journal
+	void removeJournal(Journal* jrnl);
+	// Remove cached bitsets of all journals of specified instrument
+	void removeInstrument(Instrument* inst);
+	// Return visibility of each row of the journal's catalogue (ignoring the excluded criterion, if any), updating any bitsets which are out of date
+	QBitArray visibility(Journal* jrnl, Criterion excluded = nCriteria);
+	// Return estimated memory used by the filter (bytes)
+	qint64 memoryUsage() const;
+};
+
+#endif
@@ -0,0 +1,200 @@
+/*
+	*** Run Grouping
+	*** src/rungrouping.cpp
+	Copyright T. Youngs 2012-2016
+
+	This file is part of JournalViewer.
+
+	JournalViewer is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	JournalViewer is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with JournalViewer.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "rungrouping.h"
+#include "runcatalogue.h"
+
+// Constructor
+RunGrouping::RunGrouping(int key)
+{
+	key_ = key;
+	valid_ = false;
+}
+
+/*
+ * Keys
+ */
+
+// Return normalised title id of specified title string id
+int RunGrouping::normalisedTitleId(int titleId)
+{
+	if (titleId < 0) return -1;
+	if (titleId >= normalisedTitleIds_.count())
+	{
+		int oldSize = normalisedTitleIds_.count();
+		normalisedTitleIds_.resize(qMax(titleId+1, RunCatalogue::nStrings()));
+		for (int n=oldSize; n<normalisedTitleIds_.count(); ++n) normalisedTitleIds_[n] = -1;
+	}
+	int& id = normalisedTitleIds_[titleId];
+	if (id == -1)
+	{
+		QString title = normalisedTitle(RunCatalogue::string(titleId));
+		id = normalisedTitles_.value(title, -1);
+		if (id == -1)
+		{
+			id = normalisedTitles_.count();
+			normalisedTitles_.insert(title, id);
+		}
+	}
+	return id;
+}
+
+// Return key value of specified run
+qint64 RunGrouping::keyValue(RunData* rd)
+{
+	// Use ids or integer values from the catalogue where we can, and fall back to the (cached) formatted property otherwise
+	switch (key_)
+	{
+		case (RunProperty::Cycle):
+			return rd->cycle();
+		case (RunProperty::Duration):
+			return rd->duration();
+		case (RunProperty::EndTimeAndDate):
+			return rd->endEpoch();
+		case (RunProperty::GroupNumber):
+			return rd->group();
+		case (RunProperty::RBNumber):
+			return rd->rbNumber();
+		case (RunProperty::RunNumber):
+			return rd->runNumber();
+		case (RunProperty::StartTimeAndDate):
+			return rd->startEpoch();
+		case (RunProperty::Title):
+			return rd->titleId();
+		case (RunProperty::User):
+			return rd->userId();
+		case (NormalisedTitleKey):
+			return normalisedTitleId(rd->titleId());
+		default:
+			break;
+	}
+	QString value = rd->propertyAsString((RunProperty::Property) key_);
+	int id = propertyStrings_.value(value, -1);
+	if (id == -1)
+	{
+		id = propertyStrings_.count();
+		propertyStrings_.insert(value, id);
+	}
+	return id;
+}
+
+// Set key by which runs are grouped
+void RunGrouping::setKey(int key)
+{
+	if (key_ == key) return;
+	key_ = key;
+	invalidate();
+}
+
+// Return key by which runs are grouped
+int RunGrouping::key() const
+{
+	return key_;
+}
+
+// Return normalised form of supplied title
+QString RunGrouping::normalisedTitle(const QString& title)
+{
+	return title.simplified().toCaseFolded();
+}
+
+/*
+ * Groups
+ */
+
+// Group the supplied runs, returning false if the cached groups of the same runs could be reused
+bool RunGrouping::group(const QVector<RunData*>& runs)
+{
+	if (valid_ && (runs == runs_)) return false;
+
+	runs_ = runs;
+	groups_.clear();
+	groupIndex_.clear();
+	groupIndex_.reserve(runs_.count());
+	propertyStrings_.clear();
+
+	// Assign each distinct key value the next group index, in order of first appearance
+	QHash<qint64,int> keyGroups;
+	int index;
+	for (int n=0; n<runs_.count(); ++n)
+	{
+		RunData* rd = runs_.at(n);
+		qint64 value = keyValue(rd);
+		index = keyGroups.value(value, -1);
+		if (index == -1)
+		{
+			index = groups_.count();
+			keyGroups.insert(value, index);
+			groups_.append(QVector<RunData*>());
+		}
+		groups_[index].append(rd);
+		groupIndex_.insert(rd, index);
+	}
+
+	valid_ = true;
+	return true;
+}
+
+// Invalidate cached groups (e.g. because run data has been reloaded or deleted)
+void RunGrouping::invalidate()
+{
+	valid_ = false;
+	runs_.clear();
+	groups_.clear();
+	groupIndex_.clear();
+}
+
+// Return number of groups
+int RunGrouping::nGroups() const
+{
+	return groups_.count();
+}
+
+// Return group index of specified run (or -1 if it was not grouped)
+int RunGrouping::groupOf(RunData* rd) const
+{
+	return groupIndex_.value(rd, -1);
+}
+
+// Return runs in specified group, in the order supplied
+const QVector<RunData*>& RunGrouping::members(int group) const
+{
+	static QVector<RunData*> noRuns;
+	if ((group < 0) || (group >= groups_.count()))
+	{
+		printf("Internal Error - Group index %i is out of range in RunGrouping::members().\n", group);
+		return noRuns;
+	}
+	return groups_.at(group);
+}
+
+// Return estimated memory used by the grouping (bytes)
+qint64 RunGrouping::memoryUsage() const
+{
+	qint64 bytes = sizeof(RunGrouping);
+	bytes += normalisedTitleIds_.capacity() * sizeof(int);
+	bytes += runs_.capacity() * sizeof(RunData*);
+	for (int n=0; n<groups_.count(); ++n) bytes += sizeof(QVector<RunData*>) + groups_.at(n).capacity() * sizeof(RunData*);
+	bytes += groupIndex_.capacity() * sizeof(void*) + groupIndex_.size() * (sizeof(RunData*) + sizeof(int) + 2*sizeof(void*));
+	QHash<QString,int>::const_iterator it;
+	for (it = normalisedTitles_.constBegin(); it != normalisedTitles_.constEnd(); ++it) bytes += sizeof(QString) + sizeof(int) + 2*sizeof(void*) + it.key().size() * sizeof(QChar);
+	return bytes;
+}
@@ -0,0 +1,102 @@
+/*
+	*** Run Grouping
+	*** src/rungrouping.h
+	Copyright T. Youngs 2012-2016
+
+	This file is part of JournalViewer.
+
+	JournalViewer is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	JournalViewer is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with JournalViewer.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef JOURNALVIEWER_RUNGROUPING_H
+#define JOURNALVIEWER_RUNGROUPING_H
+
+#include "rundata.h"
+#include <QVector>
+#include <QHash>
+#include <QString>
+
+/*
+ * Grouping of runs by the value of a RunProperty (by default their exact title), or optionally by their normalised
+ * (case-folded and whitespace-simplified) title.
+ * Runs are grouped by hashing a key for each, taken from the catalogue ids or values where possible, and the resulting groups
+ * are cached so that grouping the same runs by the same key again (e.g. for Select Similar after grouping the table) costs
+ * only a comparison of the run list.
+ */
+class RunGrouping
+{
+	public:
+	// Grouping keys other than the RunProperties
+	enum { NormalisedTitleKey = RunProperty::nProperties };
+	// Constructor
+	RunGrouping(int key = RunProperty::Title);
+
+
+	/*
+	 * Keys
+	 */
+	private:
+	// Key by which runs are grouped (a RunProperty::Property, or NormalisedTitleKey)
+	int key_;
+	// Normalised title ids of title string ids (or -1 if not yet normalised)
+	QVector<int> normalisedTitleIds_;
+	// Ids of normalised titles
+	QHash<QString,int> normalisedTitles_;
+	// Ids of property strings, for properties with no integer representation
+	QHash<QString,int> propertyStrings_;
+
+	private:
+	// Return normalised title id of specified title string id
+	int normalisedTitleId(int titleId);
+	// Return key value of specified run
+	qint64 keyValue(RunData* rd);
+
+	public:
+	// Set key by which runs are grouped
+	void setKey(int key);
+	// Return key by which runs are grouped
+	int key() const;
+	// Return normalised form of supplied title
+	static QString normalisedTitle(const QString& title);
+
+
+	/*
+	 * Groups
+	 */
+	private:
+	// Whether the current groups are valid
+	bool valid_;
+	// Runs grouped, in the order supplied
+	QVector<RunData*> runs_;
+	// Runs in each group, in order of first appearance
+	QVector< QVector<RunData*> > groups_;
+	// Group index of each run, by RunData
+	QHash<RunData*,int> groupIndex_;
+
+	public:
+	// Group the supplied runs, returning false if the cached groups of the same runs could be reused
+	bool group(const QVector<RunData*>& runs);
+	// Invalidate cached groups (e.g. because run data has been reloaded or deleted)
+	void invalidate();
+	// Return number of groups
+	int nGroups() const;
+	// Return group index of specified run (or -1 if it was not grouped)
+	int groupOf(RunData* rd) const;
+	// Return runs in specified group, in the order supplied
+	const QVector<RunData*>& members(int group) const;
+	// Return estimated memory used by the grouping (bytes)
+	qint64 memoryUsage() const;
+};
+
+#endif
@@ -0,0 +1,148 @@
+/*
+	*** Run Index
+	*** src/runindex.cpp
+	Copyright T. Youngs 2012-2016
+
+	This file is part of JournalViewer.
+
+	JournalViewer is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	JournalViewer is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with JournalViewer.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "runindex.h"
+#include "journal.h"
+#include "instrument.h"
+#include "rundata.h"
+#include <algorithm>
+
+// Constructor
+RunIndex::RunIndex()
+{
+	sortedKeysValid_ = true;
+}
+
+/*
+ * Index
+ */
+
+// Return key for specified instrument and run number
+qint64 RunIndex::key(ISIS::ISISInstrument inst, int runNumber)
+{
+	// Instrument in the upper 32 bits and run number in the lower, so keys sort by instrument then run number
+	return (qint64(inst) << 32) | quint32(runNumber);
+}
+
+// Clear index
+void RunIndex::clear()
+{
+	runs_.clear();
+	journalKeys_.clear();
+	sortedKeys_.clear();
+	sortedKeysValid_ = true;
+}
+
+// Add (or re-add) RunData of specified journal to the index
+void RunIndex::addJournal(Journal* jrnl)
+{
+	removeJournal(jrnl);
+	if (jrnl->runData().nItems() == 0) return;
+
+	// Runs are indexed under the instrument owning the journal (runs in the journals of the LOCAL instrument are kept apart from those of the real instruments)
+	ISIS::ISISInstrument inst = jrnl->parent()->instrument();
+	const int* runNumbers = jrnl->catalogue()->runNumbers();
+	QVector<qint64>& keys = journalKeys_[jrnl];
+	keys.reserve(jrnl->runData().nItems());
+	runs_.reserve(runs_.size() + jrnl->runData().nItems());
+	Entry entry;
+	entry.journal = jrnl;
+	for (RunData* rd = jrnl->runData().first(); rd != NULL; rd = rd->next)
+	{
+		qint64 runKey = key(inst, runNumbers[rd->row()]);
+		entry.runData = rd;
+		runs_.insert(runKey, entry);
+		keys << runKey;
+	}
+
+	sortedKeysValid_ = false;
+}
+
+// Remove RunData of specified journal from the index
+void RunIndex::removeJournal(Journal* jrnl)
+{
+	QHash<Journal*, QVector<qint64> >::iterator it = journalKeys_.find(jrnl);
+	if (it == journalKeys_.end()) return;
+
+	// Only remove entries still belonging to the journal (a duplicate run number in another journal may have replaced them)
+	const QVector<qint64>& keys = it.value();
+	for (int n=0; n<keys.size(); ++n)
+	{
+		QHash<qint64,Entry>::iterator entry = runs_.find(keys.at(n));
+		if ((entry != runs_.end()) && (entry.value().journal == jrnl)) runs_.erase(entry);
+	}
+	journalKeys_.erase(it);
+
+	sortedKeysValid_ = false;
+}
+
+// Remove RunData of all journals of specified instrument from the index
+void RunIndex::removeInstrument(Instrument* inst)
+{
+	for (Journal* jrnl = inst->journals(); jrnl != NULL; jrnl = jrnl->next) removeJournal(jrnl);
+}
+
+// Return number of indexed runs
+int RunIndex::nRuns() const
+{
+	return runs_.size();
+}
+
+// Return estimated memory used by the index (bytes)
+qint64 RunIndex::memoryUsage() const
+{
+	qint64 bytes = sizeof(RunIndex);
+	bytes += runs_.capacity() * sizeof(void*) + runs_.size() * (sizeof(qint64) + sizeof(Entry) + 2*sizeof(void*));
+	bytes += journalKeys_.capacity() * sizeof(void*) + journalKeys_.size() * (sizeof(Journal*) + sizeof(QVector<qint64>) + 2*sizeof(void*));
+	for (QHash<Journal*, QVector<qint64> >::const_iterator it = journalKeys_.constBegin(); it != journalKeys_.constEnd(); ++it) bytes += it.value().capacity() * sizeof(qint64);
+	bytes += sortedKeys_.capacity() * sizeof(qint64);
+	return bytes;
+}
+
+// Return RunData for specified instrument and run number (or NULL if it is not loaded)
+RunData* RunIndex::find(ISIS::ISISInstrument inst, int runNumber) const
+{
+	QHash<qint64,Entry>::const_iterator it = runs_.constFind(key(inst, runNumber));
+	return (it == runs_.constEnd() ? NULL : it.value().runData);
+}
+
+// Return RunData for specified instrument within the (inclusive) run number range, in ascending order of run number
+QVector<RunData*> RunIndex::range(ISIS::ISISInstrument inst, int firstRunNumber, int lastRunNumber) const
+{
+	QVector<RunData*> result;
+	if (firstRunNumber < 0) firstRunNumber = 0;
+	if (firstRunNumber > lastRunNumber) return result;
+
+	// Regenerate sorted keys if the index has changed since we last needed them
+	if (!sortedKeysValid_)
+	{
+		sortedKeys_ = runs_.keys().toVector();
+		std::sort(sortedKeys_.begin(), sortedKeys_.end());
+		sortedKeysValid_ = true;
+	}
+
+	QVector<qint64>::const_iterator first = std::lower_bound(sortedKeys_.constBegin(), sortedKeys_.constEnd(), key(inst, firstRunNumber));
+	QVector<qint64>::const_iterator last = std::upper_bound(first, sortedKeys_.constEnd(), key(inst, lastRunNumber));
+	result.reserve(last - first);
+	for (QVector<qint64>::const_iterator it = first; it != last; ++it) result << runs_.value(*it).runData;
+
+	return result;
+}
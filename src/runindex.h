@@ -0,0 +1,89 @@
+/*
+	*** Run Index
+	*** src/runindex.h
+	Copyright T. Youngs 2012-2016
+
+	This file is part of JournalViewer.
+
+	JournalViewer is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	JournalViewer is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with JournalViewer.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef JOURNALVIEWER_RUNINDEX_H
+#define JOURNALVIEWER_RUNINDEX_H
+
+#include "isis.h"
+#include <QHash>
+#include <QVector>
+
+// Forward Declarations
+class Instrument;
+class Journal;
+class RunData;
+
+/*
+ * Index of loaded runs from all journals of all instruments, keyed on (instrument, run number).
+ * Journals are (re)indexed once they have finished loading, and must be removed from the index before their RunData are changed or deleted.
+ */
+class RunIndex
+{
+	public:
+	// Constructor
+	RunIndex();
+
+
+	/*
+	 * Index
+	 */
+	private:
+	// Indexed run
+	struct Entry
+	{
+		// Journal containing the run
+		Journal* journal;
+		// Run data
+		RunData* runData;
+	};
+	// Indexed runs
+	QHash<qint64,Entry> runs_;
+	// Keys of runs indexed from each journal
+	QHash<Journal*, QVector<qint64> > journalKeys_;
+	// Sorted keys of all indexed runs, for range iteration (regenerated when needed)
+	mutable QVector<qint64> sortedKeys_;
+	// Whether sortedKeys_ is up to date
+	mutable bool sortedKeysValid_;
+
+	private:
+	// Return key for specified instrument and run number
+	static qint64 key(ISIS::ISISInstrument inst, int runNumber);
+
+	public:
+	// Clear index
+	void clear();
+	// Add (or re-add) RunData of specified journal to the index
+	void addJournal(Journal* jrnl);
+	// Remove RunData of specified journal from the index
+	void removeJournal(Journal* jrnl);
+	// Remove RunData of all journals of specified instrument from the index
+	void removeInstrument(Instrument* inst);
+	// Return number of indexed runs
+	int nRuns() const;
+	// Return estimated memory used by the index (bytes)
+	qint64 memoryUsage() const;
+	// Return RunData for specified instrument and run number (or NULL if it is not loaded)
+	RunData* find(ISIS::ISISInstrument inst, int runNumber) const;
+	// Return RunData for specified instrument within the (inclusive) run number range, in ascending order of run number
+	QVector<RunData*> range(ISIS::ISISInstrument inst, int firstRunNumber, int lastRunNumber) const;
+};
+
+#endif
@@ -0,0 +1,67 @@
+/*
+	*** Running Window
+	*** src/runningwindow.h
+	Copyright T. Youngs 2012-2016
+
+	This file is part of JournalViewer.
+
+	JournalViewer is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	JournalViewer is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with JournalViewer.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef JOURNALVIEWER_RUNNINGWINDOW_H
+#define JOURNALVIEWER_RUNNINGWINDOW_H
+
+#include "ui_runningwindow.h"
+
+// Forward Declarations
+class JournalViewer;
+
+class RunningWindow : public QDialog
+{
+	// All Qt declarations must include this macro
+	Q_OBJECT
+
+
+	/*
+	// Window Functions
+	*/
+	public:
+	// Constructor / Destructor
+	RunningWindow(JournalViewer& parent);
+	~RunningWindow();
+	// Main form declaration
+	Ui::RunningWindow ui;
+	// Parent JournalViewer window
+	JournalViewer& jvParent_;
+
+	private:
+	// Find runs in progress at the selected time (or overlapping the selected range)
+	void findRuns();
+
+
+	/*
+	// Widget Slots
+	*/
+	private slots:
+	// Range checkbox clicked
+	void on_RangeCheck_clicked(bool checked);
+	// Find button
+	void on_FindButton_clicked(bool checked);
+	// Run double-clicked
+	void on_RunsTree_itemDoubleClicked(QTreeWidgetItem* item, int column);
+	// Close button
+	void on_CloseButton_clicked(bool checked);
+};
+
+#endif
@@ -0,0 +1,108 @@
+/*
+	*** Running Window Functions
+	*** src/runningwindow_funcs.cpp
+	Copyright T. Youngs 2012-2016
+
+	This file is part of JournalViewer.
+
+	JournalViewer is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	JournalViewer is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with JournalViewer.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "runningwindow.h"
+#include "jv.h"
+#include "instrument.h"
+#include "journal.h"
+#include "isis.h"
+
+// Constructor
+RunningWindow::RunningWindow(JournalViewer& parent) : QDialog(&parent), jvParent_(parent)
+{
+	// Call the main creation function
+	ui.setupUi(this);
+	ui.RunsTree->setHeaderLabels(QStringList() << "Instrument" << "Run" << "Start" << "End" << "Title");
+
+	QDateTime now = QDateTime::currentDateTime();
+	ui.FromDateTimeEdit->setDateTime(now);
+	ui.ToDateTimeEdit->setDateTime(now);
+	ui.ToDateTimeEdit->setEnabled(false);
+}
+
+// Destructor
+RunningWindow::~RunningWindow()
+{
+}
+
+// Find runs in progress at the selected time (or overlapping the selected range)
+void RunningWindow::findRuns()
+{
+	qint64 fromTime = ISIS::epochSeconds(ui.FromDateTimeEdit->dateTime());
+	qint64 toTime = (ui.RangeCheck->isChecked() ? ISIS::epochSeconds(ui.ToDateTimeEdit->dateTime()) : fromTime);
+	if (toTime < fromTime)
+	{
+		ui.CountLabel->setText("End of range is before its start");
+		return;
+	}
+
+	QVector<RunData*> runs = jvParent_.runsOverlapping(fromTime, toTime);
+
+	ui.RunsTree->clear();
+	for (int n=0; n<runs.count(); ++n)
+	{
+		RunData* rd = runs.at(n);
+		Instrument* inst = rd->journalSource()->parent();
+		QTreeWidgetItem* item = new QTreeWidgetItem(ui.RunsTree);
+		item->setText(0, inst->capitalisedName());
+		item->setData(0, Qt::UserRole, (int) inst->instrument());
+		item->setText(1, QString::number(rd->runNumber()));
+		item->setText(2, rd->startDateTimeString());
+		item->setText(3, rd->endDateTimeString());
+		item->setText(4, rd->title());
+	}
+	for (int n=0; n<4; ++n) ui.RunsTree->resizeColumnToContents(n);
+
+	ui.CountLabel->setText(QString::number(runs.count()) + (runs.count() == 1 ? " run" : " runs") + " found in loaded journals");
+}
+
+/*
+// Widget Slots
+*/
+
+// Range checkbox clicked
+void RunningWindow::on_RangeCheck_clicked(bool checked)
+{
+	ui.ToDateTimeEdit->setEnabled(checked);
+	if (checked && (ui.ToDateTimeEdit->dateTime() < ui.FromDateTimeEdit->dateTime())) ui.ToDateTimeEdit->setDateTime(ui.FromDateTimeEdit->dateTime());
+}
+
+// Find button
+void RunningWindow::on_FindButton_clicked(bool checked)
+{
+	findRuns();
+}
+
+// Run double-clicked
+void RunningWindow::on_RunsTree_itemDoubleClicked(QTreeWidgetItem* item, int column)
+{
+	if (item == NULL) return;
+
+	Instrument* inst = jvParent_.instrument((ISIS::ISISInstrument) item->data(0, Qt::UserRole).toInt());
+	if (inst == NULL) return;
+	jvParent_.goToRun(inst, item->text(1).toInt());
+}
+
+// Close button
+void RunningWindow::on_CloseButton_clicked(bool checked)
+{
+	hide();
+}
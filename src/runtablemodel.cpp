@@ -0,0 +1,313 @@
+/*
+	*** Run Table Model
+	*** src/runtablemodel.cpp
+	Copyright T. Youngs 2012-2016
+
+	This file is part of JournalViewer.
+
+	JournalViewer is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	JournalViewer is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with JournalViewer.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "runtablemodel.h"
+#include <algorithm>
+
+// Constructor
+RunTableModel::RunTableModel(QObject* parent) : QAbstractTableModel(parent)
+{
+	columns_ << RunProperty::GroupNumber;
+	sortProperty_ = RunProperty::GroupNumber;
+	sortOrder_ = Qt::AscendingOrder;
+	highlightGroups_ = false;
+	normalBrush_ = QBrush(Qt::white);
+	highlightBrush_ = QBrush(QColor(230,230,230));
+}
+
+/*
+ * Columns
+ */
+
+// Set columns from list of visible properties (followed by the Group column), returning whether they changed
+bool RunTableModel::setColumns(const List<RunProperty>& properties)
+{
+	QVector<RunProperty::Property> columns;
+	for (RunProperty* rp = properties.first(); rp != NULL; rp = rp->next) columns << rp->type();
+	columns << RunProperty::GroupNumber;
+	if (columns == columns_) return false;
+
+	beginResetModel();
+	columns_ = columns;
+
+	// If the sort property is no longer displayed, sort by the first column instead
+	if (column(sortProperty_) == -1)
+	{
+		sortProperty_ = columns_.first();
+		sortOrder_ = Qt::AscendingOrder;
+		sortRuns();
+	}
+	endResetModel();
+
+	return true;
+}
+
+// Return column displaying specified property (or -1 if it is not displayed)
+int RunTableModel::column(RunProperty::Property property) const
+{
+	return columns_.indexOf(property);
+}
+
+// Return property displayed in specified column
+RunProperty::Property RunTableModel::columnProperty(int column) const
+{
+	if ((column < 0) || (column >= columns_.count())) return RunProperty::nProperties;
+	return columns_.at(column);
+}
+
+/*
+ * Rows
+ */
+
+// Set runs to display (in any order - they are sorted by the current sort property)
+void RunTableModel::setRuns(const QVector<RunData*>& runs)
+{
+	beginResetModel();
+	runs_ = runs;
+	sortRuns();
+	endResetModel();
+}
+
+// Return runs displayed, in row order
+const QVector<RunData*>& RunTableModel::runs() const
+{
+	return runs_;
+}
+
+// Return run displayed in specified row
+RunData* RunTableModel::runData(int row) const
+{
+	if ((row < 0) || (row >= runs_.count())) return NULL;
+	return runs_.at(row);
+}
+
+// Return row displaying specified run (or -1 if it is not displayed) - a linear search, so not for use in loops
+int RunTableModel::row(RunData* rd) const
+{
+	return runs_.indexOf(rd);
+}
+
+// Notify that the group numbers of the runs have changed
+void RunTableModel::groupsChanged()
+{
+	if (runs_.isEmpty()) return;
+
+	if (sortProperty_ == RunProperty::GroupNumber) resort();
+	emit dataChanged(index(0, 0), index(runs_.count()-1, columns_.count()-1), QVector<int>() << Qt::DisplayRole << Qt::BackgroundRole << SortRole);
+}
+
+/*
+ * Sorting
+ */
+
+// Return whether specified property is sorted by its numerical value (rather than its text)
+bool RunTableModel::numericSort(RunProperty::Property property)
+{
+	// Cycles are sorted by their text (e.g. '16_1'), since their ids reflect only the order in which they were first seen
+	switch (property)
+	{
+		case (RunProperty::Duration):
+		case (RunProperty::EndDate):
+		case (RunProperty::EndTime):
+		case (RunProperty::EndTimeAndDate):
+		case (RunProperty::GroupNumber):
+		case (RunProperty::ProtonCharge):
+		case (RunProperty::RBNumber):
+		case (RunProperty::RunNumber):
+		case (RunProperty::StartDate):
+		case (RunProperty::StartTime):
+		case (RunProperty::StartTimeAndDate):
+		case (RunProperty::TotalMEvents):
+			return true;
+		default:
+			break;
+	}
+	return false;
+}
+
+// Return numerical sort key of specified property of run
+double RunTableModel::numericKey(RunData* rd, RunProperty::Property property)
+{
+	// Dates and times are all sorted chronologically
+	switch (property)
+	{
+		case (RunProperty::Duration):
+			return rd->duration();
+		case (RunProperty::EndDate):
+		case (RunProperty::EndTime):
+		case (RunProperty::EndTimeAndDate):
+			return rd->endEpoch();
+		case (RunProperty::GroupNumber):
+			return rd->group();
+		case (RunProperty::ProtonCharge):
+			return rd->protonCharge();
+		case (RunProperty::RBNumber):
+			return rd->rbNumber();
+		case (RunProperty::RunNumber):
+			return rd->runNumber();
+		case (RunProperty::StartDate):
+		case (RunProperty::StartTime):
+		case (RunProperty::StartTimeAndDate):
+			return rd->startEpoch();
+		case (RunProperty::TotalMEvents):
+			return rd->totalMEvents();
+		default:
+			printf("Internal Error - Property %i has no numerical sort key in RunTableModel::numericKey().\n", property);
+			break;
+	}
+	return 0.0;
+}
+
+// Sort runs, returning the previous row of each run (or nothing if the order couldn't have changed)
+QVector<int> RunTableModel::sortRuns()
+{
+	QVector<int> order;
+	int nRuns = runs_.count();
+	if (nRuns < 2) return order;
+
+	// Extract the sort key of every run once, and sort row indices on them (stably, so equal keys keep their order)
+	order.resize(nRuns);
+	for (int n=0; n<nRuns; ++n) order[n] = n;
+	bool ascending = (sortOrder_ == Qt::AscendingOrder);
+	if (numericSort(sortProperty_))
+	{
+		QVector<double> keys(nRuns);
+		for (int n=0; n<nRuns; ++n) keys[n] = numericKey(runs_.at(n), sortProperty_);
+		std::stable_sort(order.begin(), order.end(), [&keys, ascending](int a, int b) { return ascending ? keys.at(a) < keys.at(b) : keys.at(b) < keys.at(a); });
+	}
+	else
+	{
+		QVector<QString> keys(nRuns);
+		for (int n=0; n<nRuns; ++n) keys[n] = runs_.at(n)->propertyAsString(sortProperty_);
+		std::stable_sort(order.begin(), order.end(), [&keys, ascending](int a, int b) { return ascending ? keys.at(a) < keys.at(b) : keys.at(b) < keys.at(a); });
+	}
+
+	QVector<RunData*> sortedRuns(nRuns);
+	for (int n=0; n<nRuns; ++n) sortedRuns[n] = runs_.at(order.at(n));
+	runs_ = sortedRuns;
+
+	return order;
+}
+
+// Re-sort runs, moving any persistent indices (e.g. the selection) with them
+void RunTableModel::resort()
+{
+	emit layoutAboutToBeChanged();
+
+	QVector<int> order = sortRuns();
+	if (!order.isEmpty())
+	{
+		QVector<int> newRows(order.count());
+		for (int n=0; n<order.count(); ++n) newRows[order.at(n)] = n;
+		QModelIndexList oldIndices = persistentIndexList(), newIndices;
+		for (int n=0; n<oldIndices.count(); ++n) newIndices << index(newRows.at(oldIndices.at(n).row()), oldIndices.at(n).column());
+		changePersistentIndexList(oldIndices, newIndices);
+	}
+
+	emit layoutChanged();
+}
+
+// Return property by which runs are sorted
+RunProperty::Property RunTableModel::sortProperty() const
+{
+	return sortProperty_;
+}
+
+// Return order in which runs are sorted
+Qt::SortOrder RunTableModel::sortOrder() const
+{
+	return sortOrder_;
+}
+
+/*
+ * Highlighting
+ */
+
+// Set highlighting of alternate rows, or alternate groups, in specified colour
+void RunTableModel::setHighlighting(bool groups, QColor colour)
+{
+	if ((groups == highlightGroups_) && (colour == highlightBrush_.color())) return;
+
+	highlightGroups_ = groups;
+	highlightBrush_ = QBrush(colour);
+	if (!runs_.isEmpty()) emit dataChanged(index(0, 0), index(runs_.count()-1, columns_.count()-1), QVector<int>() << Qt::BackgroundRole);
+}
+
+/*
+// Virtuals
+*/
+
+// Return number of rows
+int RunTableModel::rowCount(const QModelIndex& parent) const
+{
+	return (parent.isValid() ? 0 : runs_.count());
+}
+
+// Return number of columns
+int RunTableModel::columnCount(const QModelIndex& parent) const
+{
+	return (parent.isValid() ? 0 : columns_.count());
+}
+
+// Return data for specified index and role
+QVariant RunTableModel::data(const QModelIndex& index, int role) const
+{
+	if ((!index.isValid()) || (index.row() >= runs_.count()) || (index.column() >= columns_.count())) return QVariant();
+
+	RunData* rd = runs_.at(index.row());
+	RunProperty::Property property = columns_.at(index.column());
+	switch (role)
+	{
+		case (Qt::DisplayRole):
+			return rd->propertyAsString(property);
+		case (Qt::BackgroundRole):
+			if (highlightGroups_) return (rd->group()%2 == 0 ? highlightBrush_ : normalBrush_);
+			return (index.row()%2 == 1 ? highlightBrush_ : normalBrush_);
+		case (RunTableModel::SortRole):
+			if (numericSort(property)) return numericKey(rd, property);
+			return rd->propertyAsString(property);
+		default:
+			break;
+	}
+	return QVariant();
+}
+
+// Return header data for specified section and role
+QVariant RunTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+	if (role != Qt::DisplayRole) return QVariant();
+	if (orientation == Qt::Vertical) return section+1;
+	if ((section < 0) || (section >= columns_.count())) return QVariant();
+	return RunProperty::property(columns_.at(section));
+}
+
+// Sort runs by specified column
+void RunTableModel::sort(int column, Qt::SortOrder order)
+{
+	if ((column < 0) || (column >= columns_.count())) return;
+
+	// Runs are always kept sorted, so there's nothing to do unless the sort has changed
+	if ((columns_.at(column) == sortProperty_) && (order == sortOrder_)) return;
+
+	sortProperty_ = columns_.at(column);
+	sortOrder_ = order;
+	resort();
+}
@@ -0,0 +1,140 @@
+/*
+	*** Run Table Model
+	*** src/runtablemodel.h
+	Copyright T. Youngs 2012-2016
+
+	This file is part of JournalViewer.
+
+	JournalViewer is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	JournalViewer is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with JournalViewer.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef JOURNALVIEWER_RUNTABLEMODEL_H
+#define JOURNALVIEWER_RUNTABLEMODEL_H
+
+#include "rundata.h"
+#include "list.h"
+#include <QAbstractTableModel>
+#include <QVector>
+#include <QBrush>
+
+/*
+ * Table model over the visible runs, with one column per visible RunProperty plus a final Group column.
+ * Nothing is stored per cell - text, sort keys and highlighting are all served on demand from the runs (whose formatted property
+ * values are cached in their catalogues), so changing the visible runs only replaces the model's list of runs.
+ */
+class RunTableModel : public QAbstractTableModel
+{
+	// All Qt declarations must include this macro
+	Q_OBJECT
+
+	public:
+	// Constructor
+	RunTableModel(QObject* parent = NULL);
+	// Custom data roles
+	enum DataRole { SortRole = Qt::UserRole };
+
+
+	/*
+	 * Columns
+	 */
+	private:
+	// Property displayed in each column
+	QVector<RunProperty::Property> columns_;
+
+	public:
+	// Set columns from list of visible properties (followed by the Group column), returning whether they changed
+	bool setColumns(const List<RunProperty>& properties);
+	// Return column displaying specified property (or -1 if it is not displayed)
+	int column(RunProperty::Property property) const;
+	// Return property displayed in specified column
+	RunProperty::Property columnProperty(int column) const;
+
+
+	/*
+	 * Rows
+	 */
+	private:
+	// Runs displayed, in row order
+	QVector<RunData*> runs_;
+
+	public:
+	// Set runs to display (in any order - they are sorted by the current sort property)
+	void setRuns(const QVector<RunData*>& runs);
+	// Return runs displayed, in row order
+	const QVector<RunData*>& runs() const;
+	// Return run displayed in specified row
+	RunData* runData(int row) const;
+	// Return row displaying specified run (or -1 if it is not displayed) - a linear search, so not for use in loops
+	int row(RunData* rd) const;
+	// Notify that the group numbers of the runs have changed
+	void groupsChanged();
+
+
+	/*
+	 * Sorting
+	 */
+	private:
+	// Property by which runs are sorted
+	RunProperty::Property sortProperty_;
+	// Order in which runs are sorted
+	Qt::SortOrder sortOrder_;
+
+	private:
+	// Return whether specified property is sorted by its numerical value (rather than its text)
+	static bool numericSort(RunProperty::Property property);
+	// Return numerical sort key of specified property of run
+	static double numericKey(RunData* rd, RunProperty::Property property);
+	// Sort runs, returning the previous row of each run (or nothing if the order couldn't have changed)
+	QVector<int> sortRuns();
+	// Re-sort runs, moving any persistent indices (e.g. the selection) with them
+	void resort();
+
+	public:
+	// Return property by which runs are sorted
+	RunProperty::Property sortProperty() const;
+	// Return order in which runs are sorted
+	Qt::SortOrder sortOrder() const;
+
+
+	/*
+	 * Highlighting
+	 */
+	private:
+	// Whether alternate groups (rather than alternate rows) are highlighted
+	bool highlightGroups_;
+	// Background brushes for normal and highlighted rows
+	QBrush normalBrush_, highlightBrush_;
+
+	public:
+	// Set highlighting of alternate rows, or alternate groups, in specified colour
+	void setHighlighting(bool groups, QColor colour);
+
+
+	/*
+	// Virtuals
+	*/
+	public:
+	// Return number of rows
+	int rowCount(const QModelIndex& parent = QModelIndex()) const;
+	// Return number of columns
+	int columnCount(const QModelIndex& parent = QModelIndex()) const;
+	// Return data for specified index and role
+	QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const;
+	// Return header data for specified section and role
+	QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const;
+	// Sort runs by specified column
+	void sort(int column, Qt::SortOrder order = Qt::AscendingOrder);
+};
+
+#endif
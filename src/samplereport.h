@@ -27,6 +27,7 @@
 
 // Forward Declarations
 class RunData;
+class RunGrouping;
 
 // SampleReportGroup, storing information about a group of like run data
 class SampleReportGroup
@@ -49,8 +50,8 @@ class SampleReportGroup
 	double runTimeSum_;
 
 	public:
-	// Add supplied RunData, if it is similar
-	bool addIfSimilar(RunData* datum);
+	// Add supplied RunData
+	void add(RunData* datum);
 	// Add supplied RunData, setting title of group etc.
 	void addFirst(RunData* datum, bool useMeV);
 	// Return title of run numbers
@@ -82,8 +83,8 @@ class SampleReport: public QDialog
 	bool refreshing_;
 
 	public:
-	// Add RunData to GraphWidget
-	void addRunData(RefList<RunData,int>& data, bool useMeV);
+	// Add RunData to GraphWidget, grouped as in the supplied grouping
+	void addRunData(RefList<RunData,int>& data, const RunGrouping& grouping, bool useMeV);
 	// Finalise and show GraphWidget
 	void finaliseAndShow();
 
@@ -21,6 +21,8 @@
 
 #include "samplereport.h"
 #include "rundata.h"
+#include "rungrouping.h"
+#include <QHash>
 
 /*
  * SampleReportGroup
@@ -43,13 +45,11 @@ SampleReportGroup::~SampleReportGroup()
 {
 }
 
-// Add supplied RunData, if it is similar
-bool SampleReportGroup::addIfSimilar(RunData* datum)
+// Add supplied RunData
+void SampleReportGroup::add(RunData* datum)
 {
-	if (title_ != datum->title()) return false;
 	runData_.add(datum);
 	runTimeSum_ += (useMeV_ ? datum->totalMEvents() : datum->protonCharge());
-	return true;
 }
 
 // Add supplied RunData, setting title of group etc.
@@ -62,7 +62,7 @@ void SampleReportGroup::addFirst(RunData* datum, bool useMeV)
 	}
 	title_ = datum->title();
 	useMeV_ = useMeV;
-	addIfSimilar(datum);
+	add(datum);
 }
 
 // Return title of run numbers
@@ -100,7 +100,7 @@ SampleReport::~SampleReport()
 }
 
 // Add RunData to Tree
-void SampleReport::addRunData(RefList<RunData,int>& data, bool useMeV)
+void SampleReport::addRunData(RefList<RunData,int>& data, const RunGrouping& grouping, bool useMeV)
 {
 	// Setup TreeView
 	ui.SampleReportTree->clear();
@@ -108,20 +108,25 @@ void SampleReport::addRunData(RefList<RunData,int>& data, bool useMeV)
 	if (useMeV) ui.SampleReportTree->setHeaderLabels( QStringList() << "Title / Run Number" << "Total MeV" );
 	else ui.SampleReportTree->setHeaderLabels( QStringList() << "Title / Run Number" << "Total uAh" );
 	
-	// First, need to group runs with same title together
+	// First, need to group runs with same title together - the supplied grouping gives us the group of each run
 	List<SampleReportGroup> groupedData;
+	QHash<int,SampleReportGroup*> groupMap;
 	SampleReportGroup* group;
 	RefListItem<RunData,int>* ri;
+	int index;
 
 	// Loop over supplied RunData, creating groups as we go
 	for (ri = data.first(); ri != NULL; ri = ri->next)
 	{
-		// Loop over existing groups, seeing if it matches
-		for (group = groupedData.first(); group != NULL; group = group->next) if (group->addIfSimilar(ri->item)) break;
-		if (group == NULL)
+		// Runs not in the grouping get a group of their own
+		index = grouping.groupOf(ri->item);
+		group = (index == -1 ? NULL : groupMap.value(index, NULL));
+		if (group) group->add(ri->item);
+		else
 		{
 			group = groupedData.add();
 			group->addFirst(ri->item, useMeV);
+			if (index != -1) groupMap.insert(index, group);
 		}
 	}
 
@@ -0,0 +1,91 @@
+/*
+	*** Background Search Task
+	*** src/searchtask.cpp
+	Copyright T. Youngs 2012-2016
+
+	This file is part of JournalViewer.
+
+	JournalViewer is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	JournalViewer is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with JournalViewer.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "searchtask.h"
+#include "stringmatcher.h"
+
+/*
+ * Search Handle
+ */
+
+// Constructor
+SearchHandle::SearchHandle()
+{
+	id_ = 0;
+}
+
+// Return id of search (0 if there is none)
+int SearchHandle::id() const
+{
+	return id_;
+}
+
+// Return whether there is a search
+bool SearchHandle::isNull() const
+{
+	return (id_ == 0);
+}
+
+// Cancel the search, leaving any remaining strings untested, and release the handle
+void SearchHandle::cancel()
+{
+	if (cancelled_) cancelled_->store(1);
+	cancelled_.clear();
+	id_ = 0;
+}
+
+/*
+ * Search Task
+ */
+
+// Constructor
+SearchTask::SearchTask(const QRegExp& expr, const QVector<int>& ids, const QVector<int>& matches, QObject* receiver, const char* finishedSlot) : QRunnable(), expr_(expr), ids_(ids), matches_(matches)
+{
+	// Searches are numbered in the order they are created
+	static QAtomicInt lastId;
+	handle_.id_ = lastId.fetchAndAddRelaxed(1) + 1;
+	handle_.cancelled_ = QSharedPointer<QAtomicInt>(new QAtomicInt(0));
+
+	receiver_ = receiver;
+	finishedSlot_ = finishedSlot;
+
+	// The thread pool deletes the task once it has run, so nothing must refer to it after it has been started
+	setAutoDelete(true);
+}
+
+// Return handle to the search
+SearchHandle SearchTask::handle() const
+{
+	return handle_;
+}
+
+/*
+ * Execution
+ */
+
+// Test strings, and pass the results to the receiver
+void SearchTask::run()
+{
+	StringMatcher::match(expr_, ids_.constData(), ids_.count(), matches_, handle_.cancelled_.data());
+
+	// Results are copied into the queued call, so the receiver never touches the task itself
+	QMetaObject::invokeMethod(receiver_, finishedSlot_, Qt::QueuedConnection, Q_ARG(int, handle_.id_), Q_ARG(QRegExp, expr_), Q_ARG(QVector<int>, matches_));
+}
@@ -0,0 +1,104 @@
+/*
+	*** Background Search Task
+	*** src/searchtask.h
+	Copyright T. Youngs 2012-2016
+
+	This file is part of JournalViewer.
+
+	JournalViewer is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	JournalViewer is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with JournalViewer.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef JOURNALVIEWER_SEARCHTASK_H
+#define JOURNALVIEWER_SEARCHTASK_H
+
+#include <QObject>
+#include <QRunnable>
+#include <QRegExp>
+#include <QVector>
+#include <QAtomicInt>
+#include <QSharedPointer>
+
+/*
+ * Handle to a background search, used to recognise its results and to cancel it.
+ * It remains valid after the task itself has been deleted.
+ */
+class SearchHandle
+{
+	public:
+	// Constructor
+	SearchHandle();
+
+	private:
+	// Id of search (0 if there is none)
+	int id_;
+	// Cancellation flag, shared with the task
+	QSharedPointer<QAtomicInt> cancelled_;
+	// Tasks create their own handles
+	friend class SearchTask;
+
+	public:
+	// Return id of search (0 if there is none)
+	int id() const;
+	// Return whether there is a search
+	bool isNull() const;
+	// Cancel the search, leaving any remaining strings untested, and release the handle
+	void cancel();
+};
+
+/*
+ * Background test of pool strings (run titles) against a search expression, resolving a match cache indexed by string id.
+ * Results only depend on the strings themselves, so they remain valid however the displayed runs change while the task is running.
+ * The task is deleted by its thread pool once it has run - its results are passed by value to a slot of the (long-lived) receiver,
+ * which must take the search id, expression and match cache (int, QRegExp, QVector<int>).
+ */
+class SearchTask : public QRunnable
+{
+	public:
+	// Constructor
+	SearchTask(const QRegExp& expr, const QVector<int>& ids, const QVector<int>& matches, QObject* receiver, const char* finishedSlot);
+
+
+	/*
+	 * Search
+	 */
+	private:
+	// Handle to the search
+	SearchHandle handle_;
+	// Expression to match
+	QRegExp expr_;
+	// Ids of strings to test
+	QVector<int> ids_;
+	// Match cache (-1 = not yet tested, 0 = no match, 1 = match), by string id
+	QVector<int> matches_;
+
+	public:
+	// Return handle to the search
+	SearchHandle handle() const;
+
+
+	/*
+	 * Execution
+	 */
+	private:
+	// Object to receive results
+	QObject* receiver_;
+	// Name of receiver's slot to call with the results
+	const char* finishedSlot_;
+
+	public:
+	// Test strings, and pass the results to the receiver
+	void run();
+};
+
+#endif
@@ -202,6 +202,7 @@ void Settings::getSettings()
 	else if (parent_->blockDataSource() == RunData::NexusBeforeLogSource) ui.BlockNexusBeforeLogRadio->setChecked(true);
 	else if (parent_->blockDataSource() == RunData::LogOnlySource) ui.BlockLogOnlyRadio->setChecked(true);
 	else if (parent_->blockDataSource() == RunData::NexusOnlySource) ui.BlockNexusOnlyRadio->setChecked(true);
+	ui.BlockDataMemoryBudgetSpin->setValue(parent_->blockDataMemoryBudget());
 
 	// -- Export
 	QPalette headerPalette(QApplication::palette());
@@ -254,6 +255,7 @@ void Settings::setSettings()
 	else if (ui.BlockNexusBeforeLogRadio->isChecked()) parent_->setBlockDataSource(RunData::NexusBeforeLogSource);
 	else if (ui.BlockLogOnlyRadio->isChecked()) parent_->setBlockDataSource(RunData::LogOnlySource);
 	else if (ui.BlockNexusOnlyRadio->isChecked()) parent_->setBlockDataSource(RunData::NexusOnlySource);
+	parent_->setBlockDataMemoryBudget(ui.BlockDataMemoryBudgetSpin->value());
 
 	// -- Style
 	parent_->setHeaderTextColour(ui.StyleHeaderTextLabel->palette().color(QPalette::Text));
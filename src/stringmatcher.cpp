@@ -0,0 +1,107 @@
+/*
+	*** String Matcher
+	*** src/stringmatcher.cpp
+	Copyright T. Youngs 2012-2016
+
+	This file is part of JournalViewer.
+
+	JournalViewer is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	JournalViewer is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with JournalViewer.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "stringmatcher.h"
+#include "runcatalogue.h"
+
+// Constructor
+StringMatcher::Chunk::Chunk(const QRegExp& expr, const QString* strings, int nStrings, int* matches, QSemaphore* done, const QAtomicInt* cancelled) : QRunnable(), expr_(expr)
+{
+	strings_ = strings;
+	nStrings_ = nStrings;
+	matches_ = matches;
+	done_ = done;
+	cancelled_ = cancelled;
+}
+
+// Test strings
+void StringMatcher::Chunk::run()
+{
+	for (int n=0; n<nStrings_; ++n)
+	{
+		// Check for cancellation every so often, leaving remaining strings untested
+		if (((n%256) == 0) && (cancelled_ != NULL) && cancelled_->load()) break;
+		matches_[n] = (expr_.indexIn(strings_[n]) != -1);
+	}
+
+	done_->release();
+}
+
+// Return thread pool used for matching
+QThreadPool& StringMatcher::threadPool()
+{
+	static QThreadPool pool;
+	return pool;
+}
+
+// Set maximum number of pool threads used for matching (1 tests all strings on the calling thread)
+void StringMatcher::setMaxThreadCount(int nThreads)
+{
+	threadPool().setMaxThreadCount(nThreads < 1 ? 1 : nThreads);
+}
+
+// Return maximum number of pool threads used for matching
+int StringMatcher::maxThreadCount()
+{
+	return threadPool().maxThreadCount();
+}
+
+// Ensure matches are known for the strings with specified ids, testing any which aren't yet in parallel (unless cancelled)
+void StringMatcher::match(const QRegExp& expr, const int* ids, int nIds, QVector<int>& matches, const QAtomicInt* cancelled)
+{
+	// Gather the distinct ids which haven't been tested yet
+	QVector<int> pending;
+	int id;
+	for (int n=0; n<nIds; ++n)
+	{
+		id = ids[n];
+		if (id < 0) continue;
+		while (id >= matches.size()) matches.append(-1);
+		if (matches.at(id) != -1) continue;
+		matches[id] = -2;
+		pending.append(id);
+	}
+	if (pending.isEmpty()) return;
+
+	// Retrieve strings and test them, splitting them into a few chunks per thread (but not so many that the overhead dominates)
+	QVector<QString> strings = RunCatalogue::stringPool().strings(pending);
+	QVector<int> results(pending.size(), -1);
+	int nThreads = threadPool().maxThreadCount();
+	int chunkSize = (pending.size() + 4*nThreads - 1) / (4*nThreads);
+	if (chunkSize < minimumChunkSize) chunkSize = minimumChunkSize;
+	QSemaphore done;
+	int nChunks = 1;
+	if ((nThreads == 1) || (pending.size() <= chunkSize)) Chunk(expr, strings.constData(), strings.size(), results.data(), &done, cancelled).run();
+	else
+	{
+		// Test the first chunk here while the rest are tested by the pool
+		for (int start = chunkSize; start < pending.size(); start += chunkSize)
+		{
+			threadPool().start(new Chunk(expr, strings.constData()+start, qMin(chunkSize, pending.size()-start), results.data()+start, &done, cancelled));
+			++nChunks;
+		}
+		Chunk(expr, strings.constData(), chunkSize, results.data(), &done, cancelled).run();
+	}
+	done.acquire(nChunks);
+
+	// Store results (strings left untested through cancellation remain -1)
+	for (int n=0; n<pending.size(); ++n) matches[pending.at(n)] = results.at(n);
+}
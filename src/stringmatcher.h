@@ -0,0 +1,82 @@
+/*
+	*** String Matcher
+	*** src/stringmatcher.h
+	Copyright T. Youngs 2012-2016
+
+	This file is part of JournalViewer.
+
+	JournalViewer is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	JournalViewer is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with JournalViewer.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef JOURNALVIEWER_STRINGMATCHER_H
+#define JOURNALVIEWER_STRINGMATCHER_H
+
+#include <QString>
+#include <QRegExp>
+#include <QVector>
+#include <QRunnable>
+#include <QThreadPool>
+#include <QSemaphore>
+#include <QAtomicInt>
+
+/*
+ * Tests strings of the shared string pool against an expression, in chunks spread over all available cores.
+ * Results are cached by string id (-1 = not yet tested, 0 = no match, 1 = match), so the outcome doesn't depend on the number of threads.
+ * Matching may be started from any thread, and may be cancelled from another.
+ */
+class StringMatcher
+{
+	private:
+	// Chunk of strings to test
+	class Chunk : public QRunnable
+	{
+		public:
+		// Constructor
+		Chunk(const QRegExp& expr, const QString* strings, int nStrings, int* matches, QSemaphore* done, const QAtomicInt* cancelled);
+
+		private:
+		// Expression to match (each chunk has its own copy, as QRegExp is not thread-safe)
+		QRegExp expr_;
+		// Strings to test
+		const QString* strings_;
+		// Number of strings to test
+		int nStrings_;
+		// Results for each string
+		int* matches_;
+		// Semaphore to release when finished
+		QSemaphore* done_;
+		// Flag indicating that matching has been cancelled (if any)
+		const QAtomicInt* cancelled_;
+
+		public:
+		// Test strings
+		void run();
+	};
+
+	private:
+	// Return thread pool used for matching
+	static QThreadPool& threadPool();
+
+	public:
+	// Minimum number of strings in each chunk
+	static const int minimumChunkSize = 4096;
+	// Set maximum number of pool threads used for matching (1 tests all strings on the calling thread)
+	static void setMaxThreadCount(int nThreads);
+	// Return maximum number of pool threads used for matching
+	static int maxThreadCount();
+	// Ensure matches are known for the strings with specified ids, testing any which aren't yet in parallel (unless cancelled)
+	static void match(const QRegExp& expr, const int* ids, int nIds, QVector<int>& matches, const QAtomicInt* cancelled = NULL);
+};
+
+#endif
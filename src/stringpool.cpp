@@ -0,0 +1,97 @@
+/*
+	*** String Pool
+	*** src/stringpool.cpp
+	Copyright T. Youngs 2012-2016
+
+	This file is part of JournalViewer.
+
+	JournalViewer is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	JournalViewer is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with JournalViewer.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "stringpool.h"
+#include <QReadLocker>
+#include <QWriteLocker>
+
+// Constructor, adding any supplied strings to the pool in order (so their ids are known)
+StringPool::StringPool(const QStringList& initialStrings)
+{
+	for (int n=0; n<initialStrings.count(); ++n) id(initialStrings.at(n));
+}
+
+/*
+ * Strings
+ */
+
+// Return id of specified string, adding it to the pool if necessary
+int StringPool::id(const QString& s)
+{
+	// Most strings will already be in the pool, so check for them with only a read lock first
+	{
+		QReadLocker locker(&lock_);
+		QHash<QString,int>::const_iterator it = ids_.constFind(s);
+		if (it != ids_.constEnd()) return it.value();
+	}
+
+	// Not there, so add it (unless another thread beat us to it)
+	QWriteLocker locker(&lock_);
+	QHash<QString,int>::const_iterator it = ids_.constFind(s);
+	if (it != ids_.constEnd()) return it.value();
+	strings_.append(s);
+	ids_.insert(s, strings_.size()-1);
+	return strings_.size()-1;
+}
+
+// Return id of specified string, or -1 if it is not in the pool
+int StringPool::find(const QString& s) const
+{
+	QReadLocker locker(&lock_);
+	return ids_.value(s, -1);
+}
+
+// Return string with specified id (or an empty string if the id is invalid)
+QString StringPool::string(int id) const
+{
+	QReadLocker locker(&lock_);
+	if ((id < 0) || (id >= strings_.size())) return QString();
+	return strings_.at(id);
+}
+
+// Return strings with specified ids, taking the lock only once
+QVector<QString> StringPool::strings(const QVector<int>& ids) const
+{
+	QVector<QString> result(ids.size());
+	QReadLocker locker(&lock_);
+	for (int n=0; n<ids.size(); ++n) if ((ids.at(n) >= 0) && (ids.at(n) < strings_.size())) result[n] = strings_.at(ids.at(n));
+	return result;
+}
+
+// Return number of strings in the pool
+int StringPool::nStrings() const
+{
+	QReadLocker locker(&lock_);
+	return strings_.size();
+}
+
+// Return estimated memory used by the pool (bytes)
+qint64 StringPool::memoryUsage() const
+{
+	QReadLocker locker(&lock_);
+
+	// Character data is shared between the string table and the hash
+	qint64 bytes = sizeof(StringPool) + strings_.capacity() * sizeof(QString);
+	for (int n=0; n<strings_.size(); ++n) bytes += sizeof(QArrayData) + (strings_.at(n).capacity()+1) * sizeof(QChar);
+	bytes += ids_.capacity() * sizeof(void*) + ids_.size() * (sizeof(QString) + sizeof(int) + sizeof(void*) + sizeof(uint));
+
+	return bytes;
+}
@@ -0,0 +1,68 @@
+/*
+	*** String Pool
+	*** src/stringpool.h
+	Copyright T. Youngs 2012-2016
+
+	This file is part of JournalViewer.
+
+	JournalViewer is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	JournalViewer is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with JournalViewer.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef JOURNALVIEWER_STRINGPOOL_H
+#define JOURNALVIEWER_STRINGPOOL_H
+
+#include <QString>
+#include <QVector>
+#include <QHash>
+#include <QStringList>
+#include <QReadWriteLock>
+
+/*
+ * Thread-safe pool of unique strings, each identified by a small integer id which is valid for the lifetime of the pool.
+ * Equal strings always have the same id, so ids may be compared instead of strings.
+ */
+class StringPool
+{
+	public:
+	// Constructor, adding any supplied strings to the pool in order (so their ids are known)
+	StringPool(const QStringList& initialStrings = QStringList());
+
+
+	/*
+	 * Strings
+	 */
+	private:
+	// Unique strings, indexed by id
+	QVector<QString> strings_;
+	// Ids of unique strings
+	QHash<QString,int> ids_;
+	// Lock protecting the pool (strings are added from journal loader threads)
+	mutable QReadWriteLock lock_;
+
+	public:
+	// Return id of specified string, adding it to the pool if necessary
+	int id(const QString& s);
+	// Return id of specified string, or -1 if it is not in the pool
+	int find(const QString& s) const;
+	// Return string with specified id (or an empty string if the id is invalid)
+	QString string(int id) const;
+	// Return strings with specified ids, taking the lock only once
+	QVector<QString> strings(const QVector<int>& ids) const;
+	// Return number of strings in the pool
+	int nStrings() const;
+	// Return estimated memory used by the pool (bytes)
+	qint64 memoryUsage() const;
+};
+
+#endif
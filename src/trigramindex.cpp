@@ -0,0 +1,255 @@
+/*
+	*** Trigram Index
+	*** src/trigramindex.cpp
+	Copyright T. Youngs 2012-2016
+
+	This file is part of JournalViewer.
+
+	JournalViewer is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	JournalViewer is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with JournalViewer.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "trigramindex.h"
+#include "stringpool.h"
+#include <algorithm>
+
+// Constructor
+TrigramIndex::TrigramIndex()
+{
+	nIndexed_ = 0;
+}
+
+/*
+ * Index
+ */
+
+// Return key for trigram starting at specified position in (case-folded) text
+quint64 TrigramIndex::key(const QString& text, int pos)
+{
+	return (quint64(text.at(pos).unicode()) << 32) | (quint64(text.at(pos+1).unicode()) << 16) | quint64(text.at(pos+2).unicode());
+}
+
+// Extract literal text required by any match of the supplied regular expression, returning false if this isn't possible
+bool TrigramIndex::requiredLiterals(const QRegExp& expr, QStringList& literals)
+{
+	QString pattern = expr.pattern();
+	if (pattern.isEmpty()) return false;
+
+	QRegExp::PatternSyntax syntax = expr.patternSyntax();
+	QString current;
+	if (syntax == QRegExp::FixedString) literals << pattern;
+	else if ((syntax == QRegExp::Wildcard) || (syntax == QRegExp::WildcardUnix))
+	{
+		// Literal text runs between '*', '?' and character sets
+		for (int n=0; n<pattern.length(); ++n)
+		{
+			QChar c = pattern.at(n);
+			if ((c == '*') || (c == '?'))
+			{
+				literals << current;
+				current.clear();
+			}
+			else if (c == '[')
+			{
+				literals << current;
+				current.clear();
+				n = pattern.indexOf(']', n+2);
+				if (n == -1) return false;
+			}
+			else if ((c == '\\') && (syntax == QRegExp::WildcardUnix) && (n+1 < pattern.length())) current += pattern.at(++n);
+			else current += c;
+		}
+		literals << current;
+	}
+	else if ((syntax == QRegExp::RegExp) || (syntax == QRegExp::RegExp2))
+	{
+		// Only literal text outside of groups is considered, and any alternation at the top level means nothing is required
+		int depth = 0;
+		for (int n=0; n<pattern.length(); ++n)
+		{
+			QChar c = pattern.at(n);
+			if (c == '\\')
+			{
+				if (n+1 == pattern.length()) return false;
+				c = pattern.at(++n);
+
+				// Character class escapes break the current run, while other alphanumeric escapes (e.g. \x41, \1) are too awkward to handle
+				if (c.isLetterOrNumber())
+				{
+					if (!QString("dDwWsSbBnrtfv").contains(c)) return false;
+					literals << current;
+					current.clear();
+					continue;
+				}
+			}
+			else if (c == '(')
+			{
+				++depth;
+				literals << current;
+				current.clear();
+				continue;
+			}
+			else if (c == ')')
+			{
+				--depth;
+				continue;
+			}
+			else if (c == '|')
+			{
+				if (depth == 0) return false;
+				continue;
+			}
+			else if (c == '[')
+			{
+				literals << current;
+				current.clear();
+
+				// Skip to the end of the character set (a ']' immediately after '[' or '[^' is part of the set)
+				++n;
+				if ((n < pattern.length()) && (pattern.at(n) == '^')) ++n;
+				if ((n < pattern.length()) && (pattern.at(n) == ']')) ++n;
+				while ((n < pattern.length()) && (pattern.at(n) != ']'))
+				{
+					if (pattern.at(n) == '\\') ++n;
+					++n;
+				}
+				if (n >= pattern.length()) return false;
+				continue;
+			}
+			else if ((c == '.') || (c == '^') || (c == '$'))
+			{
+				literals << current;
+				current.clear();
+				continue;
+			}
+			else if ((c == '*') || (c == '?') || (c == '+'))
+			{
+				// Quantifier following something other than a literal character
+				continue;
+			}
+			else if (c == '{')
+			{
+				n = pattern.indexOf('}', n);
+				if (n == -1) return false;
+				continue;
+			}
+
+			// Literal character - ignore it if inside a group, and check for a following quantifier
+			if (depth > 0) continue;
+			QChar next = (n+1 < pattern.length() ? pattern.at(n+1) : QChar());
+			if ((next == '*') || (next == '?') || (next == '{'))
+			{
+				// Character is optional, so the current run ends before it
+				literals << current;
+				current.clear();
+			}
+			else if (next == '+')
+			{
+				// Character is required, but may repeat, so the current run ends after it
+				current += c;
+				literals << current;
+				current.clear();
+				++n;
+			}
+			else current += c;
+		}
+		literals << current;
+	}
+	else return false;
+
+	return true;
+}
+
+// Clear index
+void TrigramIndex::clear()
+{
+	postings_.clear();
+	nIndexed_ = 0;
+}
+
+// Index any strings added to the pool since the last update
+void TrigramIndex::update(const StringPool& pool)
+{
+	int nStrings = pool.nStrings();
+	QVector<quint64> keys;
+	for (int id = nIndexed_; id < nStrings; ++id)
+	{
+		// Get unique trigrams in the string
+		QString text = pool.string(id).toCaseFolded();
+		keys.clear();
+		for (int pos = 0; pos < text.length()-2; ++pos) keys.append(key(text, pos));
+		std::sort(keys.begin(), keys.end());
+		keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+		// Ids are added in increasing order, so posting lists remain sorted
+		for (int n=0; n<keys.count(); ++n) postings_[keys.at(n)].append(id);
+	}
+	nIndexed_ = nStrings;
+}
+
+// Return number of strings indexed
+int TrigramIndex::nIndexed() const
+{
+	return nIndexed_;
+}
+
+// Find ids of indexed strings which might match the supplied expression, returning false if the index can't narrow the search
+bool TrigramIndex::candidates(const QRegExp& expr, QVector<int>& ids) const
+{
+	ids.clear();
+
+	// Get trigrams of all literal text that a match must contain
+	QStringList literals;
+	if (!requiredLiterals(expr, literals)) return false;
+	QVector<quint64> keys;
+	for (int n=0; n<literals.count(); ++n)
+	{
+		QString text = literals.at(n).toCaseFolded();
+		for (int pos = 0; pos < text.length()-2; ++pos) keys.append(key(text, pos));
+	}
+	if (keys.isEmpty()) return false;
+	std::sort(keys.begin(), keys.end());
+	keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+	// Retrieve posting lists - if any trigram has never been seen, nothing can match
+	QVector<const QVector<int>*> lists;
+	for (int n=0; n<keys.count(); ++n)
+	{
+		QHash<quint64, QVector<int> >::const_iterator it = postings_.constFind(keys.at(n));
+		if (it == postings_.constEnd()) return true;
+		lists.append(&it.value());
+	}
+
+	// Intersect lists, starting with the shortest
+	std::sort(lists.begin(), lists.end(), [](const QVector<int>* a, const QVector<int>* b) { return a->size() < b->size(); });
+	ids = *lists.at(0);
+	QVector<int> result;
+	for (int n=1; (n < lists.count()) && (!ids.isEmpty()); ++n)
+	{
+		result.resize(ids.size());
+		QVector<int>::iterator end = std::set_intersection(ids.constBegin(), ids.constEnd(), lists.at(n)->constBegin(), lists.at(n)->constEnd(), result.begin());
+		result.resize(end - result.begin());
+		ids.swap(result);
+	}
+
+	return true;
+}
+
+// Return estimated memory used by the index (bytes)
+qint64 TrigramIndex::memoryUsage() const
+{
+	qint64 bytes = sizeof(TrigramIndex);
+	bytes += postings_.capacity() * sizeof(void*) + postings_.size() * (sizeof(quint64) + sizeof(QVector<int>) + 2*sizeof(void*));
+	for (QHash<quint64, QVector<int> >::const_iterator it = postings_.constBegin(); it != postings_.constEnd(); ++it) bytes += it.value().capacity() * sizeof(int);
+	return bytes;
+}
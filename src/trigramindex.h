@@ -0,0 +1,75 @@
+/*
+	*** Trigram Index
+	*** src/trigramindex.h
+	Copyright T. Youngs 2012-2016
+
+	This file is part of JournalViewer.
+
+	JournalViewer is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	JournalViewer is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with JournalViewer.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef JOURNALVIEWER_TRIGRAMINDEX_H
+#define JOURNALVIEWER_TRIGRAMINDEX_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QHash>
+#include <QRegExp>
+
+// Forward Declarations
+class StringPool;
+
+/*
+ * Index of the (case-folded) trigrams contained in each string of a StringPool.
+ * Strings are indexed incrementally (the pool only ever grows), and searches return the ids of strings which contain all
+ * trigrams of the literal text the search requires - only those strings need to be tested against the search itself.
+ * Not thread-safe - the index should only be used from the GUI thread.
+ */
+class TrigramIndex
+{
+	public:
+	// Constructor
+	TrigramIndex();
+
+
+	/*
+	 * Index
+	 */
+	private:
+	// Sorted ids of strings containing each trigram
+	QHash<quint64, QVector<int> > postings_;
+	// Number of strings of the pool indexed so far
+	int nIndexed_;
+
+	private:
+	// Return key for trigram starting at specified position in (case-folded) text
+	static quint64 key(const QString& text, int pos);
+	// Extract literal text required by any match of the supplied regular expression, returning false if this isn't possible
+	static bool requiredLiterals(const QRegExp& expr, QStringList& literals);
+
+	public:
+	// Clear index
+	void clear();
+	// Index any strings added to the pool since the last update
+	void update(const StringPool& pool);
+	// Return number of strings indexed
+	int nIndexed() const;
+	// Find ids of indexed strings which might match the supplied expression, returning false if the index can't narrow the search
+	bool candidates(const QRegExp& expr, QVector<int>& ids) const;
+	// Return estimated memory used by the index (bytes)
+	qint64 memoryUsage() const;
+};
+
+#endif